@@ -0,0 +1,121 @@
+#ifndef ARK_IMEX_HPP_INCLUDED
+#define ARK_IMEX_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/error-estimator.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+#include "dsiterpp/dense-matrix.hpp"
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Pair of Butcher tableaux of additive Runge-Kutta method: explicit one for non-stiff part
+ * and ESDIRK for stiff part with common b, c and embedded weights d. First stage is explicit
+ */
+struct ARKIMEXTableau
+{
+    size_t stages = 0;
+    int order = 0;
+    int embedded_order = 0;
+    std::vector<double> c;
+    std::vector<std::vector<double>> a_explicit;
+    std::vector<std::vector<double>> a_implicit;
+    std::vector<double> b;
+    std::vector<double> d;
+
+    /**
+     * ARK3(2)4L[2]SA, Kennedy and Carpenter, 2003
+     */
+    static ARKIMEXTableau ark324l2sa();
+
+    /**
+     * ARK4(3)6L[2]SA, Kennedy and Carpenter, 2003
+     */
+    static ARKIMEXTableau ark436l2sa();
+};
+
+/**
+ * Implicit-explicit additive Runge-Kutta integrator for x' = f_E(t, x) + f_I(t, x).
+ *
+ * RHS should be RHSGroup, its members tagged as Treatment::implicit_part are f_I, others
+ * are f_E. Parts acting on the same variable add their rhs, see RHSGroup::set_variable().
+ * Any other RHS is treated implicitly as a whole. Newton iterations solve stage
+ * equations only for f_I with Jacobian of f_I calculated once per step, by finite differences
+ * or by user-defined function. Embedded solution gives error estimation, so object may be
+ * used as error estimator of itself
+ */
+class ARKIMEXIterator : public IIntegrator, public ErrorEstimatorBase
+{
+public:
+    using JacobianFunction = std::function<void(double time, const std::vector<double>& x, DenseMatrix& jacobian)>;
+
+    ARKIMEXIterator(const ARKIMEXTableau& tableau = ARKIMEXTableau::ark324l2sa());
+
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+
+    void calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt) override;
+
+    /**
+     * Jacobian of implicit part only
+     */
+    void set_jacobian_function(JacobianFunction jacobian);
+    void set_newton_tolerance(double tolerance);
+    void set_newton_max_iterations(size_t max_iterations);
+
+    size_t explicit_evaluations_count() const;
+    size_t implicit_evaluations_count() const;
+
+private:
+    /**
+     * Calculate stages and m_delta, values and deltas of variable are restored
+     * @return false if Newton iterations do not converge
+     */
+    bool solve_step(IVariable* variable, IRHS* rhs, double t, double dt) const;
+
+    void evaluate_part(RHSGroup::Treatment treatment, double t, const std::vector<double>& x, std::vector<double>& f) const;
+
+    void update_newton_matrix(double t, const std::vector<double>& x, const std::vector<double>& f, double m) const;
+
+    /**
+     * Solve k = f_I(t, base + m * k), k should contain initial guess
+     */
+    bool solve_stage(double t, const std::vector<double>& base, double m, std::vector<double>& k) const;
+    bool newton_iterations(double t, const std::vector<double>& base, double m, std::vector<double>& k) const;
+
+    ARKIMEXTableau m_tableau;
+    JacobianFunction m_jacobian_function;
+    double m_newton_tolerance = 1e-10;
+    size_t m_newton_max_iterations = 10;
+
+    mutable IVariable* m_variable = nullptr;
+    mutable IRHS* m_rhs = nullptr;
+    mutable RHSGroup* m_group = nullptr;
+    mutable size_t m_explicit_evaluations = 0;
+    mutable size_t m_implicit_evaluations = 0;
+
+    mutable RHSEvaluator m_evaluator;
+    mutable DenseMatrix m_jacobian;
+    mutable DenseMatrix m_newton_matrix;
+    mutable LUDecomposition m_lu;
+
+    mutable std::vector<std::vector<double>> m_f_explicit;
+    mutable std::vector<std::vector<double>> m_f_implicit;
+    mutable std::vector<double> m_x0;
+    mutable std::vector<double> m_base;
+    mutable std::vector<double> m_stage;
+    mutable std::vector<double> m_k_guess;
+    mutable std::vector<double> m_f;
+    mutable std::vector<double> m_f_stage;
+    mutable std::vector<double> m_x_perturbed;
+    mutable std::vector<double> m_delta;
+    mutable std::vector<double> m_embedded_delta;
+};
+
+}
+
+#endif // ARK_IMEX_HPP_INCLUDED
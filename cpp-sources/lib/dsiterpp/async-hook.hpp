@@ -0,0 +1,85 @@
+#ifndef ASYNC_HOOK_HPP_INCLUDED
+#define ASYNC_HOOK_HPP_INCLUDED
+
+#include "dsiterpp/time-iter.hpp"
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Periodic hook that runs heavy work in background thread.
+ *
+ * On hook time values of variable are copied to one of preallocated buffers and queued with
+ * real and wanted time, so integration continues while worker calls hook function.
+ * Snapshots of one hook are processed in order by its single worker.
+ * If queue is full, new snapshot is dropped or TimeIterator waits for free buffer
+ */
+class AsyncTimeHook : public TimeHookPeriodic
+{
+public:
+    using HookFunc = std::function<void(double real_time, double wanted_time, const std::vector<double>& state)>;
+
+    enum class OverflowPolicy
+    {
+        block = 0,
+        drop
+    };
+
+    AsyncTimeHook(IVariable* variable, HookFunc hook_func, size_t queue_depth = 4, OverflowPolicy policy = OverflowPolicy::block);
+    ~AsyncTimeHook();
+
+    AsyncTimeHook(const AsyncTimeHook&) = delete;
+    AsyncTimeHook& operator=(const AsyncTimeHook&) = delete;
+
+    void hook(double real_time, double wanted_time) override;
+
+    /**
+     * Wait until all queued snapshots are processed. Exception from hook function
+     * is rethrown here or on next hook call
+     */
+    void wait();
+
+    size_t dropped_count();
+    size_t processed_count();
+
+private:
+    struct Snapshot
+    {
+        double real_time = 0.0;
+        double wanted_time = 0.0;
+        std::vector<double> state;
+    };
+
+    void worker();
+    void rethrow_if_failed();
+
+    IVariable* m_variable;
+    HookFunc m_hook_func;
+    OverflowPolicy m_policy;
+
+    // Ring of snapshots, slot m_first is being processed by worker while m_count > 0
+    std::vector<Snapshot> m_slots;
+    size_t m_first = 0;
+    size_t m_count = 0;
+
+    size_t m_dropped = 0;
+    size_t m_processed = 0;
+    bool m_stop = false;
+    std::exception_ptr m_exception;
+
+    std::mutex m_mutex;
+    std::condition_variable m_snapshot_ready;
+    std::condition_variable m_slot_free;
+    std::thread m_worker;
+};
+
+}
+
+#endif // ASYNC_HOOK_HPP_INCLUDED
@@ -0,0 +1,280 @@
+#ifndef AUTODIFF_HPP_INCLUDED
+#define AUTODIFF_HPP_INCLUDED
+
+#include "dsiterpp/dense-matrix.hpp"
+#include "dsiterpp/utils.hpp"
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Dual number for forward mode automatic differentiation: value and derivatives along
+ * N directions at once. Loops over directions have constant trip count, so they are
+ * vectorized and N directions cost much less than N separate passes.
+ *
+ * Math functions are found by argument dependent lookup, so RHS code should call them
+ * unqualified (sin(x), not std::sin(x)) to work both with double and Dual
+ */
+template<size_t N>
+struct Dual
+{
+    double value = 0.0;
+    std::array<double, N> derivatives;
+
+    Dual() { derivatives.fill(0.0); }
+    Dual(double v) : value(v) { derivatives.fill(0.0); }
+
+    /**
+     * Independent variable: derivative along direction is 1
+     */
+    static Dual variable(double v, size_t direction)
+    {
+        Dual result(v);
+        result.derivatives[direction] = 1.0;
+        return result;
+    }
+
+    Dual& operator+=(const Dual& b)
+    {
+        value += b.value;
+        for (size_t k = 0; k < N; k++)
+            derivatives[k] += b.derivatives[k];
+        return *this;
+    }
+
+    Dual& operator-=(const Dual& b)
+    {
+        value -= b.value;
+        for (size_t k = 0; k < N; k++)
+            derivatives[k] -= b.derivatives[k];
+        return *this;
+    }
+
+    Dual& operator*=(const Dual& b)
+    {
+        for (size_t k = 0; k < N; k++)
+            derivatives[k] = derivatives[k] * b.value + value * b.derivatives[k];
+        value *= b.value;
+        return *this;
+    }
+
+    Dual& operator/=(const Dual& b)
+    {
+        const double inverse = 1.0 / b.value;
+        value *= inverse;
+        for (size_t k = 0; k < N; k++)
+            derivatives[k] = (derivatives[k] - value * b.derivatives[k]) * inverse;
+        return *this;
+    }
+
+    Dual operator-() const { return chain(*this, -value, -1.0); }
+    Dual operator+() const { return *this; }
+
+    friend Dual operator+(Dual a, const Dual& b) { return a += b; }
+    friend Dual operator-(Dual a, const Dual& b) { return a -= b; }
+    friend Dual operator*(Dual a, const Dual& b) { return a *= b; }
+    friend Dual operator/(Dual a, const Dual& b) { return a /= b; }
+
+    friend bool operator==(const Dual& a, const Dual& b) { return a.value == b.value; }
+    friend bool operator!=(const Dual& a, const Dual& b) { return a.value != b.value; }
+    friend bool operator<(const Dual& a, const Dual& b) { return a.value < b.value; }
+    friend bool operator>(const Dual& a, const Dual& b) { return a.value > b.value; }
+    friend bool operator<=(const Dual& a, const Dual& b) { return a.value <= b.value; }
+    friend bool operator>=(const Dual& a, const Dual& b) { return a.value >= b.value; }
+
+    /**
+     * f(a) with value and derivative f' at a.value
+     */
+    static Dual chain(const Dual& a, double f, double df)
+    {
+        Dual result(f);
+        for (size_t k = 0; k < N; k++)
+            result.derivatives[k] = df * a.derivatives[k];
+        return result;
+    }
+
+    friend Dual sin(const Dual& a) { return chain(a, std::sin(a.value), std::cos(a.value)); }
+    friend Dual cos(const Dual& a) { return chain(a, std::cos(a.value), -std::sin(a.value)); }
+    friend Dual tan(const Dual& a) { double t = std::tan(a.value); return chain(a, t, 1.0 + t * t); }
+    friend Dual exp(const Dual& a) { double e = std::exp(a.value); return chain(a, e, e); }
+    friend Dual log(const Dual& a) { return chain(a, std::log(a.value), 1.0 / a.value); }
+    friend Dual sqrt(const Dual& a) { double s = std::sqrt(a.value); return chain(a, s, 0.5 / s); }
+    friend Dual tanh(const Dual& a) { double t = std::tanh(a.value); return chain(a, t, 1.0 - t * t); }
+    friend Dual atan(const Dual& a) { return chain(a, std::atan(a.value), 1.0 / (1.0 + a.value * a.value)); }
+    friend Dual fabs(const Dual& a) { return chain(a, std::fabs(a.value), a.value < 0.0 ? -1.0 : 1.0); }
+
+    friend Dual pow(const Dual& a, double p)
+    {
+        double power = std::pow(a.value, p - 1.0);
+        return chain(a, power * a.value, p * power);
+    }
+
+    friend Dual pow(const Dual& a, const Dual& b)
+    {
+        // a^b = exp(b * log(a))
+        return exp(b * log(a));
+    }
+};
+
+/**
+ * Jacobian of RHS by forward mode AD. RHS is a functor with templated call operator
+ *     template<typename T> void operator()(double t, const std::vector<T>& x, std::vector<T>& dxdt)
+ * that is evaluated with Dual<N>, so every pass gives N exact Jacobian columns.
+ * Full Jacobian takes ceil(n / N) passes instead of n finite difference evaluations.
+ *
+ * Signature of operator() fits SDIRK2Iterator and ARKIMEXIterator JacobianFunction:
+ *     sdirk.set_jacobian_function(make_dual_jacobian<4>(rhs));
+ */
+template<typename RHS, size_t N = 4>
+class DualJacobian
+{
+public:
+    using DualType = Dual<N>;
+
+    DualJacobian(RHS rhs = RHS()) : m_rhs(std::move(rhs)) {}
+
+    void operator()(double t, const std::vector<double>& x, DenseMatrix& jacobian)
+    {
+        const size_t n = x.size();
+        jacobian.resize(n);
+        for (size_t begin = 0; begin < n; begin += N)
+        {
+            const size_t count = std::min(N, n - begin);
+            seed(x);
+            for (size_t k = 0; k < count; k++)
+                m_x[begin + k].derivatives[k] = 1.0;
+
+            evaluate(t);
+            for (size_t i = 0; i < n; i++)
+            {
+                for (size_t k = 0; k < count; k++)
+                    jacobian(i, begin + k) = m_f[i].derivatives[k];
+            }
+        }
+    }
+
+    /**
+     * Jacobian-vector products J v_j for all directions, N directions per pass.
+     * Also gives f(t, x) if f is not nullptr
+     */
+    void jacobian_vector_products(
+        double t, const std::vector<double>& x, const std::vector<std::vector<double>>& directions,
+        std::vector<std::vector<double>>& products, std::vector<double>* f = nullptr
+    )
+    {
+        const size_t n = x.size();
+        products.resize(directions.size());
+        const size_t passes = directions.empty() ? 1 : (directions.size() + N - 1) / N;
+        for (size_t pass = 0; pass < passes; pass++)
+        {
+            const size_t begin = pass * N;
+            const size_t count = directions.empty() ? 0 : std::min(N, directions.size() - begin);
+            seed(x);
+            for (size_t k = 0; k < count; k++)
+            {
+                const std::vector<double>& v = directions[begin + k];
+                for (size_t i = 0; i < n; i++)
+                    m_x[i].derivatives[k] = v[i];
+            }
+
+            evaluate(t);
+            for (size_t k = 0; k < count; k++)
+            {
+                std::vector<double>& product = products[begin + k];
+                product.resize(n);
+                for (size_t i = 0; i < n; i++)
+                    product[i] = m_f[i].derivatives[k];
+            }
+        }
+
+        if (f != nullptr)
+        {
+            f->resize(n);
+            for (size_t i = 0; i < n; i++)
+                (*f)[i] = m_f[i].value;
+        }
+    }
+
+    size_t passes_count() const { return m_passes; }
+    RHS& rhs() { return m_rhs; }
+
+private:
+    void seed(const std::vector<double>& x)
+    {
+        m_x.resize(x.size());
+        for (size_t i = 0; i < x.size(); i++)
+            m_x[i] = DualType(x[i]);
+    }
+
+    void evaluate(double t)
+    {
+        m_f.resize(m_x.size());
+        m_rhs(t, static_cast<const std::vector<DualType>&>(m_x), m_f);
+        m_passes++;
+    }
+
+    RHS m_rhs;
+    std::vector<DualType> m_x;
+    std::vector<DualType> m_f;
+    size_t m_passes = 0;
+};
+
+template<size_t N, typename RHS>
+DualJacobian<RHS, N> make_dual_jacobian(RHS rhs)
+{
+    return DualJacobian<RHS, N>(std::move(rhs));
+}
+
+/**
+ * Exact J_x * s + df/dp_j for SensitivityRHS by one pass of parametric RHS with Dual<1>
+ * seeded by s and by unit vector of parameter j. Replaces FiniteDifferenceSensitivity when
+ * ParametricRHS has templated call operator
+ *     template<typename T> void operator()(double t, const std::vector<T>& x, const std::vector<T>& p, std::vector<T>& dxdt)
+ */
+template<typename ParametricRHS>
+class DualSensitivity
+{
+public:
+    using State = std::vector<double>;
+    using DualType = Dual<1>;
+
+    void operator()(
+        ParametricRHS& rhs, double t, const State& x, const State& p, const State& f,
+        const State& s, size_t parameter_index, State& out
+    )
+    {
+        DSITERPP_UNUSED(f);
+        m_x.resize(x.size());
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            m_x[i] = DualType(x[i]);
+            m_x[i].derivatives[0] = s[i];
+        }
+        m_p.resize(p.size());
+        for (size_t j = 0; j < p.size(); j++)
+            m_p[j] = DualType(p[j]);
+        m_p[parameter_index].derivatives[0] = 1.0;
+
+        m_f.resize(x.size());
+        rhs(t, static_cast<const std::vector<DualType>&>(m_x), static_cast<const std::vector<DualType>&>(m_p), m_f);
+
+        out.resize(x.size());
+        for (size_t i = 0; i < x.size(); i++)
+            out[i] = m_f[i].derivatives[0];
+    }
+
+private:
+    std::vector<DualType> m_x;
+    std::vector<DualType> m_p;
+    std::vector<DualType> m_f;
+};
+
+}
+
+#endif // AUTODIFF_HPP_INCLUDED
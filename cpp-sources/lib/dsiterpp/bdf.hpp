@@ -0,0 +1,174 @@
+#ifndef BDF_HPP_INCLUDED
+#define BDF_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/error-estimator.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+#include "dsiterpp/krylov.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Preconditioner for Newton matrix I - gamma * J of implicit methods
+ */
+class IPreconditioner
+{
+public:
+    virtual ~IPreconditioner() {}
+
+    /**
+     * Prepare approximation of (I - gamma * J(t, x))^-1. Called only when gamma changed much
+     * or Newton iterations fail, so it is reused by many steps
+     */
+    virtual void setup(double t, const std::vector<double>& x, double gamma) = 0;
+
+    /**
+     * z = P^-1 * r
+     */
+    virtual void apply(const std::vector<double>& r, std::vector<double>& z) = 0;
+
+    /**
+     * Newton convergence degraded, so Jacobian should be recalculated on next setup()
+     */
+    virtual void jacobian_outdated() {}
+};
+
+struct BDFParameters
+{
+    size_t max_order = 5;
+
+    size_t max_newton_iterations = 6;
+    /// Newton iterations stop when correction is lesser relatively to state
+    double newton_tolerance = 1e-9;
+
+    size_t krylov_dimension = 20;
+    size_t max_krylov_restarts = 4;
+    /// Relative residual of linear solution inside Newton iteration
+    double krylov_tolerance = 1e-5;
+
+    /// Preconditioner is set up again when gamma = dt / alpha_0 changes relatively more
+    double preconditioner_gamma_change = 0.3;
+
+    /// If Newton iterations take more, preconditioner Jacobian is considered outdated
+    size_t slow_newton_iterations = 3;
+};
+
+struct BDFStatistics
+{
+    size_t steps = 0;
+    size_t newton_iterations = 0;
+    size_t newton_failures = 0;
+    size_t krylov_iterations = 0;
+    size_t preconditioner_setups = 0;
+    size_t max_used_order = 0;
+    /// Restarts from order 1 because state was changed outside of integrator
+    size_t history_restarts = 0;
+};
+
+/**
+ * Variable step, variable order (1-5) backward differentiation formulas for large stiff systems.
+ *
+ * Implicit equation is solved by Newton iterations where linear systems (I - gamma * J) d = r
+ * are solved by GMRES with finite difference Jacobian-vector products of IRHS, so Jacobian is
+ * never stored and memory is linear by system size. User may give preconditioner.
+ *
+ * Class is both IIntegrator and IErrorEstimator (difference with predictor is error estimation),
+ * so set the same object as integrator and as error estimator of TimeIterator. Solution history
+ * is committed in step_done(), if state is changed between steps (i.e. by bifurcation), method
+ * restarts from 1st order
+ */
+class BDFIterator : public IIntegrator, public ErrorEstimatorBase
+{
+public:
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+    void step_done(double time, double dt, IteratingMetrics& metrics) override final;
+
+    void calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt) override final;
+    void set_step_tolerance(double max_rel_error, double min_rel_error) override final;
+
+    void set_preconditioner(IPreconditioner* preconditioner);
+
+    BDFParameters& parameters();
+    const BDFStatistics& statistics() const;
+
+    /**
+     * Order for next step
+     */
+    size_t order() const;
+
+    /**
+     * Forget solution history, next step is done by 1st order
+     */
+    void reset();
+
+private:
+    /**
+     * Calculate solution at t + dt to m_solution and set variable delta
+     * @return false if Newton iterations do not converge
+     */
+    bool solve_step(IVariable* variable, IRHS* rhs, double t, double dt) const;
+
+    void prepare_history(double t) const;
+    bool is_history_continuous() const;
+
+    /**
+     * Value of polynomial interpolating first points_count history points at time
+     */
+    void extrapolate(size_t points_count, double time, std::vector<double>& result) const;
+
+    bool newton_iterations(double t, double gamma) const;
+    void newton_matrix_product(const std::vector<double>& v, std::vector<double>& result) const;
+
+    double scaled_norm(const std::vector<double>& v) const;
+
+    /**
+     * Error of order's solution estimated by difference with predictor of the same order
+     */
+    double estimate_error(size_t order) const;
+
+    BDFParameters m_parameters;
+    IPreconditioner* m_preconditioner = nullptr;
+    double m_max_rel_error = 0.0;
+
+    mutable BDFStatistics m_statistics;
+    mutable RHSEvaluator m_evaluator;
+    mutable GMRESSolver m_gmres;
+
+    // History of accepted points, the newest first
+    mutable std::vector<std::vector<double>> m_history;
+    mutable std::vector<double> m_history_times;
+    mutable size_t m_history_size = 0;
+
+    mutable size_t m_order = 1;
+    mutable size_t m_steps_at_order = 0;
+    mutable size_t m_next_order = 1;
+
+    mutable bool m_preconditioner_needs_setup = true;
+    mutable double m_preconditioner_gamma = 0.0;
+    mutable size_t m_last_newton_iterations = 0;
+
+    // Step being calculated
+    mutable double m_solution_time = 0.0;
+    mutable double m_gamma = 0.0;
+    mutable double m_stage_time = 0.0;
+    mutable double m_scale_floor = 0.0;
+    mutable std::vector<double> m_x0;
+    mutable std::vector<double> m_psi;
+    mutable std::vector<double> m_solution;
+    mutable std::vector<double> m_prediction;
+    mutable std::vector<double> m_f;
+    mutable std::vector<double> m_residual;
+    mutable std::vector<double> m_correction;
+    mutable std::vector<double> m_perturbed;
+    mutable std::vector<double> m_f_perturbed;
+    mutable std::vector<double> m_delta;
+    mutable std::vector<double> m_coefficients;
+};
+
+}
+
+#endif // BDF_HPP_INCLUDED
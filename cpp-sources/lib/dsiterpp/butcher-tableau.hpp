@@ -0,0 +1,59 @@
+#ifndef BUTCHER_TABLEAU_HPP_INCLUDED
+#define BUTCHER_TABLEAU_HPP_INCLUDED
+
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Compile-time Butcher tableaux for explicit Runge-Kutta methods used by RungeKuttaT.
+ *
+ * Every tableau provides:
+ *   stages, order  - number of stages and method order
+ *   a[stages][stages], b[stages], c[stages] - coefficients, a is strictly lower triangular
+ *
+ * Tableaux are class templates with a dummy parameter only to allow out-of-class
+ * definitions of static constexpr arrays in a header with C++11
+ */
+
+template<typename Dummy = void>
+struct EulerTableauCoefficients
+{
+    static constexpr size_t stages = 1;
+    static constexpr int order = 1;
+
+    static constexpr double a[stages][stages] = { { 0.0 } };
+    static constexpr double b[stages] = { 1.0 };
+    static constexpr double c[stages] = { 0.0 };
+};
+
+template<typename Dummy> constexpr double EulerTableauCoefficients<Dummy>::a[stages][stages];
+template<typename Dummy> constexpr double EulerTableauCoefficients<Dummy>::b[stages];
+template<typename Dummy> constexpr double EulerTableauCoefficients<Dummy>::c[stages];
+
+template<typename Dummy = void>
+struct RK4TableauCoefficients
+{
+    static constexpr size_t stages = 4;
+    static constexpr int order = 4;
+
+    static constexpr double a[stages][stages] = {
+        { 0.0, 0.0, 0.0, 0.0 },
+        { 0.5, 0.0, 0.0, 0.0 },
+        { 0.0, 0.5, 0.0, 0.0 },
+        { 0.0, 0.0, 1.0, 0.0 }
+    };
+    static constexpr double b[stages] = { 1.0 / 6.0, 1.0 / 3.0, 1.0 / 3.0, 1.0 / 6.0 };
+    static constexpr double c[stages] = { 0.0, 0.5, 0.5, 1.0 };
+};
+
+template<typename Dummy> constexpr double RK4TableauCoefficients<Dummy>::a[stages][stages];
+template<typename Dummy> constexpr double RK4TableauCoefficients<Dummy>::b[stages];
+template<typename Dummy> constexpr double RK4TableauCoefficients<Dummy>::c[stages];
+
+using EulerTableau = EulerTableauCoefficients<>;
+using RK4Tableau = RK4TableauCoefficients<>;
+
+}
+
+#endif // BUTCHER_TABLEAU_HPP_INCLUDED
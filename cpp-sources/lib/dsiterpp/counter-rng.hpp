@@ -0,0 +1,99 @@
+#ifndef COUNTER_RNG_HPP_INCLUDED
+#define COUNTER_RNG_HPP_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+namespace dsiterpp {
+
+/**
+ * Philox4x32-10 counter-based random bijection (J. Salmon et al., Random123, 2011).
+ * Random numbers are pure function of (counter, key), so there is no generator state to share
+ * between threads and any part of sequence is reproducible independently
+ */
+struct Philox4x32
+{
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static Counter generate(Counter counter, Key key)
+    {
+        for (int round = 0; round < 10; round++)
+        {
+            if (round != 0)
+            {
+                key[0] += 0x9E3779B9u;
+                key[1] += 0xBB67AE85u;
+            }
+            uint64_t product0 = uint64_t(0xD2511F53u) * counter[0];
+            uint64_t product1 = uint64_t(0xCD9E8D57u) * counter[2];
+            uint32_t hi0 = uint32_t(product0 >> 32), lo0 = uint32_t(product0);
+            uint32_t hi1 = uint32_t(product1 >> 32), lo1 = uint32_t(product1);
+            counter = Counter{{ hi1 ^ counter[1] ^ key[0], lo1, hi0 ^ counter[3] ^ key[1], lo0 }};
+        }
+        return counter;
+    }
+};
+
+/**
+ * Gaussian numbers N(0, 1) from Philox4x32 by Box-Muller transform.
+ *
+ * Generator is defined by (seed, stream), i.e. stream is index of ensemble member or thread.
+ * Numbers are addressed by (block, index) where block is i.e. step number, so the same
+ * step gets the same numbers however many times it is recalculated
+ */
+class NormalGenerator
+{
+public:
+    NormalGenerator(uint32_t seed = 0, uint32_t stream = 0) :
+        m_key{{seed, stream}}
+    { }
+
+    void set_seed(uint32_t seed, uint32_t stream)
+    {
+        m_key = Philox4x32::Key{{seed, stream}};
+    }
+
+    /**
+     * out[i] = N(0, 1) number with index i of block
+     */
+    void fill(uint64_t block, double* out, size_t count) const
+    {
+        const uint32_t block_lo = uint32_t(block), block_hi = uint32_t(block >> 32);
+        const size_t groups = count / 4;
+        for (size_t g = 0; g < groups; g++)
+            normal4(uint32_t(g), block_lo, block_hi, out + 4 * g);
+
+        if (groups * 4 != count)
+        {
+            double tail[4];
+            normal4(uint32_t(groups), block_lo, block_hi, tail);
+            for (size_t i = groups * 4; i < count; i++)
+                out[i] = tail[i - groups * 4];
+        }
+    }
+
+private:
+    void normal4(uint32_t group, uint32_t block_lo, uint32_t block_hi, double* out) const
+    {
+        const double two_pi = 6.283185307179586476925;
+        // Uniform in (0, 1), zero is excluded for logarithm
+        const double to_unit = 1.0 / 4294967296.0;
+        Philox4x32::Counter bits = Philox4x32::generate(Philox4x32::Counter{{group, 0, block_lo, block_hi}}, m_key);
+        double u0 = (bits[0] + 0.5) * to_unit, u1 = (bits[1] + 0.5) * to_unit;
+        double u2 = (bits[2] + 0.5) * to_unit, u3 = (bits[3] + 0.5) * to_unit;
+        double r0 = std::sqrt(-2.0 * std::log(u0)), r1 = std::sqrt(-2.0 * std::log(u2));
+        out[0] = r0 * std::cos(two_pi * u1);
+        out[1] = r0 * std::sin(two_pi * u1);
+        out[2] = r1 * std::cos(two_pi * u3);
+        out[3] = r1 * std::sin(two_pi * u3);
+    }
+
+    Philox4x32::Key m_key;
+};
+
+}
+
+#endif // COUNTER_RNG_HPP_INCLUDED
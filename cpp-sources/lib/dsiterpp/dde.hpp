@@ -0,0 +1,100 @@
+#ifndef DDE_HPP_INCLUDED
+#define DDE_HPP_INCLUDED
+
+#include "dsiterpp/time-iter.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * History of solution for delay differential equations x' = f(t, x(t), x(t - tau_1), ...).
+ *
+ * Set as step observer of TimeIterator. After every accepted step it stores state and RHS
+ * (one extra RHS calculation per step) to ring buffer and gives x(t - tau) by cubic Hermite
+ * interpolation with binary search, so IRHS may call value() from calculate_rhs().
+ * Only samples covering max delay are stored, so memory is bounded.
+ *
+ * Derivative discontinuities from initial time propagate to t0 + tau_i, t0 + tau_i + tau_j, ...
+ * These breakpoints up to discontinuity order are hit exactly by steps. Steps are also limited
+ * by minimal delay, so RHS never needs values after the last stored step
+ */
+class DelayHistory : public IStepObserver
+{
+public:
+    /// Value of component for time before initial time
+    using InitialHistory = std::function<double(double time, size_t component)>;
+
+    void set_target(IVariable* variable, IRHS* rhs);
+
+    /**
+     * Add constant delay used by RHS. Maximal delay defines history size
+     */
+    void add_delay(double delay);
+
+    /**
+     * If not set, initial state is continued to the past as constant
+     */
+    void set_initial_history(InitialHistory initial_history);
+
+    /**
+     * Count of delays sums that are considered as breakpoints. Discontinuity of derivative
+     * order k smooths by one order every delay, so method of order p needs about p + 1
+     */
+    void set_discontinuity_order(int order);
+
+    void set_limit_step_by_min_delay(bool limit);
+
+    /**
+     * Value of component (in collect_values() order) at time
+     */
+    double value(double time, size_t component) const;
+    void values(double time, std::vector<double>& values) const;
+
+    size_t samples_count() const;
+    size_t state_size() const;
+
+    void step_accepted(double time) override;
+    double next_breakpoint(double time) override;
+
+private:
+    void push_sample(double time);
+    void drop_old_samples(double time);
+    void grow();
+    void update_breakpoints();
+
+    /// Index in ring of i-th sample from the oldest
+    size_t ring_index(size_t i) const { return (m_first + i) % m_capacity; }
+    double sample_time(size_t i) const { return m_times[ring_index(i)]; }
+
+    RHSEvaluator m_evaluator;
+    InitialHistory m_initial_history;
+    std::vector<double> m_delays;
+    double m_max_delay = 0.0;
+    int m_discontinuity_order = 5;
+    bool m_limit_step_by_min_delay = true;
+
+    double m_initial_time = 0.0;
+    bool m_started = false;
+    std::vector<double> m_breakpoints;
+
+    // Ring buffer of samples
+    size_t m_state_size = 0;
+    size_t m_capacity = 0;
+    size_t m_first = 0;
+    size_t m_count = 0;
+    std::vector<double> m_times;
+    std::vector<double> m_values;
+    std::vector<double> m_derivatives;
+
+    std::vector<double> m_initial_values;
+    std::vector<double> m_sample_values;
+    std::vector<double> m_sample_rhs;
+};
+
+}
+
+#endif // DDE_HPP_INCLUDED
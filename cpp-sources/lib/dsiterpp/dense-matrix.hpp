@@ -0,0 +1,59 @@
+#ifndef DENSE_MATRIX_HPP_INCLUDED
+#define DENSE_MATRIX_HPP_INCLUDED
+
+#include <vector>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Square row-major matrix for small implicit systems
+ */
+class DenseMatrix
+{
+public:
+    DenseMatrix(size_t size = 0);
+
+    void resize(size_t size);
+    size_t size() const;
+
+    double& operator()(size_t row, size_t col);
+    double operator()(size_t row, size_t col) const;
+
+    void set_zero();
+
+    /**
+     * y = A * x
+     */
+    void multiply(const std::vector<double>& x, std::vector<double>& y) const;
+
+private:
+    size_t m_size = 0;
+    std::vector<double> m_data;
+};
+
+/**
+ * LU decomposition with partial pivoting
+ */
+class LUDecomposition
+{
+public:
+    /**
+     * Decompose matrix. Throws std::runtime_error for singular matrix
+     */
+    void decompose(const DenseMatrix& matrix);
+
+    /**
+     * Solve A x = b, b is replaced by x
+     */
+    void solve(std::vector<double>& b) const;
+
+private:
+    DenseMatrix m_lu;
+    std::vector<size_t> m_permutation;
+    mutable std::vector<double> m_buffer;
+};
+
+}
+
+#endif // DENSE_MATRIX_HPP_INCLUDED
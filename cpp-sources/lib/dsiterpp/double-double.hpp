@@ -0,0 +1,109 @@
+#ifndef DOUBLE_DOUBLE_HPP_INCLUDED
+#define DOUBLE_DOUBLE_HPP_INCLUDED
+
+#include "dsiterpp/utils.hpp"
+
+#include <cmath>
+
+namespace dsiterpp {
+
+/**
+ * Unevaluated sum of two doubles hi + lo with |lo| <= ulp(hi) / 2, about 32 significant digits.
+ * Scalar type for templated state (i.e. std::vector<DoubleDouble>) of long ill-conditioned runs.
+ * Error-free transformations are protected by fp_barrier(), so it works with -ffast-math
+ */
+struct DoubleDouble
+{
+    double hi = 0.0;
+    double lo = 0.0;
+
+    DoubleDouble() {}
+    DoubleDouble(double value) : hi(value) {}
+    DoubleDouble(double high, double low) : hi(high), lo(low) {}
+
+    explicit operator double() const { return hi + lo; }
+
+    /**
+     * Exact s + e = a + b
+     */
+    static DoubleDouble two_sum(double a, double b)
+    {
+        double s = fp_barrier(a + b);
+        double bb = fp_barrier(s - a);
+        double e = fp_barrier(a - fp_barrier(s - bb)) + fp_barrier(b - bb);
+        return DoubleDouble(s, e);
+    }
+
+    /**
+     * Exact s + e = a + b for |a| >= |b|
+     */
+    static DoubleDouble quick_two_sum(double a, double b)
+    {
+        double s = fp_barrier(a + b);
+        return DoubleDouble(s, b - fp_barrier(s - a));
+    }
+
+    /**
+     * Exact p + e = a * b
+     */
+    static DoubleDouble two_product(double a, double b)
+    {
+        double p = fp_barrier(a * b);
+        return DoubleDouble(p, std::fma(a, b, -p));
+    }
+
+    DoubleDouble& operator+=(const DoubleDouble& other)
+    {
+        DoubleDouble s = two_sum(hi, other.hi);
+        DoubleDouble t = two_sum(lo, other.lo);
+        s.lo += t.hi;
+        s = quick_two_sum(s.hi, s.lo);
+        s.lo += t.lo;
+        *this = quick_two_sum(s.hi, s.lo);
+        return *this;
+    }
+
+    DoubleDouble& operator-=(const DoubleDouble& other)
+    {
+        return *this += DoubleDouble(-other.hi, -other.lo);
+    }
+
+    DoubleDouble& operator*=(const DoubleDouble& other)
+    {
+        DoubleDouble p = two_product(hi, other.hi);
+        p.lo += hi * other.lo + lo * other.hi;
+        *this = quick_two_sum(p.hi, p.lo);
+        return *this;
+    }
+
+    DoubleDouble& operator/=(const DoubleDouble& other)
+    {
+        // Long division: q1 + q2 with correction by remainder
+        double q1 = hi / other.hi;
+        DoubleDouble remainder = *this;
+        remainder -= DoubleDouble(other) *= DoubleDouble(q1);
+        double q2 = remainder.hi / other.hi;
+        *this = quick_two_sum(q1, q2);
+        return *this;
+    }
+
+    DoubleDouble operator-() const { return DoubleDouble(-hi, -lo); }
+};
+
+inline DoubleDouble operator+(DoubleDouble a, const DoubleDouble& b) { return a += b; }
+inline DoubleDouble operator-(DoubleDouble a, const DoubleDouble& b) { return a -= b; }
+inline DoubleDouble operator*(DoubleDouble a, const DoubleDouble& b) { return a *= b; }
+inline DoubleDouble operator/(DoubleDouble a, const DoubleDouble& b) { return a /= b; }
+
+inline bool operator==(const DoubleDouble& a, const DoubleDouble& b) { return a.hi == b.hi && a.lo == b.lo; }
+inline bool operator!=(const DoubleDouble& a, const DoubleDouble& b) { return !(a == b); }
+inline bool operator<(const DoubleDouble& a, const DoubleDouble& b) { return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo); }
+inline bool operator>(const DoubleDouble& a, const DoubleDouble& b) { return b < a; }
+inline bool operator<=(const DoubleDouble& a, const DoubleDouble& b) { return !(b < a); }
+inline bool operator>=(const DoubleDouble& a, const DoubleDouble& b) { return !(a < b); }
+
+inline DoubleDouble fabs(const DoubleDouble& x) { return x.hi < 0.0 ? -x : x; }
+
+}
+
+#endif // DOUBLE_DOUBLE_HPP_INCLUDED
@@ -1,6 +1,8 @@
 #ifndef EEROR_ESTIMATOR_HPP_INCLUDED
 #define EEROR_ESTIMATOR_HPP_INCLUDED
 
+#include "utils.hpp"
+
 #include <limits>
 
 namespace dsiterpp {
@@ -28,6 +30,13 @@ public:
     virtual void calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt) = 0;
 
     virtual const IntegrationError& get_error() = 0;
+
+    /**
+     * Relative error bounds for next step: step is rejected if error is bigger than max_rel_error
+     * and following step is coarsened if error is lesser than min_rel_error.
+     * Estimators with adaptive order (i.e. extrapolation) may use it to choose order
+     */
+    virtual void set_step_tolerance(double max_rel_error, double min_rel_error) { DSITERPP_UNUSED(max_rel_error); DSITERPP_UNUSED(min_rel_error); }
 };
 
 class ErrorEstimatorBase : public IErrorEstimator
@@ -0,0 +1,88 @@
+#ifndef EXPONENTIAL_HPP_INCLUDED
+#define EXPONENTIAL_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/semilinear.hpp"
+#include "dsiterpp/phi-functions.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+
+#include <vector>
+
+namespace dsiterpp {
+
+/**
+ * Common part of exponential integrators for semilinear systems x' = L x + N(t, x).
+ * RHS passed to calculate_delta() should implement ISemilinearRHS
+ */
+class ExponentialIntegratorBase : public IIntegrator
+{
+public:
+    /**
+     * Krylov subspace dimension and tolerance of phi-functions for non-diagonal operators
+     */
+    void set_krylov_dimension(size_t dimension);
+    void set_krylov_tolerance(double tolerance);
+
+    const PhiCombination& phi_combination() const;
+
+protected:
+    static ISemilinearRHS* semilinear_rhs(IRHS* rhs);
+
+    /**
+     * n = N(t, x). Values and deltas of variable are overwritten
+     */
+    void evaluate_nonlinear(IVariable* variable, ISemilinearRHS* rhs, double t, const std::vector<double>& x, std::vector<double>& n) const;
+
+    mutable PhiCombination m_phi;
+    mutable RHSEvaluator m_evaluator;
+};
+
+/**
+ * Exponential time differencing Runge-Kutta method of 4th order (Cox, Matthews, 2002).
+ * Linear part is integrated exactly, so step is not limited by stiffness of L
+ */
+class ETDRK4Iterator : public ExponentialIntegratorBase
+{
+public:
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+
+private:
+    mutable std::vector<double> m_x0;
+    mutable std::vector<double> m_nx;
+    mutable std::vector<double> m_a;
+    mutable std::vector<double> m_na;
+    mutable std::vector<double> m_b;
+    mutable std::vector<double> m_nb;
+    mutable std::vector<double> m_c;
+    mutable std::vector<double> m_nc;
+    mutable std::vector<double> m_delta;
+    mutable std::vector<std::vector<double>> m_v;
+};
+
+/**
+ * Exponential Rosenbrock-Euler method of 2nd order:
+ *     x+ = x + h phi_1(h J) f(t, x) + h^2 phi_2(h J) df/dt
+ * where J = L + dN/dx. Product of J and vector is done by finite difference of N,
+ * so phi-functions are always calculated in Krylov subspace
+ */
+class ExponentialRosenbrockEulerIterator : public ExponentialIntegratorBase
+{
+public:
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+
+private:
+    mutable std::vector<double> m_x0;
+    mutable std::vector<double> m_n0;
+    mutable std::vector<double> m_lx;
+    mutable std::vector<double> m_nt;
+    mutable std::vector<double> m_perturbed;
+    mutable std::vector<double> m_n_perturbed;
+    mutable std::vector<double> m_delta;
+    mutable std::vector<std::vector<double>> m_v;
+};
+
+}
+
+#endif // EXPONENTIAL_HPP_INCLUDED
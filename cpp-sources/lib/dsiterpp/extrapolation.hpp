@@ -0,0 +1,104 @@
+#ifndef EXTRAPOLATION_HPP_INCLUDED
+#define EXTRAPOLATION_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/error-estimator.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+namespace dsiterpp {
+
+class ThreadPool;
+
+struct ExtrapolationParameters
+{
+    /// Columns of extrapolation tableau, method order is 2 * columns
+    size_t min_columns = 2;
+    size_t max_columns = 8;
+    size_t initial_columns = 4;
+};
+
+/**
+ * Gragg-Bulirsch-Stoer extrapolation method: modified midpoint rule with substep numbers
+ * 2, 4, 6, ... and Aitken-Neville extrapolation to zero substep.
+ *
+ * Class is both IIntegrator and IErrorEstimator: difference between last two diagonal
+ * elements of tableau is error estimation, so set the same object as integrator and as
+ * error estimator of TimeIterator. Order is adapted to step tolerance: tableau is built
+ * only until error is small enough to coarsen step, and number of columns for next step
+ * is corrected.
+ *
+ * Substep sequences are independent, so they are calculated on worker threads if thread
+ * safe flat RHS function is given by set_parallel_rhs(). Otherwise IRHS is used sequentially
+ */
+class GraggBulirschStoerIterator : public IIntegrator, public ErrorEstimatorBase
+{
+public:
+    using FlatRHSFunction = std::function<void(double time, const std::vector<double>& x, std::vector<double>& f)>;
+
+    GraggBulirschStoerIterator();
+    ~GraggBulirschStoerIterator();
+
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+
+    void calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt) override final;
+    void set_step_tolerance(double max_rel_error, double min_rel_error) override final;
+
+    /**
+     * Use rhs instead of IRHS to calculate substep sequences in parallel by threads_count threads.
+     * rhs should be thread safe and equivalent to IRHS given to calculate_delta
+     */
+    void set_parallel_rhs(FlatRHSFunction rhs, size_t threads_count);
+
+    ExtrapolationParameters& parameters();
+
+    /**
+     * Current number of tableau columns
+     */
+    size_t columns() const;
+
+private:
+    struct Sequence
+    {
+        std::vector<double> z_previous;
+        std::vector<double> z;
+        std::vector<double> f;
+        std::vector<double> result;
+    };
+
+    /**
+     * Build extrapolation tableau and set variable delta.
+     * @param tolerance Stop when error is lesser, 0 to use all columns
+     * @return number of used columns
+     */
+    size_t extrapolate(IVariable* variable, IRHS* rhs, double t, double dt, size_t columns, double tolerance) const;
+
+    void calculate_sequence(size_t index, double t, double dt, bool parallel) const;
+    void evaluate(double t, const std::vector<double>& x, std::vector<double>& f, bool parallel) const;
+    void extrapolate_row(size_t row) const;
+
+    ExtrapolationParameters m_parameters;
+    size_t m_columns;
+    double m_target_error = 0.0;
+
+    FlatRHSFunction m_parallel_rhs;
+    std::unique_ptr<ThreadPool> m_thread_pool;
+
+    mutable RHSEvaluator m_evaluator;
+    mutable std::vector<double> m_x0;
+    mutable std::vector<double> m_f0;
+    mutable std::vector<double> m_delta;
+    mutable std::vector<Sequence> m_sequences;
+    mutable std::vector<std::vector<double>> m_row;
+    mutable std::vector<std::vector<double>> m_previous_row;
+    mutable double m_last_error = 0.0;
+};
+
+}
+
+#endif // EXTRAPOLATION_HPP_INCLUDED
@@ -0,0 +1,115 @@
+#ifndef INCREMENTAL_RHS_HPP_INCLUDED
+#define INCREMENTAL_RHS_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <limits>
+#include <cstddef>
+
+namespace dsiterpp {
+
+class PartitionedVariable;
+
+/**
+ * RHS group for large sparse networks that re-evaluates only members whose inputs changed.
+ *
+ * Every member declares state blocks it reads: VariableScalar objects or partitions of
+ * PartitionedVariable. Group gives these variables its ChangeTracker, so stage updates of
+ * variables mark changed blocks dirty and calculate_rhs() visits only dirty blocks and
+ * their readers (and time dependent members, if time changed). Cost per call is linear by
+ * count of changed blocks and their readers, not by count of inputs.
+ * Skipped members keep rhs they set before, that is exact when change threshold is 0.
+ * With positive threshold small input changes are ignored until they accumulate above it
+ * (latency driven evaluation), so event-driven models are evaluated lazily.
+ *
+ * Variable may be tracked by only one group. Values changed outside IVariable interface
+ * are seen after next clear_subiteration(). Rhs of skipped members should not be changed
+ * outside, so after IVariable::clear_rhs() (i.e. by SplittingIterator or ARKIMEXIterator
+ * with RHSGroup) call invalidate()
+ */
+class IncrementalRHSGroup : public IRHS
+{
+public:
+    /**
+     * @param inputs Variables that rhs reads. Rhs depends only on them and on time if time_dependent
+     */
+    void add_rhs(IRHS* rhs, const std::vector<VariableScalar*>& inputs, bool time_dependent = false);
+
+    /**
+     * @param partitions Indices of partitions of variable that rhs reads
+     */
+    void add_rhs(IRHS* rhs, PartitionedVariable& variable, const std::vector<size_t>& partitions, bool time_dependent = false);
+
+    void pre_iteration_job(double time) override;
+    void pre_sub_iteration_job(double time) override;
+    void calculate_rhs(double time) override;
+
+    /**
+     * Input is dirty only if it changed more than threshold since last evaluation
+     */
+    void set_change_threshold(double threshold);
+
+    /**
+     * Evaluate all members on next calculate_rhs()
+     */
+    void invalidate();
+
+    size_t evaluations_count() const;
+    size_t skipped_count() const;
+
+    /// Dirty blocks visited by calculate_rhs() calls
+    size_t visited_blocks_count() const;
+
+private:
+    struct Member
+    {
+        IRHS* rhs = nullptr;
+        // Number of calculate_rhs() call when member was last scheduled
+        size_t evaluated_call = 0;
+    };
+
+    struct Block
+    {
+        VariableScalar* scalar = nullptr;
+        PartitionedVariable* partitioned = nullptr;
+        size_t partition = 0;
+        // Range in m_evaluated_values
+        size_t values_begin = 0;
+        size_t values_size = 0;
+        std::vector<size_t> readers;
+    };
+
+    size_t add_member(IRHS* rhs, bool time_dependent);
+    size_t scalar_block(VariableScalar* variable);
+    size_t partition_block(PartitionedVariable& variable, size_t partition);
+    void add_reader(size_t block, size_t member);
+    bool is_changed(const Block& block) const;
+    bool is_value_changed(double value, double evaluated) const;
+    void remember_values(const Block& block);
+    void evaluate(size_t member, double time);
+
+    ChangeTracker m_tracker;
+    std::vector<Member> m_members;
+    std::vector<size_t> m_time_dependent;
+    std::vector<Block> m_blocks;
+    std::vector<double> m_evaluated_values;
+    std::vector<size_t> m_to_evaluate;
+
+    // Registration only, first block of every tracked variable
+    std::unordered_map<const IVariable*, size_t> m_first_blocks;
+
+    double m_threshold = 0.0;
+    double m_evaluated_time = std::numeric_limits<double>::quiet_NaN();
+    bool m_valid = false;
+    size_t m_call = 0;
+
+    size_t m_evaluations = 0;
+    size_t m_skipped = 0;
+    size_t m_visited_blocks = 0;
+};
+
+}
+
+#endif // INCREMENTAL_RHS_HPP_INCLUDED
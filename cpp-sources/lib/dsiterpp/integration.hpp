@@ -5,9 +5,12 @@
 
 #include <vector>
 #include <functional>
+#include <cstddef>
 
 namespace dsiterpp {
 
+struct IteratingMetrics;
+
 class IVariable
 {
 public:
@@ -50,6 +53,20 @@ public:
      * Add all current values to vector. Vector may already contain something, use push_back
      */
     virtual void set_values(std::vector<double>::const_iterator& values) = 0;
+
+    /**
+     * For methods that calculate delta outside of variable (i.e. implicit).
+     * Set all current deltas from vector, order is the same as in collect_deltas.
+     * Default implementation throws std::logic_error
+     */
+    virtual void set_deltas(std::vector<double>::const_iterator& deltas);
+
+    /**
+     * Make rhs zero. Needed when rhs is calculated only by a part of RHS
+     * that does not set rhs of every variable (see RHSGroup::Treatment).
+     * Default implementation throws std::logic_error
+     */
+    virtual void clear_rhs();
 };
 
 class IRHS
@@ -73,10 +90,36 @@ public:
     virtual void calculate_rhs(double time) { DSITERPP_UNUSED(time); }
 };
 
+/**
+ * Dirty marks of state blocks. Variable given a tracker marks its block when its current
+ * values are changed, so reader (i.e. IncrementalRHSGroup) visits only changed blocks
+ * instead of comparing whole state. Not thread safe, variables mark blocks from calling thread
+ */
+class ChangeTracker
+{
+public:
+    size_t add_block();
+    void mark_dirty(size_t block);
+
+    /// Blocks marked since last clear(), every block once
+    const std::vector<size_t>& dirty_blocks() const;
+    void clear();
+
+    size_t blocks_count() const;
+
+private:
+    std::vector<char> m_dirty;
+    std::vector<size_t> m_dirty_blocks;
+};
+
 class VariableScalar : public IVariable
 {
 public:
     VariableScalar(double value = 0);
+
+    /// Copy is not tracked, assignment keeps tracker of target
+    VariableScalar(const VariableScalar& other);
+    VariableScalar& operator=(const VariableScalar& other);
     void clear_subiteration() override;
     void add_rhs_to_delta(double m) override;
     void make_sub_iteration(double dt) override;
@@ -84,19 +127,37 @@ public:
     void collect_values(std::vector<double>& values) const override;
     void collect_deltas(std::vector<double>& deltas) const override;
     void set_values(std::vector<double>::const_iterator& values) override;
+    void set_deltas(std::vector<double>::const_iterator& deltas) override;
+    void clear_rhs() override;
 
     // API for IContinuousIterableLogic
     double current_value();
     void set_rhs(double rhs);
 
+    /**
+     * Add part of rhs, i.e. when several members of RHSGroup act on the same variable.
+     * Rhs should be cleared before, see RHSGroup::set_variable()
+     */
+    void add_to_rhs(double rhs);
+
+    /**
+     * Mark block in tracker when current value is changed. Set nullptr to disable
+     */
+    void set_change_tracker(ChangeTracker* tracker, size_t block);
+
     // API for usage
     operator double&();
 
 private:
+    void set_current(double value);
+
     double m_previous_value;
     double m_current_value;
     double m_delta;
     double m_rhs;
+
+    ChangeTracker* m_tracker = nullptr;
+    size_t m_block = 0;
 };
 
 class VariablesGroup : public IVariable
@@ -111,6 +172,8 @@ public:
     void collect_values(std::vector<double>& values) const override;
     void collect_deltas(std::vector<double>& deltas) const override;
     void set_values(std::vector<double>::const_iterator& values) override;
+    void set_deltas(std::vector<double>::const_iterator& deltas) override;
+    void clear_rhs() override;
 
 private:
     std::vector<IVariable*> m_variables;
@@ -119,13 +182,42 @@ private:
 class RHSGroup : public IRHS
 {
 public:
-    void add_rhs(IRHS* rhs);
+    /**
+     * Tag for IMEX integrators: implicit part contains stiff terms, explicit part contains others.
+     * Integrators that do not distinguish parts use both, so parts acting on the same variable
+     * should add their rhs (VariableScalar::add_to_rhs()) to rhs cleared by the group
+     */
+    enum class Treatment
+    {
+        explicit_part = 0,
+        implicit_part
+    };
+
+    void add_rhs(IRHS* rhs, Treatment treatment = Treatment::explicit_part);
+
+    /**
+     * Variable which rhs is cleared before members are calculated, so members may add
+     * their parts to rhs of the same variable. Without it members should set rhs of
+     * disjoint variables
+     */
+    void set_variable(IVariable* variable);
 
     void pre_iteration_job(double time) override;
     void pre_sub_iteration_job(double time) override;
     void calculate_rhs(double time) override;
+
+    /**
+     * Calculate rhs of members with given treatment only. If variable is not set,
+     * variables not covered by these members keep their rhs, so call IVariable::clear_rhs() before
+     */
+    void calculate_rhs(double time, Treatment treatment);
+
+    bool has_part(Treatment treatment) const;
+
 private:
     std::vector<IRHS*> m_RHSs;
+    std::vector<Treatment> m_treatments;
+    IVariable* m_variable = nullptr;
 };
 
 class RHSScalar : public IRHS
@@ -153,6 +245,12 @@ public:
     virtual void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const = 0;
 
     virtual int method_order() const = 0;
+
+    /**
+     * Called by TimeIterator after step from time to time + dt is accepted and done.
+     * Integrators that adapt to problem (i.e. switch methods) may update state and metrics here
+     */
+    virtual void step_done(double time, double dt, IteratingMetrics& metrics) { DSITERPP_UNUSED(time); DSITERPP_UNUSED(dt); DSITERPP_UNUSED(metrics); }
 };
 
 }
@@ -0,0 +1,69 @@
+#ifndef KRYLOV_HPP_INCLUDED
+#define KRYLOV_HPP_INCLUDED
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Restarted GMRES for A x = b where A is given only as matrix-vector product, so memory
+ * is (krylov_dimension + 2) vectors of system size. Preconditioner is applied from the right.
+ * Scratch buffers are kept between solutions
+ */
+class GMRESSolver
+{
+public:
+    /// result = A * v or result = M^-1 * v for preconditioner
+    using Operator = std::function<void(const std::vector<double>& v, std::vector<double>& result)>;
+
+    void set_krylov_dimension(size_t dimension);
+    void set_max_restarts(size_t restarts);
+
+    /**
+     * Solve until |b - A x| <= tolerance * |b|
+     */
+    void set_tolerance(double tolerance);
+
+    /**
+     * Solve A x = b starting from x = 0. preconditioner may be empty function
+     * @return true if tolerance is reached
+     */
+    bool solve(const Operator& a, const Operator& preconditioner, const std::vector<double>& b, std::vector<double>& x);
+
+    /**
+     * Matrix-vector products done by last solve()
+     */
+    size_t iterations() const;
+
+    /**
+     * Relative residual after last solve()
+     */
+    double residual() const;
+
+private:
+    size_t m_krylov_dimension = 20;
+    size_t m_max_restarts = 5;
+    double m_tolerance = 1e-6;
+
+    size_t m_iterations = 0;
+    double m_residual = 0.0;
+
+    std::vector<std::vector<double>> m_basis;
+    std::vector<std::vector<double>> m_hessenberg;
+    std::vector<double> m_g;
+    std::vector<double> m_cos;
+    std::vector<double> m_sin;
+    std::vector<double> m_y;
+    std::vector<double> m_w;
+    std::vector<double> m_z;
+    std::vector<double> m_update;
+};
+
+double dot(const std::vector<double>& a, const std::vector<double>& b);
+double norm2(const std::vector<double>& a);
+
+}
+
+#endif // KRYLOV_HPP_INCLUDED
@@ -0,0 +1,188 @@
+#ifndef PARAREAL_HPP_INCLUDED
+#define PARAREAL_HPP_INCLUDED
+
+#include "dsiterpp/state-traits.hpp"
+#include "dsiterpp/thread-pool.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Parareal parallel-in-time integration for compile-time dispatched path.
+ *
+ * Time interval is split into slices. Cheap coarse propagator G runs sequentially over
+ * slices, accurate fine propagator F runs on all slices in parallel, and slice boundary
+ * states are corrected as
+ *     U_{n+1} = G(U_n new) + F(U_n old) - G(U_n old)
+ * until correction is below tolerance. After k iterations first k slices are exact,
+ * so solution is equal to sequential fine one at most after slices count iterations.
+ *
+ * Every slice has its own copy of fine integrator and of RHS, so RHS should be copyable
+ * and its copies should be independent.
+ *
+ * @tparam Coarse  Integrator like EulerExplicitT<State> used with coarse step
+ * @tparam Fine    Integrator like RK4T<State> used with fine step
+ * @tparam State   Contiguous state container (see StateTraits)
+ * @tparam RHS     Callable void(double time, const State& x, State& dxdt)
+ */
+template<typename Coarse, typename Fine, typename State, typename RHS>
+class PararealT
+{
+public:
+    PararealT(RHS rhs, ThreadPool& pool) :
+        m_rhs(rhs), m_pool(pool), m_slices_count(pool.threads_count())
+    {
+    }
+
+    void set_slices_count(size_t slices_count) { m_slices_count = slices_count; }
+    void set_coarse_step(double dt) { m_coarse_step = dt; }
+    void set_fine_step(double dt) { m_fine_step = dt; }
+
+    /**
+     * Iterations stop when max correction of slice states is below tolerance * (1 + max |x|)
+     */
+    void set_tolerance(double tolerance) { m_tolerance = tolerance; }
+    void set_max_iterations(size_t max_iterations) { m_max_iterations = max_iterations; }
+
+    /**
+     * Integrate from x0 at t_begin to t_end
+     * @return true if converged
+     */
+    bool solve(double t_begin, double t_end, const State& x0)
+    {
+        if (m_slices_count == 0 || !(t_end > t_begin))
+            throw std::invalid_argument("PararealT: slices count and time interval should be positive");
+
+        const size_t slices = m_slices_count;
+        m_times.resize(slices + 1);
+        for (size_t n = 0; n <= slices; n++)
+            m_times[n] = t_begin + (t_end - t_begin) * n / slices;
+        m_times[slices] = t_end;
+
+        m_states.assign(slices + 1, x0);
+        m_coarse.assign(slices, x0);
+        m_fine.assign(slices, x0);
+        m_fine_deltas.assign(slices, x0);
+        m_fine_integrators.resize(slices);
+        // Lambdas are not copy assignable
+        m_fine_rhs.clear();
+        for (size_t n = 0; n < slices; n++)
+            m_fine_rhs.push_back(m_rhs);
+
+        // Initial guess by coarse propagator only
+        for (size_t n = 0; n < slices; n++)
+        {
+            m_coarse[n] = m_states[n];
+            propagate(m_coarse_integrator, m_rhs, m_times[n], m_times[n + 1], m_coarse_step, m_coarse[n], m_coarse_delta);
+            m_states[n + 1] = m_coarse[n];
+        }
+
+        const size_t n_size = StateTraits<State>::size(x0);
+        m_iterations = 0;
+        m_converged = false;
+        for (size_t k = 0; k < slices && k < m_max_iterations; k++)
+        {
+            m_pool.parallel_for(slices - k, [this, k](size_t index) {
+                const size_t n = k + index;
+                m_fine[n] = m_states[n];
+                propagate(m_fine_integrators[n], m_fine_rhs[n], m_times[n], m_times[n + 1], m_fine_step, m_fine[n], m_fine_deltas[n]);
+            });
+
+            // Slice k is exact now, others are corrected sequentially
+            double max_correction = 0.0;
+            double max_value = 0.0;
+            for (size_t n = k; n < slices; n++)
+            {
+                m_coarse_new = m_states[n];
+                propagate(m_coarse_integrator, m_rhs, m_times[n], m_times[n + 1], m_coarse_step, m_coarse_new, m_coarse_delta);
+                State& next = m_states[n + 1];
+                using std::fabs;
+                for (size_t i = 0; i < n_size; i++)
+                {
+                    const typename StateTraits<State>::value_type corrected = m_coarse_new[i] + m_fine[n][i] - m_coarse[n][i];
+                    max_correction = std::max(max_correction, static_cast<double>(fabs(corrected - next[i])));
+                    max_value = std::max(max_value, static_cast<double>(fabs(corrected)));
+                    next[i] = corrected;
+                }
+                std::swap(m_coarse[n], m_coarse_new);
+            }
+
+            m_iterations = k + 1;
+            if (max_correction <= m_tolerance * (1.0 + max_value) || m_iterations == slices)
+            {
+                m_converged = true;
+                break;
+            }
+        }
+        return m_converged;
+    }
+
+    const State& solution() const { return m_states.back(); }
+
+    /**
+     * States at slice boundaries, first is initial state
+     */
+    const std::vector<State>& slice_states() const { return m_states; }
+    const std::vector<double>& slice_times() const { return m_times; }
+
+    size_t iterations() const { return m_iterations; }
+    bool converged() const { return m_converged; }
+
+private:
+    template<typename Integrator>
+    void propagate(Integrator& integrator, RHS& rhs, double t_begin, double t_end, double dt, State& x, State& delta)
+    {
+        const size_t steps = std::max<size_t>(1, static_cast<size_t>(ceil((t_end - t_begin) / dt - 1e-9)));
+        const double h = (t_end - t_begin) / steps;
+        const size_t n = StateTraits<State>::size(x);
+        StateTraits<State>::resize_like(delta, x);
+        for (size_t s = 0; s < steps; s++)
+        {
+            integrator.calculate_delta(rhs, t_begin + s * h, x, h, delta);
+            for (size_t i = 0; i < n; i++)
+                x[i] += delta[i];
+        }
+    }
+
+    RHS m_rhs;
+    ThreadPool& m_pool;
+    size_t m_slices_count;
+    double m_coarse_step = 0.1;
+    double m_fine_step = 0.001;
+    double m_tolerance = 1e-10;
+    size_t m_max_iterations = 1000;
+
+    Coarse m_coarse_integrator;
+    std::vector<Fine> m_fine_integrators;
+    std::vector<RHS> m_fine_rhs;
+
+    std::vector<double> m_times;
+    std::vector<State> m_states;
+    std::vector<State> m_coarse;
+    std::vector<State> m_fine;
+    std::vector<State> m_fine_deltas;
+    State m_coarse_new;
+    State m_coarse_delta;
+
+    size_t m_iterations = 0;
+    bool m_converged = false;
+};
+
+/**
+ * Helper to deduce RHS type of lambdas:
+ *     auto parareal = make_parareal_t<EulerExplicitT<State>, RK4T<State>, State>(rhs, pool);
+ */
+template<typename Coarse, typename Fine, typename State, typename RHS>
+PararealT<Coarse, Fine, State, RHS> make_parareal_t(RHS rhs, ThreadPool& pool)
+{
+    return PararealT<Coarse, Fine, State, RHS>(rhs, pool);
+}
+
+}
+
+#endif // PARAREAL_HPP_INCLUDED
@@ -0,0 +1,136 @@
+#ifndef PARTITIONED_VARIABLE_HPP_INCLUDED
+#define PARTITIONED_VARIABLE_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/error-estimator.hpp"
+#include "dsiterpp/thread-pool.hpp"
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Contiguous state of large system split into blocks, one per worker of PinnedThreadPool.
+ *
+ * Every block is allocated and first touched by its pinned worker, so its pages are on NUMA
+ * node of that worker. Stage updates of integrators (add_rhs_to_delta, make_sub_iteration,
+ * step, ...) run on the same workers, so each socket streams only its local memory.
+ * Use instead of VariablesGroup of many VariableScalar for systems of millions of components
+ */
+class PartitionedVariable : public IVariable
+{
+public:
+    /**
+     * Part of state owned by one worker: components [begin, begin + size).
+     * It is a view, so arrays are writable through const Partition&
+     */
+    struct Partition
+    {
+        size_t index = 0;
+        size_t begin = 0;
+        size_t size = 0;
+        double* previous = nullptr;
+        double* current = nullptr;
+        double* delta = nullptr;
+        double* rhs = nullptr;
+    };
+
+    using PartitionTask = std::function<void(const Partition& partition)>;
+
+    PartitionedVariable(size_t size, PinnedThreadPool& pool);
+
+    void clear_subiteration() override;
+    void add_rhs_to_delta(double m) override;
+    void make_sub_iteration(double dt) override;
+    void step() override;
+    void collect_values(std::vector<double>& values) const override;
+    void collect_deltas(std::vector<double>& deltas) const override;
+    void set_values(std::vector<double>::const_iterator& values) override;
+    void set_deltas(std::vector<double>::const_iterator& deltas) override;
+    void clear_rhs() override;
+
+    /**
+     * Run task for every partition on its worker and wait
+     */
+    void for_each_partition(const PartitionTask& task) const;
+
+    size_t size() const;
+    size_t partitions_count() const;
+    const Partition& partition(size_t index) const;
+    PinnedThreadPool& pool();
+
+    // API for RHS, index is global. Partition-parallel access is faster
+    double current_value(size_t index) const;
+    void set_rhs(size_t index, double rhs);
+
+    // API for usage, like VariableScalar::operator double&()
+    double& value(size_t index);
+
+    /**
+     * Mark block first_block + partition index in tracker when current values of partition
+     * are changed. Set nullptr to disable
+     */
+    void set_change_tracker(ChangeTracker* tracker, size_t first_block);
+
+private:
+    void mark_changed_partitions();
+
+    PinnedThreadPool& m_pool;
+    size_t m_size;
+    size_t m_block_size;
+    std::vector<Partition> m_partitions;
+    std::vector<std::unique_ptr<double[]>> m_memory;
+
+    ChangeTracker* m_tracker = nullptr;
+    size_t m_first_block = 0;
+    // Set by workers, marked in tracker by calling thread
+    std::vector<char> m_changed;
+};
+
+/**
+ * RHS that is calculated partition-parallel: function is called for every partition
+ * on its worker and should set partition.rhs. It may read any component by current_value()
+ */
+class PartitionedRHS : public IRHS
+{
+public:
+    using RHSFunction = std::function<void(double time, const PartitionedVariable::Partition& partition)>;
+
+    PartitionedRHS(PartitionedVariable& variable, RHSFunction rhs);
+    void calculate_rhs(double time) override;
+
+private:
+    PartitionedVariable& m_variable;
+    RHSFunction m_rhs_function;
+};
+
+/**
+ * Same algorithm as RungeErrorEstimator, but copies of values and deltas are kept in
+ * partition-local buffers and error maximum is reduced per partition on its worker.
+ * Works only with PartitionedVariable
+ */
+class PartitionedRungeErrorEstimator : public ErrorEstimatorBase
+{
+public:
+    void calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt) override;
+    void set_integrator(IIntegrator* integrator) override;
+
+private:
+    struct Scratch
+    {
+        std::vector<double> values;
+        std::vector<double> deltas_h_2_part_1;
+        std::vector<double> deltas_h_2_part_2;
+        IntegrationError error;
+    };
+
+    double m_error_multiplier = 1.0;
+    std::vector<Scratch> m_scratch;
+};
+
+}
+
+#endif // PARTITIONED_VARIABLE_HPP_INCLUDED
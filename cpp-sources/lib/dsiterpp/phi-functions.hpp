@@ -0,0 +1,81 @@
+#ifndef PHI_FUNCTIONS_HPP_INCLUDED
+#define PHI_FUNCTIONS_HPP_INCLUDED
+
+#include "dsiterpp/semilinear.hpp"
+#include "dsiterpp/dense-matrix.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * phi_0(z) = e^z, phi_{k+1}(z) = (phi_k(z) - 1/k!) / z, stable for small z
+ */
+double phi_function(size_t k, double z);
+
+/**
+ * Matrix exponential by diagonal Pade approximation of 6th degree with scaling and squaring
+ */
+void matrix_exponential(const DenseMatrix& a, DenseMatrix& result);
+
+/**
+ * Linear combination of phi-functions applied to vectors used by exponential integrators:
+ *     u = sum_{k=0..p} t^k phi_k(t A) v_k
+ *
+ * For diagonal A it is computed component-wise. Otherwise u is the first block of
+ * exp(t A~) [v_0, e_p] with A~ = [[A, (v_p ... v_1)], [0, shift]], that is approximated in
+ * Krylov subspace of A~ (matrix-vector products of A only) with Pade exponential of small
+ * Hessenberg matrix. If Krylov error estimation is too big, t is split into substeps
+ */
+class PhiCombination
+{
+public:
+    void set_krylov_dimension(size_t dimension);
+
+    /**
+     * Allowed relative error of Krylov approximation
+     */
+    void set_tolerance(double tolerance);
+
+    void calculate(const LinearOperator& a, double t, const std::vector<std::vector<double>>& v, std::vector<double>& u);
+
+    /**
+     * Matrix-vector products of A done by last calculate()
+     */
+    size_t matvec_count() const;
+
+    /**
+     * Substeps used by last calculate()
+     */
+    size_t substeps_count() const;
+
+private:
+    void calculate_diagonal(const std::vector<double>& diagonal, double t, const std::vector<std::vector<double>>& v, std::vector<double>& u);
+
+    /**
+     * u = exp(tau A~) [u, e_p] top part, w are v_k for augmented block
+     * @return Error estimation
+     */
+    double krylov_step(const LinearOperator& a, double tau, const std::vector<std::vector<double>>& w, std::vector<double>& u);
+
+    void augmented_product(const LinearOperator& a, const std::vector<std::vector<double>>& w, const std::vector<double>& x, std::vector<double>& y);
+
+    size_t m_krylov_dimension = 30;
+    double m_tolerance = 1e-10;
+
+    size_t m_matvec_count = 0;
+    size_t m_substeps_count = 0;
+
+    std::vector<std::vector<double>> m_basis;
+    std::vector<std::vector<double>> m_w;
+    DenseMatrix m_hessenberg;
+    DenseMatrix m_exponential;
+    std::vector<double> m_top;
+    std::vector<double> m_product;
+    std::vector<double> m_u;
+};
+
+}
+
+#endif // PHI_FUNCTIONS_HPP_INCLUDED
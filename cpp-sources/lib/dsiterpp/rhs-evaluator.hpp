@@ -0,0 +1,63 @@
+#ifndef RHS_EVALUATOR_HPP_INCLUDED
+#define RHS_EVALUATOR_HPP_INCLUDED
+
+#include <vector>
+#include <cstddef>
+
+namespace dsiterpp {
+
+class IVariable;
+class IRHS;
+
+/**
+ * Evaluation of IRHS as a function of flat state vector f(t, x).
+ * Needed by methods that work with arbitrary states rather than with
+ * sub iterations of IVariable (implicit methods, stiffness detection).
+ *
+ * Evaluation overwrites values and deltas of variable, so caller should
+ * restore them with restore() when finished
+ */
+class RHSEvaluator
+{
+public:
+    void set_target(IVariable* variable, IRHS* rhs);
+
+    /**
+     * Add current values of variable to vector (cleared before)
+     */
+    void collect_values(std::vector<double>& values);
+
+    /**
+     * f = f(t, x)
+     */
+    void evaluate(double t, const std::vector<double>& x, std::vector<double>& f);
+
+    /**
+     * f = f(t, x) for x equal to previous values of variable, so values are not changed
+     */
+    void evaluate_current(double t, std::vector<double>& f);
+
+    /**
+     * Make previous values = x and deltas = delta
+     */
+    void restore(const std::vector<double>& x, const std::vector<double>& delta);
+
+    /**
+     * Make previous values = x and clear deltas
+     */
+    void restore(const std::vector<double>& x);
+
+    IVariable* variable();
+    IRHS* rhs();
+
+    size_t evaluations_count();
+
+private:
+    IVariable* m_variable = nullptr;
+    IRHS* m_rhs = nullptr;
+    size_t m_evaluations_count = 0;
+};
+
+}
+
+#endif // RHS_EVALUATOR_HPP_INCLUDED
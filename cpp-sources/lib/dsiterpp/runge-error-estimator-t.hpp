@@ -0,0 +1,86 @@
+#ifndef RUNGE_ERROR_ESTIMATOR_T_HPP_INCLUDED
+#define RUNGE_ERROR_ESTIMATOR_T_HPP_INCLUDED
+
+#include "dsiterpp/error-estimator.hpp"
+#include "dsiterpp/state-traits.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dsiterpp {
+
+/**
+ * Runge (step doubling) error estimator for compile-time dispatched path.
+ * Same algorithm as RungeErrorEstimator, but scratch buffers have State type, so
+ * for FixedState nothing is allocated and all loops have constant trip count
+ */
+template<typename Integrator>
+class RungeErrorEstimatorT
+{
+public:
+    using State = typename Integrator::state_type;
+
+    /**
+     * Calculate delta at point t with step dt and estimate errors. Delta of single full step is returned
+     */
+    template<typename RHS>
+    const IntegrationError& calculate_delta_and_estimate(
+        Integrator& integrator, RHS& rhs, double t, const State& x, double dt, State& delta
+    )
+    {
+        using Traits = StateTraits<State>;
+        const size_t n = Traits::size(x);
+
+        Traits::resize_like(m_half_state, x);
+        Traits::resize_like(m_deltas_h_2_part_1, x);
+        Traits::resize_like(m_deltas_h_2_part_2, x);
+
+        integrator.calculate_delta(rhs, t, x, dt / 2.0, m_deltas_h_2_part_1);
+        for (size_t i = 0; i < n; i++)
+            m_half_state[i] = x[i] + m_deltas_h_2_part_1[i];
+
+        integrator.calculate_delta(rhs, t + dt / 2.0, static_cast<const State&>(m_half_state), dt / 2.0, m_deltas_h_2_part_2);
+        integrator.calculate_delta(rhs, t, x, dt, delta);
+
+        const double error_multiplier = 1.0 / (std::pow(2.0, integrator.method_order()) - 1.0);
+
+        m_error.max_abs_error = 0.0;
+        m_error.max_rel_error = 0.0;
+        const size_t controlled = m_controlled_size == 0 ? n : std::min(n, m_controlled_size);
+        // Scalar may be not double (i.e. DoubleDouble with its own fabs found by ADL)
+        using std::fabs;
+        for (size_t i = 0; i < controlled; i++)
+        {
+            double abs_error = static_cast<double>(fabs(delta[i] - (m_deltas_h_2_part_1[i] + m_deltas_h_2_part_2[i]))) * error_multiplier;
+            double base_value = static_cast<double>(fabs(x[i])) + static_cast<double>(fabs(delta[i]));
+            double rel_error = abs_error / base_value;
+
+            if (rel_error > m_error.max_rel_error)
+                m_error.max_rel_error = rel_error;
+
+            if (abs_error > m_error.max_abs_error)
+                m_error.max_abs_error = abs_error;
+        }
+        return m_error;
+    }
+
+    const IntegrationError& get_error() const { return m_error; }
+
+    /**
+     * Estimate error only by first count components of state, 0 for all components.
+     * I.e. to exclude sensitivities of SensitivityRHS from error control
+     */
+    void set_controlled_size(size_t count) { m_controlled_size = count; }
+
+private:
+    IntegrationError m_error;
+    size_t m_controlled_size = 0;
+
+    State m_half_state;
+    State m_deltas_h_2_part_1;
+    State m_deltas_h_2_part_2;
+};
+
+}
+
+#endif // RUNGE_ERROR_ESTIMATOR_T_HPP_INCLUDED
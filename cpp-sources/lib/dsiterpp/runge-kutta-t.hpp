@@ -0,0 +1,104 @@
+#ifndef RUNGE_KUTTA_T_HPP_INCLUDED
+#define RUNGE_KUTTA_T_HPP_INCLUDED
+
+#include "dsiterpp/butcher-tableau.hpp"
+#include "dsiterpp/state-traits.hpp"
+
+#include <array>
+
+namespace dsiterpp {
+
+/**
+ * Explicit Runge-Kutta integrator for compile-time dispatched path.
+ *
+ * Unlike RungeKuttaIterator it does not use IVariable/IRHS: state is a plain contiguous
+ * container and RHS is any callable with signature
+ *     void rhs(double time, const State& x, State& dxdt)
+ * so user code and stage loops over constexpr tableau are visible to the compiler together.
+ *
+ * Scalar type of state is taken from StateTraits, so float, long double or DoubleDouble
+ * states work the same way. Stage combinations and delta are summed in Accumulator type and
+ * rounded to state scalar on store, i.e. std::vector<float> state with double accumulator
+ * keeps memory traffic of float and rounding errors of sums of double. When Accumulator is
+ * float too, loops do not promote to double and vectorize to twice as many lanes
+ */
+template<typename Tableau, typename State, typename Accumulator = typename StateTraits<State>::value_type>
+class RungeKuttaT
+{
+public:
+    using state_type = State;
+    using tableau_type = Tableau;
+    using value_type = typename StateTraits<State>::value_type;
+    using accumulator_type = Accumulator;
+
+    int method_order() const { return Tableau::order; }
+
+    /**
+     * Calculate delta for state x at time t with step dt. Scratch buffers are reused
+     * between calls and reallocated only if state size changes
+     */
+    template<typename RHS>
+    void calculate_delta(RHS& rhs, double t, const State& x, double dt, State& delta)
+    {
+        using Traits = StateTraits<State>;
+        const size_t n = Traits::size(x);
+
+        Traits::resize_like(m_stage, x);
+        Traits::resize_like(delta, x);
+        for (size_t s = 0; s < Tableau::stages; s++)
+            Traits::resize_like(m_k[s], x);
+
+        std::array<Accumulator, Tableau::stages> m;
+        for (size_t s = 0; s < Tableau::stages; s++)
+        {
+            if (s == 0)
+            {
+                rhs(t + Tableau::c[0] * dt, x, m_k[0]);
+                continue;
+            }
+
+            for (size_t j = 0; j < s; j++)
+                m[j] = static_cast<Accumulator>(Tableau::a[s][j] * dt);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                Accumulator sum = static_cast<Accumulator>(x[i]);
+                for (size_t j = 0; j < s; j++)
+                {
+                    if (Tableau::a[s][j] != 0.0)
+                        sum += m[j] * static_cast<Accumulator>(m_k[j][i]);
+                }
+                m_stage[i] = static_cast<value_type>(sum);
+            }
+            rhs(t + Tableau::c[s] * dt, static_cast<const State&>(m_stage), m_k[s]);
+        }
+
+        for (size_t s = 0; s < Tableau::stages; s++)
+            m[s] = static_cast<Accumulator>(Tableau::b[s] * dt);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            Accumulator sum = static_cast<Accumulator>(0.0);
+            for (size_t s = 0; s < Tableau::stages; s++)
+            {
+                if (Tableau::b[s] != 0.0)
+                    sum += m[s] * static_cast<Accumulator>(m_k[s][i]);
+            }
+            delta[i] = static_cast<value_type>(sum);
+        }
+    }
+
+private:
+    std::array<State, Tableau::stages> m_k;
+    State m_stage;
+};
+
+template<typename State, typename Accumulator = typename StateTraits<State>::value_type>
+using EulerExplicitT = RungeKuttaT<EulerTableau, State, Accumulator>;
+
+template<typename State, typename Accumulator = typename StateTraits<State>::value_type>
+using RK4T = RungeKuttaT<RK4Tableau, State, Accumulator>;
+
+}
+
+#endif // RUNGE_KUTTA_T_HPP_INCLUDED
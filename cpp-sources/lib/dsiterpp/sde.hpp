@@ -0,0 +1,114 @@
+#ifndef SDE_HPP_INCLUDED
+#define SDE_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/counter-rng.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace dsiterpp {
+
+/**
+ * RHS of Ito SDE with diagonal noise dx_i = f_i(t, x) dt + g_i(t, x) dW_i.
+ * calculate_rhs() sets drift f to variables rhs, calculate_diffusion() sets diffusion g
+ * the same way
+ */
+class IStochasticRHS : public IRHS
+{
+public:
+    virtual void calculate_diffusion(double time) = 0;
+};
+
+/**
+ * Base for SDE integrators: Wiener increments are taken from NormalGenerator by step number,
+ * so recalculation of the same step uses the same noise and integrators with different
+ * streams may run ensemble members in parallel without any locks.
+ *
+ * Note: noise is not refined when step is refined, so use fixed step (no autoStepAdjustment)
+ */
+class StochasticIntegratorBase : public IIntegrator
+{
+public:
+    void set_seed(uint32_t seed, uint32_t stream = 0);
+
+    /**
+     * Number of step used to address random numbers, i.e. to continue run from checkpoint
+     */
+    void set_step_index(uint64_t step_index);
+    uint64_t step_index() const;
+
+    void step_done(double time, double dt, IteratingMetrics& metrics) override;
+
+protected:
+    static IStochasticRHS* stochastic_rhs(IRHS* rhs);
+
+    /**
+     * Make previous values of variable = x
+     */
+    static void set_state(IVariable* variable, const std::vector<double>& x);
+
+    /// f = drift(t, current values)
+    static void drift(IVariable* variable, IStochasticRHS* rhs, double t, std::vector<double>& f);
+    /// g = diffusion(t, current values)
+    static void diffusion(IVariable* variable, IStochasticRHS* rhs, double t, std::vector<double>& g);
+
+    /**
+     * Independent N(0, 1) numbers of current step, count per state component
+     */
+    void draw_normals(size_t count, std::vector<double>& normals) const;
+
+    NormalGenerator m_generator;
+    uint64_t m_step_index = 0;
+
+    mutable std::vector<double> m_x;
+    mutable std::vector<double> m_f;
+    mutable std::vector<double> m_g;
+    mutable std::vector<double> m_normals;
+    mutable std::vector<double> m_delta;
+};
+
+/**
+ * Euler-Maruyama method, strong order 0.5, weak order 1
+ */
+class EulerMaruyamaIterator : public StochasticIntegratorBase
+{
+public:
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+};
+
+/**
+ * Derivative-free Milstein type stochastic Runge-Kutta method (E. Platen) for diagonal
+ * Ito noise, strong order 1
+ */
+class StochasticRK1Iterator : public StochasticIntegratorBase
+{
+public:
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+
+private:
+    mutable std::vector<double> m_support;
+    mutable std::vector<double> m_g_support;
+};
+
+/**
+ * SRA1 stochastic Runge-Kutta method for additive noise (A. Rossler, 2010), strong order 1.5.
+ * Diffusion should not depend on state
+ */
+class SRA1Iterator : public StochasticIntegratorBase
+{
+public:
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+
+private:
+    mutable std::vector<double> m_stage;
+    mutable std::vector<double> m_f2;
+    mutable std::vector<double> m_g_end;
+};
+
+}
+
+#endif // SDE_HPP_INCLUDED
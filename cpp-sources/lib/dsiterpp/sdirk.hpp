@@ -0,0 +1,68 @@
+#ifndef SDIRK_HPP_INCLUDED
+#define SDIRK_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+#include "dsiterpp/dense-matrix.hpp"
+
+#include <functional>
+
+namespace dsiterpp {
+
+/**
+ * Two-stage L-stable singly diagonally implicit Runge-Kutta method of 2nd order
+ * (R. Alexander, 1977) for stiff problems.
+ *
+ * Stage equations are solved by Newton iterations with Jacobian calculated once per step,
+ * by finite differences or by user-defined function
+ */
+class SDIRK2Iterator : public IIntegrator
+{
+public:
+    using JacobianFunction = std::function<void(double time, const std::vector<double>& x, DenseMatrix& jacobian)>;
+
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+
+    void set_jacobian_function(JacobianFunction jacobian);
+    void set_newton_tolerance(double tolerance);
+    void set_newton_max_iterations(size_t max_iterations);
+
+private:
+    /**
+     * Calculate Jacobian at point x where f = f(t, x) and decompose I - m * J
+     */
+    void update_newton_matrix(double t, const std::vector<double>& x, const std::vector<double>& f, double m) const;
+
+    /**
+     * Solve k = f(t, base + m * k) for stage derivative k, k should contain initial guess.
+     * If Newton iterations do not converge, Jacobian is updated at stage point once
+     */
+    void solve_stage(double t, const std::vector<double>& base, double m, std::vector<double>& k) const;
+    bool newton_iterations(double t, const std::vector<double>& base, double m, std::vector<double>& k) const;
+
+    JacobianFunction m_jacobian_function;
+    double m_newton_tolerance = 1e-10;
+    size_t m_newton_max_iterations = 10;
+
+    mutable RHSEvaluator m_evaluator;
+    mutable DenseMatrix m_jacobian;
+    mutable DenseMatrix m_newton_matrix;
+    mutable LUDecomposition m_lu;
+
+    mutable std::vector<double> m_x0;
+    mutable std::vector<double> m_f0;
+    mutable std::vector<double> m_k1;
+    mutable std::vector<double> m_k2;
+    mutable std::vector<double> m_k_guess;
+    mutable std::vector<double> m_base;
+    mutable std::vector<double> m_stage;
+    mutable std::vector<double> m_f;
+    mutable std::vector<double> m_f_stage;
+    mutable std::vector<double> m_x_perturbed;
+    mutable std::vector<double> m_delta;
+};
+
+}
+
+#endif // SDIRK_HPP_INCLUDED
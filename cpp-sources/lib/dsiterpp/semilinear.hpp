@@ -0,0 +1,71 @@
+#ifndef SEMILINEAR_HPP_INCLUDED
+#define SEMILINEAR_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/sparse-matrix.hpp"
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Linear operator L given as diagonal, as sparse matrix or as matrix-vector product only
+ */
+class LinearOperator
+{
+public:
+    using MatVec = std::function<void(const std::vector<double>& x, std::vector<double>& y)>;
+
+    enum class Type
+    {
+        diagonal = 0,
+        sparse,
+        matvec
+    };
+
+    static LinearOperator diagonal(const std::vector<double>& diagonal);
+    static LinearOperator sparse(const SparseMatrix& matrix);
+    static LinearOperator matvec(MatVec matvec, size_t size);
+
+    Type type() const;
+    size_t size() const;
+
+    /**
+     * Diagonal of L for Type::diagonal only
+     */
+    const std::vector<double>& diagonal_values() const;
+
+    /**
+     * y = L x
+     */
+    void multiply(const std::vector<double>& x, std::vector<double>& y) const;
+
+private:
+    Type m_type = Type::diagonal;
+    size_t m_size = 0;
+    std::vector<double> m_diagonal;
+    SparseMatrix m_matrix;
+    MatVec m_matvec;
+};
+
+/**
+ * RHS of semilinear system x' = L x + N(t, x) with stiff linear part L.
+ * calculate_nonlinear() sets N to variables rhs the same way calculate_rhs() does,
+ * calculate_rhs() should set full L x + N to be usable by other integrators
+ */
+class ISemilinearRHS : public IRHS
+{
+public:
+    virtual void calculate_nonlinear(double time) = 0;
+
+    /**
+     * Operator L, order of components is the same as in IVariable::collect_values()
+     */
+    virtual const LinearOperator& linear_operator() = 0;
+};
+
+}
+
+#endif // SEMILINEAR_HPP_INCLUDED
@@ -0,0 +1,193 @@
+#ifndef SENSITIVITY_HPP_INCLUDED
+#define SENSITIVITY_HPP_INCLUDED
+
+#include "dsiterpp/utils.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Directional derivative of parametric RHS by finite differences:
+ *     out = J_x * s + df/dp_j ~= (f(x + eps * s, p + eps * e_j) - f(x, p)) / eps
+ * so one RHS calculation per parameter is enough and f(x, p) is shared with main system
+ */
+template<typename ParametricRHS>
+class FiniteDifferenceSensitivity
+{
+public:
+    using State = std::vector<double>;
+
+    void operator()(
+        ParametricRHS& rhs, double t, const State& x, const State& p, const State& f,
+        const State& s, size_t parameter_index, State& out
+    )
+    {
+        const double sqrt_eps = std::sqrt(std::numeric_limits<double>::epsilon());
+        double x_norm = 0.0, s_norm = 0.0;
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            x_norm = std::max(x_norm, std::fabs(x[i]));
+            s_norm = std::max(s_norm, std::fabs(s[i]));
+        }
+        double p_value = std::fabs(p[parameter_index]);
+        double direction_norm = std::max(s_norm, 1.0);
+        double eps = sqrt_eps * std::max(std::max(x_norm, p_value), 1.0) / direction_norm;
+
+        m_x = x;
+        for (size_t i = 0; i < x.size(); i++)
+            m_x[i] += eps * s[i];
+        m_p = p;
+        m_p[parameter_index] += eps;
+
+        out.resize(x.size());
+        rhs(t, static_cast<const State&>(m_x), static_cast<const State&>(m_p), out);
+        for (size_t i = 0; i < x.size(); i++)
+            out[i] = (out[i] - f[i]) / eps;
+    }
+
+private:
+    State m_x;
+    State m_p;
+};
+
+/**
+ * Forward sensitivity analysis for compile-time dispatched path.
+ *
+ * RHS of augmented system z = [x, s_1, ..., s_P] with s_j = dx/dp_j:
+ *     x'   = f(t, x, p)
+ *     s_j' = J_x(t, x, p) * s_j + df/dp_j(t, x, p)
+ * Use it as RHS of TimeIteratorT with state std::vector<double>, so sensitivities are
+ * integrated in the same stages with the main state in one run.
+ *
+ * @tparam ParametricRHS Callable void(double t, const State& x, const State& p, State& dxdt)
+ * @tparam Sensitivity   Callable calculating out = J_x * s + df/dp_j, with the same signature
+ *                       as FiniteDifferenceSensitivity::operator(). User may give analytic one
+ */
+template<typename ParametricRHS, typename Sensitivity = FiniteDifferenceSensitivity<ParametricRHS>>
+class SensitivityRHS
+{
+public:
+    using State = std::vector<double>;
+
+    SensitivityRHS(ParametricRHS rhs, size_t state_size, State parameters, Sensitivity sensitivity = Sensitivity()) :
+        m_rhs(std::move(rhs)), m_sensitivity(std::move(sensitivity)),
+        m_state_size(state_size), m_parameters(std::move(parameters))
+    {
+        // RHS and sensitivity may write components without resizing, as TimeIteratorT RHS does
+        m_x.resize(m_state_size);
+        m_s.resize(m_state_size);
+        m_f.resize(m_state_size);
+        m_ds.resize(m_state_size);
+    }
+
+    void operator()(double t, const State& z, State& dzdt)
+    {
+        const size_t n = m_state_size;
+        dzdt.resize(augmented_size());
+
+        std::copy(z.begin(), z.begin() + n, m_x.begin());
+        m_rhs(t, static_cast<const State&>(m_x), static_cast<const State&>(m_parameters), m_f);
+        std::copy(m_f.begin(), m_f.begin() + n, dzdt.begin());
+
+        for (size_t j = 0; j < m_parameters.size(); j++)
+        {
+            auto block = z.begin() + (j + 1) * n;
+            std::copy(block, block + n, m_s.begin());
+            m_sensitivity(m_rhs, t, m_x, m_parameters, m_f, m_s, j, m_ds);
+            std::copy(m_ds.begin(), m_ds.begin() + n, dzdt.begin() + (j + 1) * n);
+        }
+    }
+
+    /**
+     * Augmented state with x0 and zero sensitivities (initial state does not depend on parameters)
+     */
+    State make_initial_state(const State& x0) const
+    {
+        State z(augmented_size(), 0.0);
+        std::copy(x0.begin(), x0.end(), z.begin());
+        return z;
+    }
+
+    /**
+     * dx_i / dp_j from augmented state
+     */
+    double sensitivity(const State& z, size_t parameter_index, size_t component) const
+    {
+        return z[(parameter_index + 1) * m_state_size + component];
+    }
+
+    size_t state_size() const { return m_state_size; }
+    size_t augmented_size() const { return m_state_size * (m_parameters.size() + 1); }
+
+    State& parameters() { return m_parameters; }
+
+private:
+    ParametricRHS m_rhs;
+    Sensitivity m_sensitivity;
+    size_t m_state_size;
+    State m_parameters;
+
+    State m_x;
+    State m_s;
+    State m_f;
+    State m_ds;
+};
+
+template<typename ParametricRHS>
+SensitivityRHS<ParametricRHS> make_sensitivity_rhs(ParametricRHS rhs, size_t state_size, std::vector<double> parameters)
+{
+    return SensitivityRHS<ParametricRHS>(std::move(rhs), state_size, std::move(parameters));
+}
+
+template<typename ParametricRHS, typename Sensitivity>
+SensitivityRHS<ParametricRHS, Sensitivity> make_sensitivity_rhs(
+    ParametricRHS rhs, size_t state_size, std::vector<double> parameters, Sensitivity sensitivity
+)
+{
+    return SensitivityRHS<ParametricRHS, Sensitivity>(std::move(rhs), state_size, std::move(parameters), std::move(sensitivity));
+}
+
+/**
+ * Parametric RHS for SensitivityRHS made from interface path model (IVariable and IRHS).
+ * Parameters are doubles read by IRHS (i.e. captured by RHSScalar functions), they are set
+ * to p for every evaluation and restored after it.
+ *
+ * Every evaluation overwrites values of variable, so the state should be taken from
+ * augmented state of TimeIteratorT
+ */
+class InterfaceParametricRHS
+{
+public:
+    InterfaceParametricRHS(IVariable* variable, IRHS* rhs, std::vector<double*> parameters);
+
+    void operator()(double t, const std::vector<double>& x, const std::vector<double>& p, std::vector<double>& dxdt);
+
+    /// Current values of variable
+    std::vector<double> state();
+
+    /// Current values of parameters
+    std::vector<double> parameters() const;
+
+private:
+    void restore_parameters();
+
+    RHSEvaluator m_evaluator;
+    std::vector<double*> m_parameters;
+    std::vector<double> m_saved_parameters;
+};
+
+/**
+ * SensitivityRHS for interface path model with parameters and state size taken from it
+ */
+SensitivityRHS<InterfaceParametricRHS> make_sensitivity_rhs(IVariable* variable, IRHS* rhs, std::vector<double*> parameters);
+
+}
+
+#endif // SENSITIVITY_HPP_INCLUDED
@@ -0,0 +1,110 @@
+#ifndef SHM_METRICS_HPP_INCLUDED
+#define SHM_METRICS_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/time-iter.hpp"
+
+#include <string>
+#include <cstdint>
+
+namespace dsiterpp {
+
+/**
+ * Solver state published by SharedMetricsExporter
+ */
+struct SharedMetricsSnapshot
+{
+    double time = 0.0;
+    /// Last accepted step
+    double dt = 0.0;
+    uint64_t steps = 0;
+    uint64_t rejected_steps = 0;
+    uint64_t min_step_limitations = 0;
+    uint64_t max_step_limitations = 0;
+    uint64_t rhs_evaluations = 0;
+};
+
+/**
+ * Decorator of IRHS that counts calculate_rhs() calls for metrics export.
+ * Note: integrators that require RHS of special type (i.e. ISemilinearRHS) do not see it through decorator
+ */
+class RHSEvaluationCounter : public IRHS
+{
+public:
+    RHSEvaluationCounter(IRHS* rhs);
+
+    void pre_iteration_job(double time) override;
+    void pre_sub_iteration_job(double time) override;
+    void calculate_rhs(double time) override;
+
+    uint64_t evaluations_count() const;
+
+private:
+    IRHS* m_rhs;
+    uint64_t m_evaluations_count = 0;
+};
+
+/**
+ * Publishes metrics of TimeIterator to POSIX shared memory segment for external monitoring.
+ * Segment is protected by seqlock: writer never waits and makes a few stores per step,
+ * reader retries if it catches the segment in the middle of update.
+ * Set to TimeIterator by set_metrics_exporter(). Segment is removed by destructor
+ */
+class SharedMetricsExporter
+{
+public:
+    /**
+     * Throws if segment with this name already exists
+     * @param name Segment name like "/my-model-metrics"
+     */
+    SharedMetricsExporter(const std::string& name);
+    ~SharedMetricsExporter();
+
+    SharedMetricsExporter(const SharedMetricsExporter&) = delete;
+    SharedMetricsExporter& operator=(const SharedMetricsExporter&) = delete;
+
+    void set_rhs_counter(const RHSEvaluationCounter* counter);
+
+    /**
+     * Called from stepping thread after every step
+     */
+    void publish(double time, double dt, const IteratingMetrics& metrics);
+
+    const std::string& name() const;
+
+private:
+    friend class SharedMetricsReader;
+    struct Layout;
+
+    std::string m_name;
+    Layout* m_layout = nullptr;
+    const RHSEvaluationCounter* m_rhs_counter = nullptr;
+    uint64_t m_sequence = 0;
+    uint64_t m_steps = 0;
+};
+
+/**
+ * Read-only view of segment created by SharedMetricsExporter, may be used from other process
+ */
+class SharedMetricsReader
+{
+public:
+    SharedMetricsReader(const std::string& name);
+    ~SharedMetricsReader();
+
+    SharedMetricsReader(const SharedMetricsReader&) = delete;
+    SharedMetricsReader& operator=(const SharedMetricsReader&) = delete;
+
+    /**
+     * Take consistent snapshot
+     * @return false if writer was updating segment during all attempts
+     */
+    bool read(SharedMetricsSnapshot& snapshot, size_t max_attempts = 1000) const;
+
+private:
+    const void* m_layout = nullptr;
+};
+
+}
+
+#endif // SHM_METRICS_HPP_INCLUDED
@@ -0,0 +1,96 @@
+#ifndef SPARSE_JACOBIAN_HPP_INCLUDED
+#define SPARSE_JACOBIAN_HPP_INCLUDED
+
+#include "dsiterpp/sparse-matrix.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+#include "dsiterpp/bdf.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Finite difference Jacobian of IRHS with known sparsity.
+ *
+ * Columns without common non-zero rows are grouped by greedy coloring and perturbed together,
+ * so Jacobian costs number of colors RHS calculations instead of system size. Pattern is
+ * declared by user or detected once by probing every column
+ */
+class SparseJacobian
+{
+public:
+    void set_target(IVariable* variable, IRHS* rhs);
+
+    void set_pattern(const SparsityPattern& pattern);
+
+    /**
+     * Detect pattern at point (t, x) by perturbing columns one by one (size + 1 RHS calculations)
+     */
+    void detect_pattern(double t, const std::vector<double>& x);
+
+    /**
+     * Calculate Jacobian at point (t, x). Variable values are changed
+     */
+    void update(double t, const std::vector<double>& x);
+
+    const SparseMatrix& matrix() const;
+    const SparsityPattern& pattern() const;
+    bool has_pattern() const;
+
+    size_t colors_count() const;
+    size_t column_color(size_t col) const;
+
+    /**
+     * RHS calculations done for updates and detection
+     */
+    size_t evaluations_count();
+
+private:
+    void color_columns();
+
+    RHSEvaluator m_evaluator;
+    SparseMatrix m_matrix;
+    bool m_has_pattern = false;
+
+    // Transposed pattern: for every column its rows and indexes of values in CSR
+    std::vector<size_t> m_col_offsets;
+    std::vector<size_t> m_col_rows;
+    std::vector<size_t> m_col_value_index;
+
+    std::vector<size_t> m_colors;
+    std::vector<std::vector<size_t>> m_color_columns;
+
+    std::vector<double> m_f;
+    std::vector<double> m_perturbed;
+    std::vector<double> m_f_perturbed;
+    std::vector<double> m_steps;
+};
+
+/**
+ * Preconditioner for BDFIterator: ILU(0) of I - gamma * J with sparse finite difference J.
+ * Jacobian is kept when only gamma changes and recalculated when Newton convergence degrades
+ */
+class ILU0Preconditioner : public IPreconditioner
+{
+public:
+    ILU0Preconditioner(IVariable* variable, IRHS* rhs);
+
+    void setup(double t, const std::vector<double>& x, double gamma) override;
+    void apply(const std::vector<double>& r, std::vector<double>& z) override;
+    void jacobian_outdated() override;
+
+    SparseJacobian& jacobian();
+    size_t jacobian_updates_count() const;
+
+private:
+    SparseJacobian m_jacobian;
+    SparseMatrix m_newton_matrix;
+    ILU0Decomposition m_ilu;
+    bool m_jacobian_outdated = true;
+    size_t m_jacobian_updates = 0;
+};
+
+}
+
+#endif // SPARSE_JACOBIAN_HPP_INCLUDED
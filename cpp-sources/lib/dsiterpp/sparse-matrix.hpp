@@ -0,0 +1,84 @@
+#ifndef SPARSE_MATRIX_HPP_INCLUDED
+#define SPARSE_MATRIX_HPP_INCLUDED
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Structure of square sparse matrix in compressed sparse row (CSR) format,
+ * columns are sorted inside every row
+ */
+struct SparsityPattern
+{
+    static SparsityPattern from_entries(size_t size, std::vector<std::pair<size_t, size_t>> entries);
+
+    /**
+     * Add diagonal entries if absent
+     */
+    void add_diagonal();
+
+    size_t nonzeros_count() const;
+
+    /**
+     * Index of (row, col) in values array or nonzeros_count() if absent
+     */
+    size_t find(size_t row, size_t col) const;
+
+    size_t size = 0;
+    std::vector<size_t> row_offsets;
+    std::vector<size_t> columns;
+};
+
+class SparseMatrix
+{
+public:
+    void set_pattern(const SparsityPattern& pattern);
+
+    const SparsityPattern& pattern() const;
+    std::vector<double>& values();
+    const std::vector<double>& values() const;
+
+    /**
+     * Value of element, zero for elements out of pattern
+     */
+    double get(size_t row, size_t col) const;
+
+    /**
+     * y = A * x
+     */
+    void multiply(const std::vector<double>& x, std::vector<double>& y) const;
+
+private:
+    SparsityPattern m_pattern;
+    std::vector<double> m_values;
+};
+
+/**
+ * Incomplete LU decomposition without fill-in, L and U have pattern of matrix.
+ * Pattern should contain diagonal
+ */
+class ILU0Decomposition
+{
+public:
+    /**
+     * Throws std::runtime_error on zero pivot
+     */
+    void decompose(const SparseMatrix& matrix);
+
+    /**
+     * x = (LU)^-1 b
+     */
+    void solve(const std::vector<double>& b, std::vector<double>& x) const;
+
+private:
+    SparseMatrix m_lu;
+    std::vector<size_t> m_diagonal;
+    std::vector<size_t> m_positions;
+};
+
+}
+
+#endif // SPARSE_MATRIX_HPP_INCLUDED
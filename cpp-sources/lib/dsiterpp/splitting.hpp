@@ -0,0 +1,64 @@
+#ifndef SPLITTING_HPP_INCLUDED
+#define SPLITTING_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/time-iter.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace dsiterpp {
+
+enum class SplittingScheme
+{
+    lie = 0,
+    strang
+};
+
+/**
+ * Operator splitting for x' = f_1(t, x) + ... + f_n(t, x). Each operator f_i is integrated
+ * by its own integrator with its own number of substeps, and flows are composed:
+ *     Lie:    x+ = F_n(dt) ... F_1(dt) x, 1st order
+ *     Strang: x+ = F_1(dt/2) ... F_{n-1}(dt/2) F_n(dt) F_{n-1}(dt/2) ... F_1(dt/2) x, 2nd order
+ *
+ * RHS given to calculate_delta() is not used, operators keep their RHSs. Operator RHS
+ * should set rhs of the same variables every time it is called, rhs of other variables is
+ * cleared before operator is integrated
+ */
+class SplittingIterator : public IIntegrator
+{
+public:
+    void add_operator(IRHS* rhs, IIntegrator* integrator, size_t substeps = 1);
+    void set_scheme(SplittingScheme scheme);
+
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+
+    /**
+     * Order of composition limited by orders of operator integrators
+     */
+    int method_order() const override final;
+
+private:
+    struct Operator
+    {
+        IRHS* rhs;
+        IIntegrator* integrator;
+        size_t substeps;
+    };
+
+    /**
+     * Advance previous values of variable by flow of operator from t to t + dt
+     */
+    void advance(IVariable* variable, const Operator& op, double t, double dt) const;
+
+    std::vector<Operator> m_operators;
+    SplittingScheme m_scheme = SplittingScheme::strang;
+
+    mutable IteratingMetrics m_substep_metrics;
+    mutable std::vector<double> m_x0;
+    mutable std::vector<double> m_x1;
+};
+
+}
+
+#endif // SPLITTING_HPP_INCLUDED
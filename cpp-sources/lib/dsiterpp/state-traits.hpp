@@ -0,0 +1,48 @@
+#ifndef STATE_TRAITS_HPP_INCLUDED
+#define STATE_TRAITS_HPP_INCLUDED
+
+#include <array>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Adapter between template integrators and a contiguous state container.
+ * Default implementation fits any resizable random access container like std::vector
+ */
+template<typename State>
+struct StateTraits
+{
+    using value_type = typename State::value_type;
+
+    static size_t size(const State& state) { return state.size(); }
+
+    /**
+     * Make scratch buffer the same size as reference state. Allocates only when size changes
+     */
+    static void resize_like(State& state, const State& reference)
+    {
+        if (state.size() != reference.size())
+            state.resize(reference.size());
+    }
+};
+
+/**
+ * Fixed-size state: dimension is known at compile time, so loops over state unroll
+ * and no heap allocation is ever done
+ */
+template<typename T, size_t N>
+struct StateTraits<std::array<T, N>>
+{
+    using value_type = T;
+
+    static constexpr size_t size(const std::array<T, N>&) { return N; }
+    static void resize_like(std::array<T, N>&, const std::array<T, N>&) {}
+};
+
+template<size_t N, typename T = double>
+using FixedState = std::array<T, N>;
+
+}
+
+#endif // STATE_TRAITS_HPP_INCLUDED
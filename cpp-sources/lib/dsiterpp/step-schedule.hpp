@@ -0,0 +1,65 @@
+#ifndef STEP_SCHEDULE_HPP_INCLUDED
+#define STEP_SCHEDULE_HPP_INCLUDED
+
+#include <vector>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+
+namespace dsiterpp {
+
+/**
+ * Sequence of time steps for TimeIterator replay mode.
+ *
+ * Steps are stored exactly (bitwise), repeated steps are run-length encoded: adaptive
+ * runs usually have long series of equal steps, i.e. at max_step_limit
+ */
+class StepSchedule
+{
+public:
+    static StepSchedule from_log(const std::vector<double>& time_steps_log);
+
+    void add_step(double dt);
+    void clear();
+
+    /**
+     * Total count of steps
+     */
+    size_t size() const;
+
+    /**
+     * Count of stored runs of equal steps
+     */
+    size_t runs_count() const;
+
+    /**
+     * Start reading steps from the beginning
+     */
+    void rewind();
+
+    /**
+     * Get next step
+     * @return false if schedule is finished
+     */
+    bool next_step(double& dt);
+
+    bool is_finished() const;
+
+    /**
+     * Binary serialization. Throws std::runtime_error on load of invalid data
+     */
+    void save(std::ostream& stream) const;
+    void load(std::istream& stream);
+
+private:
+    std::vector<double> m_steps;
+    std::vector<uint32_t> m_repeats;
+    size_t m_size = 0;
+
+    size_t m_current_run = 0;
+    uint32_t m_current_repeat = 0;
+};
+
+}
+
+#endif // STEP_SCHEDULE_HPP_INCLUDED
@@ -0,0 +1,90 @@
+#ifndef STIFFNESS_SWITCHING_HPP_INCLUDED
+#define STIFFNESS_SWITCHING_HPP_INCLUDED
+
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/rhs-evaluator.hpp"
+
+#include <cstddef>
+
+namespace dsiterpp {
+
+struct StiffnessDetectionParameters
+{
+    /// Stability region size of non-stiff method on negative real axis: 2.0 for explicit Euler, 2.78 for RK4
+    double stability_limit = 2.5;
+
+    /// Non-stiff method is stability-limited when |lambda_max| * dt > stiff_threshold * stability_limit.
+    /// Error estimators usually hold step noticeably below stability limit, so value is not close to 1
+    double stiff_threshold = 0.5;
+
+    /// Stiff method is replaced when |lambda_max| * dt < non_stiff_threshold * stability_limit
+    double non_stiff_threshold = 0.2;
+
+    /// Accepted steps between dominant eigenvalue estimations
+    size_t check_period = 10;
+
+    /// Power iterations per estimation, each costs one RHS calculation
+    size_t power_iterations = 3;
+
+    /// Consecutive estimations needed to switch method
+    size_t switch_confirmations = 2;
+
+    /// Steps throttled by min_step_limit in a row that switch to stiff method without estimation
+    size_t min_step_limitations_to_switch = 5;
+};
+
+/**
+ * Integrator that uses non-stiff (explicit) method while problem allows and moves to stiff
+ * (implicit) method when steps become stability-limited (LSODA-like).
+ *
+ * Dominant eigenvalue of RHS Jacobian is estimated on accepted steps by power iterations
+ * with finite differences. Switches are logged to IteratingMetrics::integrator_switches
+ */
+class StiffnessSwitchingIterator : public IIntegrator
+{
+public:
+    StiffnessSwitchingIterator(IIntegrator* non_stiff, IIntegrator* stiff);
+
+    void calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const override final;
+    int method_order() const override final;
+    void step_done(double time, double dt, IteratingMetrics& metrics) override final;
+
+    StiffnessDetectionParameters& parameters();
+    bool is_stiff_mode() const;
+
+    /**
+     * Last estimation of |lambda_max|
+     */
+    double dominant_eigenvalue() const;
+
+private:
+    IIntegrator* active() const;
+    double estimate_dominant_eigenvalue(double time);
+    void switch_method(double time, double stiffness, IteratingMetrics& metrics);
+
+    IIntegrator* m_non_stiff;
+    IIntegrator* m_stiff;
+    bool m_stiff_mode = false;
+
+    StiffnessDetectionParameters m_parameters;
+
+    size_t m_steps_since_check = 0;
+    size_t m_confirmations = 0;
+    size_t m_limited_steps = 0;
+    size_t m_last_min_step_limitations = 0;
+    double m_dominant_eigenvalue = 0.0;
+
+    mutable IVariable* m_variable = nullptr;
+    mutable IRHS* m_rhs = nullptr;
+
+    RHSEvaluator m_evaluator;
+    std::vector<double> m_x;
+    std::vector<double> m_f;
+    std::vector<double> m_perturbed;
+    std::vector<double> m_f_perturbed;
+    std::vector<double> m_direction;
+};
+
+}
+
+#endif // STIFFNESS_SWITCHING_HPP_INCLUDED
@@ -0,0 +1,108 @@
+#ifndef THREAD_POOL_HPP_INCLUDED
+#define THREAD_POOL_HPP_INCLUDED
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Fixed set of worker threads for fork-join parallelism inside one integration step.
+ * Calling thread takes part in execution too, so pool of N threads has N-1 workers
+ */
+class ThreadPool
+{
+public:
+    using Task = std::function<void(size_t index)>;
+
+    ThreadPool(size_t threads_count = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Run task(0), ..., task(count-1) in parallel and wait for all of them.
+     * Tasks are taken in index order. Exception from task is rethrown in calling thread
+     */
+    void parallel_for(size_t count, const Task& task);
+
+    size_t threads_count() const;
+
+private:
+    void worker();
+    void run_available_tasks();
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_task_ready;
+    std::condition_variable m_task_done;
+
+    const Task* m_task = nullptr;
+    size_t m_count = 0;
+    size_t m_next_index = 0;
+    size_t m_unfinished = 0;
+    size_t m_generation = 0;
+    bool m_stop = false;
+    std::exception_ptr m_exception;
+};
+
+/**
+ * Worker threads pinned to CPUs with static assignment of tasks: task with index i always
+ * runs on worker i, so memory first touched by worker i stays local to its NUMA node and
+ * is used from the same core later. Calling thread only waits
+ */
+class PinnedThreadPool
+{
+public:
+    using Task = std::function<void(size_t index)>;
+
+    /**
+     * Worker i is pinned to cpus[i]. If cpus is empty, worker i is pinned to CPU
+     * i modulo hardware concurrency
+     */
+    PinnedThreadPool(size_t threads_count, const std::vector<int>& cpus = std::vector<int>());
+    ~PinnedThreadPool();
+
+    PinnedThreadPool(const PinnedThreadPool&) = delete;
+    PinnedThreadPool& operator=(const PinnedThreadPool&) = delete;
+
+    /**
+     * Run task(i) on worker i for every worker and wait for all of them.
+     * Exception from task is rethrown in calling thread
+     */
+    void run_on_each(const Task& task);
+
+    size_t threads_count() const;
+
+    /**
+     * Pinning may be forbidden (i.e. by cgroup cpuset), then workers run unpinned
+     */
+    bool is_pinned() const;
+
+private:
+    void worker(size_t index, int cpu);
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex m_mutex;
+    std::condition_variable m_task_ready;
+    std::condition_variable m_task_done;
+
+    const Task* m_task = nullptr;
+    size_t m_unfinished = 0;
+    size_t m_generation = 0;
+    size_t m_pinned_count = 0;
+    bool m_stop = false;
+    std::exception_ptr m_exception;
+};
+
+}
+
+#endif // THREAD_POOL_HPP_INCLUDED
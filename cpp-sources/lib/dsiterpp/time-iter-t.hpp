@@ -0,0 +1,228 @@
+#ifndef TIME_ITER_T_HPP_INCLUDED
+#define TIME_ITER_T_HPP_INCLUDED
+
+#include "dsiterpp/utils.hpp"
+#include "dsiterpp/state-traits.hpp"
+#include "dsiterpp/runge-error-estimator-t.hpp"
+#include "dsiterpp/time-iter.hpp"
+
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Header-only time iterator for compile-time dispatched path.
+ *
+ * Works side by side with TimeIterator, but integrator, state and RHS are template
+ * parameters, so there are no virtual calls and no std::function between the iterator,
+ * integrator stages and user RHS code.
+ *
+ * @tparam Integrator  Integrator like RungeKuttaT<RK4Tableau, State>
+ * @tparam State       Contiguous state container (see StateTraits)
+ * @tparam RHS         Callable void(double time, const State& x, State& dxdt)
+ * @tparam ErrorEstimator Estimator used when step_adj_pars().autoStepAdjustment is set
+ *
+ * Note: time_steps_log of metrics() is not filled to keep stepping free of allocations
+ */
+template<typename Integrator, typename State, typename RHS, typename ErrorEstimator = RungeErrorEstimatorT<Integrator>>
+class TimeIteratorT
+{
+public:
+    static_assert(
+        std::is_same<typename Integrator::state_type, State>::value,
+        "TimeIteratorT: Integrator should be instantiated with the same State"
+    );
+
+    TimeIteratorT(const State& initial_state, RHS rhs) :
+        m_rhs(std::move(rhs)), m_state(initial_state)
+    {
+        StateTraits<State>::resize_like(m_delta, m_state);
+    }
+
+    void set_time(double time) { m_time = time; m_time_compensation = 0.0; }
+    void set_stop_time(double stop_time) { m_stop_time = stop_time; }
+    void set_step(double dt) { m_dt = dt; }
+
+    double get_time() const { return m_time; }
+    double get_stop_time() const { return m_stop_time; }
+    double get_step() const { return m_dt; }
+
+    bool is_done() const { return m_time >= m_stop_time; }
+
+    State& state() { return m_state; }
+    const State& state() const { return m_state; }
+
+    Integrator& integrator() { return m_integrator; }
+    ErrorEstimator& error_estimator() { return m_estimator; }
+    RHS& rhs() { return m_rhs; }
+
+    StepAdjustmentParameters& step_adj_pars() { return m_step_adj_pars; }
+
+    const IteratingMetrics& metrics() const { return m_metrics; }
+    void reset_metrics() { m_metrics.reset(); }
+
+    /**
+     * Compensated (Kahan) summation of state and time updates. Rounding error of
+     * x + delta is kept and added to next delta, so long runs with deltas much smaller
+     * than state do not drift. Stays correct with -ffast-math. Compensation is reset
+     * when mode is switched and by set_time()
+     */
+    void set_compensated_summation(bool enabled)
+    {
+        m_compensated = enabled;
+        m_time_compensation = 0.0;
+        if (!enabled)
+            return;
+
+        StateTraits<State>::resize_like(m_compensation, m_state);
+        StateTraits<State>::resize_like(m_compensated_sum, m_state);
+        const size_t n = StateTraits<State>::size(m_state);
+        for (size_t i = 0; i < n; i++)
+            m_compensation[i] = 0.0;
+    }
+
+    bool is_compensated_summation() const { return m_compensated; }
+
+    void iterate()
+    {
+        double next_dt = integrate_iteration();
+
+        if (m_compensated)
+        {
+            add_delta_compensated();
+        } else {
+            const size_t n = StateTraits<State>::size(m_state);
+            for (size_t i = 0; i < n; i++)
+                m_state[i] += m_delta[i];
+
+            m_time += m_dt;
+        }
+        m_dt = next_dt;
+    }
+
+    void run()
+    {
+        m_need_stop = false;
+        while (!is_done() && !m_need_stop)
+            iterate();
+    }
+
+    /**
+     * Stop after current iteration
+     */
+    void stop() { m_need_stop = true; }
+
+private:
+    void add_delta_compensated()
+    {
+        // Kahan summation where every operation has two stored operands hidden from optimizer,
+        // otherwise with -ffast-math (sum - x) - y is reassociated to sum - (x + y) that is zero.
+        // Loops are still vectorized
+        const size_t n = StateTraits<State>::size(m_state);
+        for (size_t i = 0; i < n; i++)
+            m_compensation[i] = m_delta[i] - m_compensation[i];
+        fp_memory_barrier(&m_compensation);
+
+        for (size_t i = 0; i < n; i++)
+            m_compensated_sum[i] = m_state[i] + m_compensation[i];
+        fp_memory_barrier(&m_compensated_sum);
+
+        // State keeps rounded increment sum - x until the end
+        for (size_t i = 0; i < n; i++)
+            m_state[i] = m_compensated_sum[i] - m_state[i];
+        fp_memory_barrier(&m_state);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            m_compensation[i] = m_state[i] - m_compensation[i];
+            m_state[i] = m_compensated_sum[i];
+        }
+
+        const double dt = fp_barrier(m_dt - m_time_compensation);
+        const double time = fp_barrier(m_time + dt);
+        m_time_compensation = fp_barrier(time - m_time) - dt;
+        m_time = time;
+    }
+
+    /**
+     * Calculate m_delta with step adjusting. Timestep (m_dt) may be changed
+     * @return time step for NEXT iteration
+     */
+    double integrate_iteration()
+    {
+        const State& x = m_state;
+        if (!m_step_adj_pars.autoStepAdjustment)
+        {
+            m_integrator.calculate_delta(m_rhs, m_time, x, m_dt, m_delta);
+            return m_dt;
+        }
+
+        double next_dt = m_dt;
+        bool error_is_ok = false;
+        do {
+            const IntegrationError& error = m_estimator.calculate_delta_and_estimate(m_integrator, m_rhs, m_time, x, m_dt, m_delta);
+            error_is_ok = error.max_rel_error < m_step_adj_pars.relative_deconvergence_speed_max * m_dt;
+            if (!error_is_ok)
+            {
+                m_dt *= m_step_adj_pars.step_refining_factor;
+                next_dt = m_dt;
+                if (m_dt < m_step_adj_pars.min_step_limit)
+                {
+                    // throttling
+                    m_dt = m_step_adj_pars.min_step_limit;
+                    next_dt = m_dt;
+                    m_metrics.min_step_limitations++;
+                    m_estimator.calculate_delta_and_estimate(m_integrator, m_rhs, m_time, x, m_dt, m_delta);
+                    break;
+                }
+            }
+
+            if (error.max_rel_error < m_step_adj_pars.relative_deconvergence_speed_min * m_dt)
+            {
+                next_dt = m_dt * m_step_adj_pars.step_coarsening_factor;
+                if (next_dt > m_step_adj_pars.max_step_limit)
+                {
+                    next_dt = m_step_adj_pars.max_step_limit;
+                    m_metrics.max_step_limitations++;
+                }
+            }
+        } while (!error_is_ok);
+        return next_dt;
+    }
+
+    Integrator m_integrator;
+    ErrorEstimator m_estimator;
+    RHS m_rhs;
+
+    State m_state;
+    State m_delta;
+    State m_compensation;
+    State m_compensated_sum;
+
+    double m_time = 0.0;
+    double m_time_compensation = 0.0;
+    bool m_compensated = false;
+    double m_stop_time = 1.0;
+    double m_dt = 0.01;
+    bool m_need_stop = false;
+
+    StepAdjustmentParameters m_step_adj_pars;
+    IteratingMetrics m_metrics;
+};
+
+/**
+ * Helper to deduce RHS type of lambdas:
+ *     using State = std::vector<double>;
+ *     auto it = make_time_iterator_t<RK4T<State>>(x0, [](double t, const State& x, State& f) { ... });
+ */
+template<typename Integrator, typename State, typename RHS>
+TimeIteratorT<Integrator, State, RHS> make_time_iterator_t(const State& initial_state, RHS rhs)
+{
+    return TimeIteratorT<Integrator, State, RHS>(initial_state, std::move(rhs));
+}
+
+}
+
+#endif // TIME_ITER_T_HPP_INCLUDED
@@ -2,20 +2,23 @@
 #define TIME_ITER_HPP
 
 #include "utils.hpp"
+#include "integration.hpp"
 
 #include <vector>
 #include <functional>
 #include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
 #include <cstddef>
 #include <cmath>
 
 namespace dsiterpp {
 
 class IErrorEstimator;
-class IVariable;
-class IRHS;
-class IIntegrator;
 class IBifurcator;
+class StepSchedule;
+class SharedMetricsExporter;
 
 struct StepAdjustmentParameters
 {
@@ -30,6 +33,34 @@ struct StepAdjustmentParameters
 
     double step_refining_factor = 0.5;
     double step_coarsening_factor = 1.5;
+
+    /**
+     * Estimate first time step from RHS at start time and one trial Euler step (Hairer-Wanner)
+     * instead of using value given to set_step(). Works only with autoStepAdjustment
+     */
+    bool auto_initial_step = false;
+
+    /**
+     * If bifurcation changes some state component relatively more than this value,
+     * initial step is estimated again. Used only with auto_initial_step
+     */
+    double initial_step_reestimation_threshold = 0.1;
+
+    /**
+     * Allowed part of error per step for estimated initial step
+     */
+    double initial_step_safety_factor = 1.0;
+};
+
+/**
+ * Record about integration method change, i.e. by StiffnessSwitchingIterator
+ */
+struct IntegratorSwitch
+{
+    double time = 0.0;
+    /// Estimation of |lambda_max| * dt at the moment of switch
+    double stiffness = 0.0;
+    bool to_stiff = false;
 };
 
 struct IteratingMetrics
@@ -40,6 +71,9 @@ struct IteratingMetrics
     std::vector<double> time_steps_log;
     size_t max_step_limitations = 0;
     size_t min_step_limitations = 0;
+    size_t rejected_steps = 0;
+    size_t initial_step_estimations = 0;
+    std::vector<IntegratorSwitch> integrator_switches;
 };
 
 class ITimeHook
@@ -50,6 +84,40 @@ public:
     virtual double get_next_time() = 0;
 };
 
+/**
+ * Observer of accepted steps that may also restrict step size,
+ * i.e. history of delay differential equations
+ */
+class IStepObserver
+{
+public:
+    virtual ~IStepObserver() {}
+
+    /**
+     * Called before first step and after every accepted step, variable has values for time
+     */
+    virtual void step_accepted(double time) = 0;
+
+    /**
+     * Step started at time should not cross returned time (i.e. derivative discontinuity).
+     * Step is shortened to end exactly at it
+     */
+    virtual double next_breakpoint(double time) { DSITERPP_UNUSED(time); return std::numeric_limits<double>::infinity(); }
+};
+
+/**
+ * Compile-time policy for TimeIterator::advance_n() and advance_to()
+ * @tparam Integrator Exact type of integrator, so its final calculate_delta() is called
+ *                    without virtual dispatch. IIntegrator fits any integrator
+ * @tparam LogSteps   Fill metrics().time_steps_log
+ */
+template<typename Integrator = IIntegrator, bool LogSteps = true>
+struct FixedStepPolicy
+{
+    using integrator_type = Integrator;
+    static constexpr bool log_steps = LogSteps;
+};
+
 class TimeHookPeriodic : public ITimeHook
 {
 public:
@@ -97,6 +165,24 @@ public:
     void set_error_estimator(IErrorEstimator* estimator);
     void set_bifurcator(IBifurcator* bifurcator);
 
+    /**
+     * Replay mode: integrate with exact steps from schedule (i.e. recorded from
+     * metrics().time_steps_log) without error estimation. Iterating is done when
+     * schedule is finished. Set nullptr to return to normal mode
+     */
+    void set_replay_schedule(StepSchedule* schedule);
+
+    /**
+     * Observer is notified about accepted steps and may limit steps by its breakpoints
+     * (not in replay mode). Set nullptr to disable
+     */
+    void set_step_observer(IStepObserver* observer);
+
+    /**
+     * Exporter gets time, step and metrics after every step. Set nullptr to disable
+     */
+    void set_metrics_exporter(SharedMetricsExporter* exporter);
+
     StepAdjustmentParameters& step_adj_pars();
 
     void set_time(double time);
@@ -114,9 +200,29 @@ public:
     void iterate();
     void run();
 
+    /**
+     * Batch stepping for fixed step runs: make steps number of iterations or iterate until
+     * time >= stop_time. Checks are done once and steps between hooks and bifurcations
+     * run in tight loop, result is the same as with iterate().
+     * If step adjustment, replay mode or step observer is used, iterate() is called instead
+     * @return Count of steps done
+     */
+    template<typename Policy = FixedStepPolicy<>>
+    size_t advance_n(size_t steps);
+
+    template<typename Policy = FixedStepPolicy<>>
+    size_t advance_to(double stop_time);
+
     const IteratingMetrics& metrics();
     void reset_metrics();
 
+    /**
+     * metrics().time_steps_log is filled when enabled (default). Growing log allocates memory,
+     * so for allocation-free stepping disable it or reserve place for expected steps count
+     */
+    void set_steps_logging(bool enabled);
+    void reserve_steps_log(size_t steps);
+
     /**
      * Stop after current iteration. May be called from another thread
      */
@@ -129,8 +235,26 @@ private:
      */
     double integrate_iteration();
     void bifurcate_iteration();
+
+    /**
+     * Period check only, bifurcator presence is checked by caller
+     */
+    bool is_bifurcation_period_elapsed() const
+    {
+        return m_bifurcationPeriod == 0.0 || m_time - m_lastBifurcationTime >= m_bifurcationPeriod;
+    }
+
+    double estimate_initial_step();
+    bool is_initial_step_estimation_enabled();
+    double relative_state_change(const std::vector<double>& before, const std::vector<double>& after);
     void call_hook();
     void find_next_hook();
+    double next_hook_time();
+    bool is_fast_path_applicable();
+    void publish_metrics();
+
+    template<typename Policy>
+    size_t advance(size_t max_steps, double stop_time);
 
     void assert_pointers_are_set();
 
@@ -144,6 +268,9 @@ private:
     double m_nextHookTime = 0;
     size_t m_nextHook = 0;
     bool m_needStop = false;
+    bool m_initial_step_pending = true;
+    bool m_step_observer_started = false;
+    bool m_log_steps = true;
 
     StepAdjustmentParameters m_step_adj_pars;
 
@@ -152,11 +279,80 @@ private:
     IIntegrator* m_continiousIterator = nullptr;
     IErrorEstimator* m_estimator = nullptr;
     IBifurcator* m_bifurcationIterable = nullptr;
+    StepSchedule* m_replay_schedule = nullptr;
+    IStepObserver* m_step_observer = nullptr;
+    SharedMetricsExporter* m_metrics_exporter = nullptr;
 
     std::vector<ITimeHook*> m_timeHooks;
     IteratingMetrics m_metrics;
+
+    // Hooks ready to be called, reused between steps
+    std::vector<std::pair<double, ITimeHook*>> m_due_hooks;
+
+    // Scratch buffers for initial step estimation
+    std::vector<double> m_initial_values;
+    std::vector<double> m_initial_rhs;
+    std::vector<double> m_trial_rhs;
+    std::vector<double> m_bifurcated_values;
 };
 
+template<typename Policy>
+size_t TimeIterator::advance_n(size_t steps)
+{
+    return advance<Policy>(steps, std::numeric_limits<double>::infinity());
+}
+
+template<typename Policy>
+size_t TimeIterator::advance_to(double stop_time)
+{
+    return advance<Policy>(std::numeric_limits<size_t>::max(), stop_time);
+}
+
+template<typename Policy>
+size_t TimeIterator::advance(size_t max_steps, double stop_time)
+{
+    using Integrator = typename Policy::integrator_type;
+
+    assert_pointers_are_set();
+    const Integrator* integrator = dynamic_cast<const Integrator*>(m_continiousIterator);
+    if (integrator == nullptr)
+        throw std::logic_error("TimeIterator: integrator type does not match advance policy");
+
+    m_needStop = false;
+    size_t steps = 0;
+    while (steps < max_steps && m_time < stop_time && !m_needStop)
+    {
+        if (is_fast_path_applicable())
+        {
+            // Until limit no hooks are due. Bifurcation is checked exactly as iterate() does
+            double limit = std::min(stop_time, next_hook_time());
+            const bool has_bifurcator = m_bifurcationIterable != nullptr;
+            while (m_time < limit && steps < max_steps && !m_needStop
+                   && !(has_bifurcator && is_bifurcation_period_elapsed()))
+            {
+                m_variable->clear_subiteration();
+                integrator->calculate_delta(m_variable, m_rhs, m_time, m_dt);
+                m_variable->step();
+                m_continiousIterator->step_done(m_time, m_dt, m_metrics);
+                if (Policy::log_steps && m_log_steps)
+                    m_metrics.time_steps_log.push_back(m_dt);
+                m_time += m_dt;
+                if (m_metrics_exporter)
+                    publish_metrics();
+                steps++;
+            }
+        }
+
+        // Step with due hook or bifurcation is done in usual way
+        if (steps < max_steps && m_time < stop_time && !m_needStop)
+        {
+            iterate();
+            steps++;
+        }
+    }
+    return steps;
+}
+
 class PeriodicStopHook : public TimeHookPeriodic
 {
 public:
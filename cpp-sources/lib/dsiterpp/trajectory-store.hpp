@@ -0,0 +1,164 @@
+#ifndef TRAJECTORY_STORE_HPP_INCLUDED
+#define TRAJECTORY_STORE_HPP_INCLUDED
+
+#include "dsiterpp/time-iter.hpp"
+
+#include <vector>
+#include <deque>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * Compressed storage of trajectory snapshots (time and state values).
+ *
+ * Every value is predicted by linear extrapolation of two previous values of the same
+ * component and XOR of bit patterns of prediction and value is stored as in Gorilla time
+ * series database: zero XOR takes 1 bit, otherwise only meaningful bits between leading
+ * and trailing zeros are stored. Snapshots are grouped into chunks compressed independently
+ * by background thread, chunk index by time gives random access.
+ *
+ * By default compression is lossless, that gives gain only for slowly changing components.
+ * With mantissa_bits < 52 state values are truncated to that many mantissa bits (relative
+ * error below 2^-mantissa_bits) and smooth trajectories shrink 5-20 times. Time is always lossless
+ */
+class TrajectoryStore
+{
+public:
+    /**
+     * Streaming reader, decompresses one snapshot per next() call
+     */
+    class Cursor
+    {
+    public:
+        /**
+         * @return false if there are no more snapshots
+         */
+        bool next(double& time, std::vector<double>& state);
+
+    private:
+        friend class TrajectoryStore;
+
+        struct ComponentDecoder
+        {
+            uint64_t previous[2] = {0, 0};
+            size_t seen = 0;
+            unsigned leading = 0;
+            unsigned trailing = 0;
+        };
+
+        Cursor(TrajectoryStore* store, size_t chunk, double from_time);
+
+        bool load_chunk(size_t chunk);
+        uint64_t read_bits(unsigned count);
+        double decode(ComponentDecoder& decoder, uint64_t mask);
+
+        TrajectoryStore* m_store;
+        double m_from_time;
+        size_t m_chunk;
+        const std::vector<uint8_t>* m_data = nullptr;
+        size_t m_bit_position = 0;
+        size_t m_remaining = 0;
+        std::vector<ComponentDecoder> m_decoders;
+    };
+
+    TrajectoryStore(size_t state_size, size_t chunk_snapshots = 1024, unsigned mantissa_bits = 52);
+    ~TrajectoryStore();
+
+    TrajectoryStore(const TrajectoryStore&) = delete;
+    TrajectoryStore& operator=(const TrajectoryStore&) = delete;
+
+    /**
+     * Add snapshot, times should not decrease. Values are copied and compressed in background.
+     * Waits if background thread is too far behind
+     */
+    void append(double time, const std::vector<double>& state);
+
+    /**
+     * Compress partially filled chunk and wait until all snapshots are compressed
+     */
+    void flush();
+
+    /**
+     * Reader from first compressed snapshot with time >= from_time. Chunks before from_time
+     * are skipped by index. Snapshots appended after last flush() may be not visible
+     */
+    Cursor read_from(double from_time = -std::numeric_limits<double>::infinity());
+
+    size_t state_size() const;
+    size_t snapshots_count();
+    size_t chunks_count();
+
+    /// Size of compressed chunks data
+    size_t compressed_bytes();
+
+    /// Size of compressed snapshots stored as raw doubles
+    size_t raw_bytes();
+
+private:
+    struct Chunk
+    {
+        double begin_time = 0.0;
+        double end_time = 0.0;
+        size_t count = 0;
+        std::vector<uint8_t> data;
+    };
+
+    // Snapshots as time, state[0], ..., state[n-1]
+    struct RawChunk
+    {
+        std::vector<double> values;
+        size_t count = 0;
+    };
+
+    void worker();
+    void compress(const RawChunk& raw, Chunk& chunk) const;
+    void submit_filling();
+    size_t find_chunk(double time);
+
+    size_t m_state_size;
+    size_t m_chunk_snapshots;
+    uint64_t m_state_mask;
+
+    RawChunk m_filling;
+    double m_last_time = -std::numeric_limits<double>::infinity();
+
+    std::deque<RawChunk> m_pending;
+    std::vector<RawChunk> m_free;
+    bool m_compressing = false;
+    bool m_stop = false;
+
+    // Deque does not move chunks on push_back, so cursors keep pointers to data
+    std::deque<Chunk> m_chunks;
+    size_t m_snapshots = 0;
+    size_t m_compressed_bytes = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_raw_ready;
+    std::condition_variable m_raw_done;
+    std::thread m_worker;
+};
+
+/**
+ * Hook that appends values of variable to trajectory store
+ */
+class TrajectoryRecorderHook : public TimeHookPeriodic
+{
+public:
+    TrajectoryRecorderHook(IVariable* variable, TrajectoryStore* store);
+    void hook(double real_time, double wanted_time) override;
+
+private:
+    IVariable* m_variable;
+    TrajectoryStore* m_store;
+    std::vector<double> m_values;
+};
+
+}
+
+#endif // TRAJECTORY_STORE_HPP_INCLUDED
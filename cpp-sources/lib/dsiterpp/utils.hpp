@@ -3,4 +3,40 @@
 
 #define DSITERPP_UNUSED(x) ((void) x)
 
+namespace dsiterpp {
+
+/**
+ * Value is opaque for optimizer, so expressions with it are not reassociated or simplified
+ * even with -ffast-math. Needed by error-free transformations like two-sum
+ */
+inline double fp_barrier(double x)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__SSE2_MATH__))
+    __asm__ volatile ("" : "+x"(x));
+#elif defined(__GNUC__)
+    __asm__ volatile ("" : "+m"(x));
+#else
+    volatile double opaque = x;
+    x = opaque;
+#endif
+    return x;
+}
+
+/**
+ * Memory pointed by data is opaque for optimizer after this call, so values stored there
+ * are reloaded and not replaced by expressions they were calculated from.
+ * Unlike fp_barrier() for every element, loops before and after it still vectorize
+ */
+inline void fp_memory_barrier(const void* data)
+{
+#if defined(__GNUC__)
+    __asm__ volatile ("" : : "r"(data) : "memory");
+#else
+    volatile const void* opaque = data;
+    DSITERPP_UNUSED(opaque);
+#endif
+}
+
+}
+
 #endif // DSITERPP_UTILS_HPP_INCLUDED
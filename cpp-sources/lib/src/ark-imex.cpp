@@ -0,0 +1,340 @@
+#include "dsiterpp/ark-imex.hpp"
+
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+using namespace dsiterpp;
+
+ARKIMEXTableau ARKIMEXTableau::ark324l2sa()
+{
+    const double gamma = 1767732205903.0 / 4055673282236.0;
+
+    ARKIMEXTableau tableau;
+    tableau.stages = 4;
+    tableau.order = 3;
+    tableau.embedded_order = 2;
+    tableau.c = {0.0, 1767732205903.0 / 2027836641118.0, 3.0 / 5.0, 1.0};
+    tableau.b = {
+        1471266399579.0 / 7840856788654.0, -4482444167858.0 / 7529755066697.0,
+        11266239266428.0 / 11593286722821.0, gamma
+    };
+    tableau.d = {
+        2756255671327.0 / 12835298489170.0, -10771552573575.0 / 22201958757719.0,
+        9247589265047.0 / 10645013368117.0, 2193209047091.0 / 5459859503100.0
+    };
+    tableau.a_explicit = {
+        {},
+        {1767732205903.0 / 2027836641118.0},
+        {5535828885825.0 / 10492691773637.0, 788022342437.0 / 10882634858940.0},
+        {6485989280629.0 / 16251701735622.0, -4246266847089.0 / 9704473918619.0, 10755448449292.0 / 10357097424841.0}
+    };
+    tableau.a_implicit = {
+        {0.0},
+        {gamma, gamma},
+        {2746238789719.0 / 10658868560708.0, -640167445237.0 / 6845629431997.0, gamma},
+        {tableau.b[0], tableau.b[1], tableau.b[2], gamma}
+    };
+    return tableau;
+}
+
+ARKIMEXTableau ARKIMEXTableau::ark436l2sa()
+{
+    const double gamma = 1.0 / 4.0;
+
+    ARKIMEXTableau tableau;
+    tableau.stages = 6;
+    tableau.order = 4;
+    tableau.embedded_order = 3;
+    tableau.c = {0.0, 1.0 / 2.0, 83.0 / 250.0, 31.0 / 50.0, 17.0 / 20.0, 1.0};
+    tableau.b = {
+        82889.0 / 524892.0, 0.0, 15625.0 / 83664.0,
+        69875.0 / 102672.0, -2260.0 / 8211.0, 1.0 / 4.0
+    };
+    tableau.d = {
+        4586570599.0 / 29645900160.0, 0.0, 178811875.0 / 945068544.0,
+        814220225.0 / 1159782912.0, -3700637.0 / 11593932.0, 61727.0 / 225920.0
+    };
+    tableau.a_explicit = {
+        {},
+        {1.0 / 2.0},
+        {13861.0 / 62500.0, 6889.0 / 62500.0},
+        {-116923316275.0 / 2393684061468.0, -2731218467317.0 / 15368042101831.0, 9408046702089.0 / 11113171139209.0},
+        {
+            -451086348788.0 / 2902428689909.0, -2682348792572.0 / 7519795681897.0,
+            12662868775082.0 / 11960479115383.0, 3355817975965.0 / 11060851509271.0
+        },
+        {
+            647845179188.0 / 3216320057751.0, 73281519250.0 / 8382639484533.0, 552539513391.0 / 3454668386233.0,
+            3354512671639.0 / 8306763924573.0, 4040.0 / 17871.0
+        }
+    };
+    tableau.a_implicit = {
+        {0.0},
+        {gamma, gamma},
+        {8611.0 / 62500.0, -1743.0 / 31250.0, gamma},
+        {5012029.0 / 34652500.0, -654441.0 / 2922500.0, 174375.0 / 388108.0, gamma},
+        {
+            15267082809.0 / 155376265600.0, -71443401.0 / 120774400.0, 730878875.0 / 902184768.0,
+            2285395.0 / 8070912.0, gamma
+        },
+        {tableau.b[0], tableau.b[1], tableau.b[2], tableau.b[3], tableau.b[4], gamma}
+    };
+    return tableau;
+}
+
+/////////////////////////
+// ARKIMEXIterator
+
+ARKIMEXIterator::ARKIMEXIterator(const ARKIMEXTableau& tableau) :
+    m_tableau(tableau)
+{
+    if (m_tableau.stages < 2 || m_tableau.a_implicit[0][0] != 0.0 || m_tableau.c[0] != 0.0)
+        throw std::invalid_argument("ARKIMEXIterator: first stage of tableau should be explicit");
+}
+
+void ARKIMEXIterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    if (!solve_step(variable, rhs, t, dt))
+        throw std::runtime_error("ARKIMEXIterator: Newton iterations do not converge");
+}
+
+int ARKIMEXIterator::method_order() const
+{
+    return m_tableau.order;
+}
+
+void ARKIMEXIterator::calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt)
+{
+    if (!solve_step(variable, rhs, t, dt))
+    {
+        m_error.max_rel_error = std::numeric_limits<double>::infinity();
+        m_error.max_abs_error = std::numeric_limits<double>::infinity();
+        return;
+    }
+
+    m_error.max_abs_error = 0.0;
+    m_error.max_rel_error = 0.0;
+    for (size_t i = 0; i < m_delta.size(); i++)
+    {
+        double abs_error = fabs(m_delta[i] - m_embedded_delta[i]);
+        double base_value = fabs(m_x0[i]) + fabs(m_delta[i]);
+        double rel_error = base_value == 0.0 ? abs_error : abs_error / base_value;
+
+        m_error.max_abs_error = std::max(m_error.max_abs_error, abs_error);
+        m_error.max_rel_error = std::max(m_error.max_rel_error, rel_error);
+    }
+}
+
+void ARKIMEXIterator::set_jacobian_function(JacobianFunction jacobian)
+{
+    m_jacobian_function = jacobian;
+}
+
+void ARKIMEXIterator::set_newton_tolerance(double tolerance)
+{
+    m_newton_tolerance = tolerance;
+}
+
+void ARKIMEXIterator::set_newton_max_iterations(size_t max_iterations)
+{
+    m_newton_max_iterations = max_iterations;
+}
+
+size_t ARKIMEXIterator::explicit_evaluations_count() const
+{
+    return m_explicit_evaluations;
+}
+
+size_t ARKIMEXIterator::implicit_evaluations_count() const
+{
+    return m_implicit_evaluations;
+}
+
+bool ARKIMEXIterator::solve_step(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    m_variable = variable;
+    m_rhs = rhs;
+    m_group = dynamic_cast<RHSGroup*>(rhs);
+
+    rhs->pre_iteration_job(t);
+
+    m_evaluator.set_target(variable, rhs);
+    m_evaluator.collect_values(m_x0);
+
+    const size_t n = m_x0.size();
+    const size_t stages = m_tableau.stages;
+    const double gamma = m_tableau.a_implicit[stages - 1][stages - 1];
+    m_f_explicit.resize(stages);
+    m_f_implicit.resize(stages);
+
+    // First stage is explicit, its implicit part gives Jacobian point
+    evaluate_part(RHSGroup::Treatment::implicit_part, t, m_x0, m_f_implicit[0]);
+    evaluate_part(RHSGroup::Treatment::explicit_part, t, m_x0, m_f_explicit[0]);
+    update_newton_matrix(t, m_x0, m_f_implicit[0], gamma * dt);
+
+    m_base.resize(n);
+    m_stage.resize(n);
+    for (size_t s = 1; s < stages; s++)
+    {
+        const double stage_time = t + m_tableau.c[s] * dt;
+        m_base = m_x0;
+        for (size_t j = 0; j < s; j++)
+        {
+            const double explicit_m = m_tableau.a_explicit[s][j] * dt;
+            const double implicit_m = m_tableau.a_implicit[s][j] * dt;
+            const std::vector<double>& f_e = m_f_explicit[j];
+            const std::vector<double>& f_i = m_f_implicit[j];
+            for (size_t i = 0; i < n; i++)
+                m_base[i] += explicit_m * f_e[i] + implicit_m * f_i[i];
+        }
+
+        m_f_implicit[s] = m_f_implicit[s - 1];
+        if (!solve_stage(stage_time, m_base, gamma * dt, m_f_implicit[s]))
+        {
+            m_evaluator.restore(m_x0);
+            return false;
+        }
+
+        for (size_t i = 0; i < n; i++)
+            m_stage[i] = m_base[i] + gamma * dt * m_f_implicit[s][i];
+        evaluate_part(RHSGroup::Treatment::explicit_part, stage_time, m_stage, m_f_explicit[s]);
+    }
+
+    m_delta.assign(n, 0.0);
+    m_embedded_delta.assign(n, 0.0);
+    for (size_t s = 0; s < stages; s++)
+    {
+        const double b_dt = m_tableau.b[s] * dt;
+        const double d_dt = m_tableau.d[s] * dt;
+        for (size_t i = 0; i < n; i++)
+        {
+            const double f = m_f_explicit[s][i] + m_f_implicit[s][i];
+            m_delta[i] += b_dt * f;
+            m_embedded_delta[i] += d_dt * f;
+        }
+    }
+
+    m_evaluator.restore(m_x0, m_delta);
+    return true;
+}
+
+void ARKIMEXIterator::evaluate_part(RHSGroup::Treatment treatment, double t, const std::vector<double>& x, std::vector<double>& f) const
+{
+    // Whole RHS that is not a group is implicit part
+    const bool has_part = m_group != nullptr
+        ? m_group->has_part(treatment)
+        : treatment == RHSGroup::Treatment::implicit_part;
+    if (!has_part)
+    {
+        f.assign(x.size(), 0.0);
+        return;
+    }
+
+    auto it = x.cbegin();
+    m_variable->set_values(it);
+    m_rhs->pre_sub_iteration_job(t);
+    if (m_group != nullptr)
+    {
+        m_variable->clear_rhs();
+        m_group->calculate_rhs(t, treatment);
+    } else {
+        m_rhs->calculate_rhs(t);
+    }
+    m_variable->clear_subiteration();
+    m_variable->add_rhs_to_delta(1.0);
+    f.clear();
+    m_variable->collect_deltas(f);
+    m_variable->clear_subiteration();
+
+    if (treatment == RHSGroup::Treatment::implicit_part)
+        m_implicit_evaluations++;
+    else
+        m_explicit_evaluations++;
+}
+
+void ARKIMEXIterator::update_newton_matrix(double t, const std::vector<double>& x, const std::vector<double>& f, double m) const
+{
+    const size_t n = x.size();
+    m_jacobian.resize(n);
+
+    if (m_jacobian_function)
+    {
+        m_jacobian_function(t, x, m_jacobian);
+    } else {
+        const double sqrt_eps = sqrt(std::numeric_limits<double>::epsilon());
+        m_x_perturbed = x;
+        for (size_t j = 0; j < n; j++)
+        {
+            double h = sqrt_eps * std::max(fabs(x[j]), 1.0);
+            m_x_perturbed[j] = x[j] + h;
+            h = m_x_perturbed[j] - x[j];
+            evaluate_part(RHSGroup::Treatment::implicit_part, t, m_x_perturbed, m_f);
+            for (size_t i = 0; i < n; i++)
+                m_jacobian(i, j) = (m_f[i] - f[i]) / h;
+            m_x_perturbed[j] = x[j];
+        }
+    }
+
+    m_newton_matrix.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+            m_newton_matrix(i, j) = - m * m_jacobian(i, j);
+        m_newton_matrix(i, i) += 1.0;
+    }
+    m_lu.decompose(m_newton_matrix);
+}
+
+bool ARKIMEXIterator::solve_stage(double t, const std::vector<double>& base, double m, std::vector<double>& k) const
+{
+    m_k_guess = k;
+    if (newton_iterations(t, base, m, k))
+        return true;
+
+    // Jacobian from the step beginning is too far from the stage, so refresh it
+    // at initial guess point and try again
+    k = m_k_guess;
+    const size_t n = base.size();
+    for (size_t i = 0; i < n; i++)
+        m_stage[i] = base[i] + m * k[i];
+    evaluate_part(RHSGroup::Treatment::implicit_part, t, m_stage, m_f_stage);
+    update_newton_matrix(t, m_stage, m_f_stage, m);
+
+    return newton_iterations(t, base, m, k);
+}
+
+bool ARKIMEXIterator::newton_iterations(double t, const std::vector<double>& base, double m, std::vector<double>& k) const
+{
+    const size_t n = base.size();
+    for (size_t iteration = 0; iteration < m_newton_max_iterations; iteration++)
+    {
+        double max_value = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            m_stage[i] = base[i] + m * k[i];
+            max_value = std::max(max_value, fabs(m_stage[i]));
+        }
+
+        // Newton correction for k: (I - m*J_I) dk = f_I(stage) - k
+        evaluate_part(RHSGroup::Treatment::implicit_part, t, m_stage, m_f);
+        for (size_t i = 0; i < n; i++)
+            m_f[i] -= k[i];
+        m_lu.solve(m_f);
+
+        double max_correction = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            k[i] += m_f[i];
+            max_correction = std::max(max_correction, fabs(m * m_f[i]));
+        }
+
+        if (!std::isfinite(max_correction))
+            return false;
+
+        if (max_correction <= m_newton_tolerance * (1.0 + max_value))
+            return true;
+    }
+    return false;
+}
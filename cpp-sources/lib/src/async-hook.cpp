@@ -0,0 +1,120 @@
+#include "dsiterpp/async-hook.hpp"
+#include "dsiterpp/integration.hpp"
+
+#include <stdexcept>
+
+using namespace dsiterpp;
+
+AsyncTimeHook::AsyncTimeHook(IVariable* variable, HookFunc hook_func, size_t queue_depth, OverflowPolicy policy) :
+    m_variable(variable), m_hook_func(hook_func), m_policy(policy)
+{
+    if (queue_depth == 0)
+        throw std::invalid_argument("AsyncTimeHook: queue depth should be positive");
+    m_slots.resize(queue_depth);
+    m_worker = std::thread(&AsyncTimeHook::worker, this);
+}
+
+AsyncTimeHook::~AsyncTimeHook()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_slot_free.wait(lock, [this] { return m_count == 0; });
+        m_stop = true;
+    }
+    m_snapshot_ready.notify_all();
+    m_worker.join();
+}
+
+void AsyncTimeHook::hook(double real_time, double wanted_time)
+{
+    size_t slot = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        rethrow_if_failed();
+        if (m_count == m_slots.size())
+        {
+            if (m_policy == OverflowPolicy::drop)
+            {
+                m_dropped++;
+                return;
+            }
+            m_slot_free.wait(lock, [this] { return m_count < m_slots.size(); });
+        }
+        slot = (m_first + m_count) % m_slots.size();
+    }
+
+    // Worker does not touch slots out of queue, so copying is done without lock.
+    // Buffer keeps its capacity, so there are no allocations after first snapshots
+    Snapshot& snapshot = m_slots[slot];
+    snapshot.real_time = real_time;
+    snapshot.wanted_time = wanted_time;
+    snapshot.state.clear();
+    m_variable->collect_values(snapshot.state);
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_count++;
+    }
+    m_snapshot_ready.notify_one();
+}
+
+void AsyncTimeHook::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_slot_free.wait(lock, [this] { return m_count == 0; });
+    rethrow_if_failed();
+}
+
+size_t AsyncTimeHook::dropped_count()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_dropped;
+}
+
+size_t AsyncTimeHook::processed_count()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_processed;
+}
+
+void AsyncTimeHook::worker()
+{
+    for (;;)
+    {
+        Snapshot* snapshot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_snapshot_ready.wait(lock, [this] { return m_count > 0 || m_stop; });
+            if (m_count == 0)
+                return;
+            snapshot = &m_slots[m_first];
+        }
+
+        std::exception_ptr exception;
+        try {
+            m_hook_func(snapshot->real_time, snapshot->wanted_time, snapshot->state);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (exception && !m_exception)
+                m_exception = exception;
+            m_first = (m_first + 1) % m_slots.size();
+            m_count--;
+            m_processed++;
+        }
+        m_slot_free.notify_all();
+    }
+}
+
+void AsyncTimeHook::rethrow_if_failed()
+{
+    if (m_exception)
+    {
+        std::exception_ptr exception = m_exception;
+        m_exception = nullptr;
+        std::rethrow_exception(exception);
+    }
+}
@@ -0,0 +1,362 @@
+#include "dsiterpp/bdf.hpp"
+
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+using namespace dsiterpp;
+
+void BDFIterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    if (!solve_step(variable, rhs, t, dt))
+        throw std::runtime_error("BDFIterator: Newton iterations do not converge");
+    // Without error estimation order is limited only by history
+    m_next_order = m_parameters.max_order;
+}
+
+int BDFIterator::method_order() const
+{
+    return static_cast<int>(m_order);
+}
+
+void BDFIterator::step_done(double time, double dt, IteratingMetrics& metrics)
+{
+    DSITERPP_UNUSED(metrics);
+    if (m_solution_time != time + dt)
+        return;
+
+    std::rotate(m_history.begin(), m_history.end() - 1, m_history.end());
+    std::rotate(m_history_times.begin(), m_history_times.end() - 1, m_history_times.end());
+    // Variable keeps x0 + delta, that may differ from solution in the last bit
+    std::vector<double>& newest = m_history[0];
+    newest.resize(m_x0.size());
+    for (size_t i = 0; i < m_x0.size(); i++)
+        newest[i] = m_x0[i] + m_delta[i];
+    m_history_times[0] = m_solution_time;
+    m_history_size = std::min(m_history_size + 1, m_history.size());
+
+    m_statistics.steps++;
+    m_statistics.max_used_order = std::max(m_statistics.max_used_order, m_order);
+    if (m_next_order == m_order)
+        m_steps_at_order++;
+    else
+        m_steps_at_order = 0;
+}
+
+void BDFIterator::calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt)
+{
+    if (!solve_step(variable, rhs, t, dt))
+    {
+        m_statistics.newton_failures++;
+        m_error.max_rel_error = std::numeric_limits<double>::infinity();
+        m_error.max_abs_error = std::numeric_limits<double>::infinity();
+        m_evaluator.restore(m_x0);
+        return;
+    }
+
+    const size_t k = m_order;
+    double error = estimate_error(k);
+    m_error.max_rel_error = error;
+    m_error.max_abs_error = 0.0;
+    for (size_t i = 0; i < m_solution.size(); i++)
+        m_error.max_abs_error = std::max(m_error.max_abs_error, fabs(m_solution[i] - m_prediction[i]) / (k + 1));
+
+    // Order for next step gives the biggest step for the same error: step ratio is
+    // (tolerance / error_q)^(1 / (q + 1)) for order q
+    m_next_order = k;
+    if (m_max_rel_error <= 0.0 || error == 0.0)
+        return;
+
+    auto step_ratio = [this](double error_q, size_t q) {
+        return error_q == 0.0 ? std::numeric_limits<double>::infinity() : pow(m_max_rel_error / error_q, 1.0 / (q + 1));
+    };
+    double ratio = step_ratio(error, k);
+
+    if (k > 1 && step_ratio(estimate_error(k - 1), k - 1) > ratio)
+    {
+        m_next_order = k - 1;
+        return;
+    }
+
+    if (k < m_parameters.max_order && m_steps_at_order >= k + 1 && m_history_size >= k + 2)
+    {
+        if (step_ratio(estimate_error(k + 1), k + 1) > 1.2 * ratio)
+            m_next_order = k + 1;
+    }
+}
+
+void BDFIterator::set_step_tolerance(double max_rel_error, double min_rel_error)
+{
+    DSITERPP_UNUSED(min_rel_error);
+    m_max_rel_error = max_rel_error;
+}
+
+void BDFIterator::set_preconditioner(IPreconditioner* preconditioner)
+{
+    m_preconditioner = preconditioner;
+    m_preconditioner_needs_setup = true;
+}
+
+BDFParameters& BDFIterator::parameters()
+{
+    return m_parameters;
+}
+
+const BDFStatistics& BDFIterator::statistics() const
+{
+    return m_statistics;
+}
+
+size_t BDFIterator::order() const
+{
+    return m_next_order;
+}
+
+void BDFIterator::reset()
+{
+    m_history_size = 0;
+    m_next_order = 1;
+    m_steps_at_order = 0;
+}
+
+bool BDFIterator::solve_step(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    rhs->pre_iteration_job(t);
+    m_evaluator.set_target(variable, rhs);
+    m_evaluator.collect_values(m_x0);
+    prepare_history(t);
+
+    const size_t n = m_x0.size();
+    const size_t k = std::min(std::min(m_next_order, m_parameters.max_order), std::max<size_t>(1, m_history_size - 1));
+    m_order = k;
+    const double t1 = t + dt;
+
+    // Variable step BDF: derivative at t1 of polynomial interpolating solution at t1 and
+    // k history points is f(t1, x1), so sum alpha_j x_{n+1-j} = dt * f(t1, x1) with
+    // alpha_j = dt * l_j'(t1) for Lagrange basis l_j
+    m_coefficients.assign(k + 1, 0.0);
+    auto node = [this, t1](size_t j) { return j == 0 ? t1 : m_history_times[j - 1]; };
+    for (size_t m = 1; m <= k; m++)
+        m_coefficients[0] += dt / (t1 - node(m));
+    for (size_t j = 1; j <= k; j++)
+    {
+        double numerator = 1.0, denominator = 1.0;
+        for (size_t m = 0; m <= k; m++)
+        {
+            if (m == j)
+                continue;
+            if (m != 0)
+                numerator *= t1 - node(m);
+            denominator *= node(j) - node(m);
+        }
+        m_coefficients[j] = dt * numerator / denominator;
+    }
+
+    // x1 - gamma * f(t1, x1) = psi
+    m_gamma = dt / m_coefficients[0];
+    m_psi.assign(n, 0.0);
+    for (size_t j = 1; j <= k; j++)
+    {
+        const double m = - m_coefficients[j] / m_coefficients[0];
+        const std::vector<double>& x = m_history[j - 1];
+        for (size_t i = 0; i < n; i++)
+            m_psi[i] += m * x[i];
+    }
+
+    // Predictor of the same order, at the very beginning it is explicit Euler step
+    if (m_history_size >= k + 1)
+    {
+        extrapolate(k + 1, t1, m_prediction);
+    } else {
+        m_evaluator.evaluate_current(t, m_f);
+        m_prediction.resize(n);
+        for (size_t i = 0; i < n; i++)
+            m_prediction[i] = m_x0[i] + dt * m_f[i];
+    }
+
+    double max_value = 0.0;
+    for (double value : m_x0)
+        max_value = std::max(max_value, fabs(value));
+    m_scale_floor = 1e-6 * max_value + std::numeric_limits<double>::min();
+
+    if (m_preconditioner)
+    {
+        bool gamma_changed = fabs(m_gamma / m_preconditioner_gamma - 1.0) > m_parameters.preconditioner_gamma_change;
+        if (m_preconditioner_needs_setup || gamma_changed)
+        {
+            m_preconditioner->setup(t1, m_prediction, m_gamma);
+            m_preconditioner_gamma = m_gamma;
+            m_preconditioner_needs_setup = false;
+            m_statistics.preconditioner_setups++;
+        }
+    }
+
+    m_solution = m_prediction;
+    bool converged = newton_iterations(t1, m_gamma);
+    if (!converged || m_last_newton_iterations > m_parameters.slow_newton_iterations)
+    {
+        m_preconditioner_needs_setup = true;
+        if (m_preconditioner)
+            m_preconditioner->jacobian_outdated();
+    }
+    if (!converged)
+        return false;
+
+    m_delta.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_delta[i] = m_solution[i] - m_x0[i];
+    m_evaluator.restore(m_x0, m_delta);
+    m_solution_time = t1;
+    return true;
+}
+
+void BDFIterator::prepare_history(double t) const
+{
+    const size_t capacity = m_parameters.max_order + 2;
+    if (m_history.size() != capacity)
+    {
+        m_history.resize(capacity);
+        m_history_times.resize(capacity);
+        m_history_size = 0;
+    }
+
+    if (m_history_size != 0 && m_history_times[0] == t && is_history_continuous())
+        return;
+
+    // First step or state was changed outside
+    if (m_history_size != 0)
+        m_statistics.history_restarts++;
+    m_history[0] = m_x0;
+    m_history_times[0] = t;
+    m_history_size = 1;
+    m_next_order = 1;
+    m_steps_at_order = 0;
+}
+
+bool BDFIterator::is_history_continuous() const
+{
+    // Rounding by variable is allowed, changes made outside (i.e. by bifurcation) are not
+    const std::vector<double>& last = m_history[0];
+    if (last.size() != m_x0.size())
+        return false;
+    for (size_t i = 0; i < m_x0.size(); i++)
+    {
+        double tolerance = 4.0 * std::numeric_limits<double>::epsilon() * std::max(fabs(last[i]), fabs(m_x0[i]));
+        if (!(fabs(last[i] - m_x0[i]) <= tolerance))
+            return false;
+    }
+    return true;
+}
+
+void BDFIterator::extrapolate(size_t points_count, double time, std::vector<double>& result) const
+{
+    const size_t n = m_x0.size();
+    result.assign(n, 0.0);
+    for (size_t j = 0; j < points_count; j++)
+    {
+        double basis = 1.0;
+        for (size_t m = 0; m < points_count; m++)
+        {
+            if (m != j)
+                basis *= (time - m_history_times[m]) / (m_history_times[j] - m_history_times[m]);
+        }
+        const std::vector<double>& x = m_history[j];
+        for (size_t i = 0; i < n; i++)
+            result[i] += basis * x[i];
+    }
+}
+
+bool BDFIterator::newton_iterations(double t, double gamma) const
+{
+    const size_t n = m_x0.size();
+    m_stage_time = t;
+    m_gmres.set_krylov_dimension(m_parameters.krylov_dimension);
+    m_gmres.set_max_restarts(m_parameters.max_krylov_restarts);
+    m_gmres.set_tolerance(m_parameters.krylov_tolerance);
+
+    GMRESSolver::Operator newton_matrix = [this](const std::vector<double>& v, std::vector<double>& result) {
+        newton_matrix_product(v, result);
+    };
+    GMRESSolver::Operator preconditioner;
+    if (m_preconditioner)
+    {
+        preconditioner = [this](const std::vector<double>& r, std::vector<double>& z) {
+            m_preconditioner->apply(r, z);
+        };
+    }
+
+    double previous_correction = std::numeric_limits<double>::infinity();
+    for (size_t iteration = 0; iteration < m_parameters.max_newton_iterations; iteration++)
+    {
+        m_last_newton_iterations = iteration + 1;
+        // Residual of x - gamma * f(t, x) = psi
+        m_evaluator.evaluate(t, m_solution, m_f);
+        m_residual.resize(n);
+        for (size_t i = 0; i < n; i++)
+            m_residual[i] = m_psi[i] + gamma * m_f[i] - m_solution[i];
+
+        m_gmres.solve(newton_matrix, preconditioner, m_residual, m_correction);
+        m_statistics.krylov_iterations += m_gmres.iterations();
+        m_statistics.newton_iterations++;
+
+        for (size_t i = 0; i < n; i++)
+            m_solution[i] += m_correction[i];
+
+        double correction = scaled_norm(m_correction);
+        if (!std::isfinite(correction) || correction > 2.0 * previous_correction)
+            return false;
+        if (correction <= m_parameters.newton_tolerance)
+            return true;
+        previous_correction = correction;
+    }
+    return false;
+}
+
+void BDFIterator::newton_matrix_product(const std::vector<double>& v, std::vector<double>& result) const
+{
+    // (I - gamma * J) v, J v = (f(x + eps * v) - f(x)) / eps
+    const size_t n = v.size();
+    result.resize(n);
+    double v_norm = norm2(v);
+    if (v_norm == 0.0)
+    {
+        std::fill(result.begin(), result.end(), 0.0);
+        return;
+    }
+
+    double eps = sqrt(std::numeric_limits<double>::epsilon()) * (1.0 + norm2(m_solution)) / v_norm;
+    m_perturbed.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_perturbed[i] = m_solution[i] + eps * v[i];
+    m_evaluator.evaluate(m_stage_time, m_perturbed, m_f_perturbed);
+
+    for (size_t i = 0; i < n; i++)
+        result[i] = v[i] - m_gamma * (m_f_perturbed[i] - m_f[i]) / eps;
+}
+
+double BDFIterator::scaled_norm(const std::vector<double>& v) const
+{
+    double result = 0.0;
+    for (size_t i = 0; i < v.size(); i++)
+    {
+        double scale = std::max(std::max(fabs(m_x0[i]), fabs(m_solution[i])), m_scale_floor);
+        result = std::max(result, fabs(v[i]) / scale);
+    }
+    return result;
+}
+
+double BDFIterator::estimate_error(size_t order) const
+{
+    const std::vector<double>* prediction = &m_prediction;
+    if (order != m_order)
+    {
+        extrapolate(order + 1, m_solution_time, m_perturbed);
+        prediction = &m_perturbed;
+    }
+
+    m_residual.resize(m_solution.size());
+    for (size_t i = 0; i < m_solution.size(); i++)
+        m_residual[i] = m_solution[i] - (*prediction)[i];
+    return scaled_norm(m_residual) / (order + 1);
+}
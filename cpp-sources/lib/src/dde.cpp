@@ -0,0 +1,208 @@
+#include "dsiterpp/dde.hpp"
+#include "dsiterpp/integration.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+
+using namespace dsiterpp;
+
+void DelayHistory::set_target(IVariable* variable, IRHS* rhs)
+{
+    m_evaluator.set_target(variable, rhs);
+}
+
+void DelayHistory::add_delay(double delay)
+{
+    if (delay <= 0.0)
+        throw std::invalid_argument("DelayHistory: delay should be positive");
+    m_delays.push_back(delay);
+    m_max_delay = std::max(m_max_delay, delay);
+    if (m_started)
+        update_breakpoints();
+}
+
+void DelayHistory::set_initial_history(InitialHistory initial_history)
+{
+    m_initial_history = initial_history;
+}
+
+void DelayHistory::set_discontinuity_order(int order)
+{
+    m_discontinuity_order = order;
+    if (m_started)
+        update_breakpoints();
+}
+
+void DelayHistory::set_limit_step_by_min_delay(bool limit)
+{
+    m_limit_step_by_min_delay = limit;
+}
+
+double DelayHistory::value(double time, size_t component) const
+{
+    if (!m_started)
+        throw std::runtime_error("DelayHistory: history is not started");
+
+    if (time < m_initial_time)
+        return m_initial_history ? m_initial_history(time, component) : m_initial_values[component];
+
+    if (time < sample_time(0))
+        throw std::runtime_error("DelayHistory: time is out of stored history, add larger delay");
+
+    const size_t last = m_count - 1;
+    if (time >= sample_time(last))
+    {
+        // Should not happen when steps are limited by min delay, linear extrapolation
+        size_t r = ring_index(last);
+        return m_values[r * m_state_size + component] + (time - m_times[r]) * m_derivatives[r * m_state_size + component];
+    }
+
+    // Binary search of interval [sample_time(lo), sample_time(lo + 1)) containing time
+    size_t lo = 0, hi = last;
+    while (hi - lo > 1)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (sample_time(mid) <= time)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    size_t r0 = ring_index(lo), r1 = ring_index(lo + 1);
+    double t0 = m_times[r0], h = m_times[r1] - t0;
+    double s = (time - t0) / h;
+    double s2 = s * s, s3 = s2 * s;
+    double h00 = 2 * s3 - 3 * s2 + 1;
+    double h10 = s3 - 2 * s2 + s;
+    double h01 = -2 * s3 + 3 * s2;
+    double h11 = s3 - s2;
+
+    size_t i0 = r0 * m_state_size + component, i1 = r1 * m_state_size + component;
+    return h00 * m_values[i0] + h10 * h * m_derivatives[i0] + h01 * m_values[i1] + h11 * h * m_derivatives[i1];
+}
+
+void DelayHistory::values(double time, std::vector<double>& values) const
+{
+    values.resize(m_state_size);
+    for (size_t i = 0; i < m_state_size; i++)
+        values[i] = value(time, i);
+}
+
+size_t DelayHistory::samples_count() const
+{
+    return m_count;
+}
+
+size_t DelayHistory::state_size() const
+{
+    return m_state_size;
+}
+
+void DelayHistory::step_accepted(double time)
+{
+    if (m_evaluator.variable() == nullptr)
+        throw std::runtime_error("DelayHistory: target is not set");
+
+    if (!m_started)
+    {
+        m_evaluator.collect_values(m_initial_values);
+        m_state_size = m_initial_values.size();
+        m_initial_time = time;
+        m_first = 0;
+        m_count = 0;
+        m_started = true;
+        update_breakpoints();
+    }
+    push_sample(time);
+    drop_old_samples(time);
+}
+
+double DelayHistory::next_breakpoint(double time)
+{
+    const double tolerance = 1e-12 * std::max(1.0, fabs(time));
+    double result = std::numeric_limits<double>::infinity();
+
+    auto it = std::upper_bound(m_breakpoints.begin(), m_breakpoints.end(), time + tolerance);
+    if (it != m_breakpoints.end())
+        result = *it;
+
+    if (m_limit_step_by_min_delay && !m_delays.empty())
+        result = std::min(result, time + *std::min_element(m_delays.begin(), m_delays.end()));
+
+    return result;
+}
+
+void DelayHistory::push_sample(double time)
+{
+    m_evaluator.collect_values(m_sample_values);
+    m_evaluator.evaluate_current(time, m_sample_rhs);
+
+    if (m_sample_values.size() != m_state_size)
+        throw std::runtime_error("DelayHistory: state size changed");
+
+    if (m_count == m_capacity)
+        grow();
+
+    size_t r = ring_index(m_count);
+    m_times[r] = time;
+    std::copy(m_sample_values.begin(), m_sample_values.end(), m_values.begin() + r * m_state_size);
+    std::copy(m_sample_rhs.begin(), m_sample_rhs.end(), m_derivatives.begin() + r * m_state_size);
+    m_count++;
+}
+
+void DelayHistory::drop_old_samples(double time)
+{
+    // Interval containing time - max_delay should stay
+    const double oldest_needed = time - m_max_delay;
+    while (m_count > 2 && sample_time(1) <= oldest_needed)
+    {
+        m_first = (m_first + 1) % m_capacity;
+        m_count--;
+    }
+}
+
+void DelayHistory::grow()
+{
+    size_t new_capacity = std::max<size_t>(16, m_capacity * 2);
+    std::vector<double> times(new_capacity);
+    std::vector<double> values(new_capacity * m_state_size);
+    std::vector<double> derivatives(new_capacity * m_state_size);
+
+    for (size_t i = 0; i < m_count; i++)
+    {
+        size_t r = ring_index(i);
+        times[i] = m_times[r];
+        std::copy(m_values.begin() + r * m_state_size, m_values.begin() + (r + 1) * m_state_size, values.begin() + i * m_state_size);
+        std::copy(m_derivatives.begin() + r * m_state_size, m_derivatives.begin() + (r + 1) * m_state_size, derivatives.begin() + i * m_state_size);
+    }
+
+    m_times.swap(times);
+    m_values.swap(values);
+    m_derivatives.swap(derivatives);
+    m_capacity = new_capacity;
+    m_first = 0;
+}
+
+void DelayHistory::update_breakpoints()
+{
+    // All sums of up to m_discontinuity_order delays
+    std::vector<double> level(1, 0.0);
+    m_breakpoints.clear();
+    for (int order = 0; order < m_discontinuity_order; order++)
+    {
+        std::vector<double> next_level;
+        for (double sum : level)
+            for (double delay : m_delays)
+                next_level.push_back(sum + delay);
+
+        std::sort(next_level.begin(), next_level.end());
+        next_level.erase(std::unique(next_level.begin(), next_level.end()), next_level.end());
+        for (double shift : next_level)
+            m_breakpoints.push_back(m_initial_time + shift);
+        level.swap(next_level);
+    }
+    std::sort(m_breakpoints.begin(), m_breakpoints.end());
+    m_breakpoints.erase(std::unique(m_breakpoints.begin(), m_breakpoints.end()), m_breakpoints.end());
+}
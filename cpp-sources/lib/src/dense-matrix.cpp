@@ -0,0 +1,122 @@
+#include "dsiterpp/dense-matrix.hpp"
+
+#include <stdexcept>
+#include <cmath>
+#include <utility>
+
+using namespace dsiterpp;
+
+DenseMatrix::DenseMatrix(size_t size)
+{
+    resize(size);
+}
+
+void DenseMatrix::resize(size_t size)
+{
+    m_size = size;
+    m_data.resize(size * size);
+}
+
+size_t DenseMatrix::size() const
+{
+    return m_size;
+}
+
+double& DenseMatrix::operator()(size_t row, size_t col)
+{
+    return m_data[row * m_size + col];
+}
+
+double DenseMatrix::operator()(size_t row, size_t col) const
+{
+    return m_data[row * m_size + col];
+}
+
+void DenseMatrix::set_zero()
+{
+    for (auto &value : m_data)
+        value = 0.0;
+}
+
+void DenseMatrix::multiply(const std::vector<double>& x, std::vector<double>& y) const
+{
+    y.resize(m_size);
+    for (size_t i = 0; i < m_size; i++)
+    {
+        double sum = 0.0;
+        const double* row = &m_data[i * m_size];
+        for (size_t j = 0; j < m_size; j++)
+            sum += row[j] * x[j];
+        y[i] = sum;
+    }
+}
+
+/////////////////////////////////
+// LUDecomposition
+
+void LUDecomposition::decompose(const DenseMatrix& matrix)
+{
+    const size_t n = matrix.size();
+    m_lu = matrix;
+    m_permutation.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_permutation[i] = i;
+
+    for (size_t k = 0; k < n; k++)
+    {
+        size_t pivot = k;
+        double pivot_value = fabs(m_lu(k, k));
+        for (size_t i = k + 1; i < n; i++)
+        {
+            if (fabs(m_lu(i, k)) > pivot_value)
+            {
+                pivot = i;
+                pivot_value = fabs(m_lu(i, k));
+            }
+        }
+
+        if (pivot_value == 0.0)
+            throw std::runtime_error("LUDecomposition: matrix is singular");
+
+        if (pivot != k)
+        {
+            std::swap(m_permutation[k], m_permutation[pivot]);
+            for (size_t j = 0; j < n; j++)
+                std::swap(m_lu(k, j), m_lu(pivot, j));
+        }
+
+        for (size_t i = k + 1; i < n; i++)
+        {
+            double m = m_lu(i, k) / m_lu(k, k);
+            m_lu(i, k) = m;
+            if (m == 0.0)
+                continue;
+            for (size_t j = k + 1; j < n; j++)
+                m_lu(i, j) -= m * m_lu(k, j);
+        }
+    }
+}
+
+void LUDecomposition::solve(std::vector<double>& b) const
+{
+    const size_t n = m_lu.size();
+
+    // Forward substitution reads b through permutation, so result goes to separate buffer
+    std::vector<double>& y = m_buffer;
+    y.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        double sum = b[m_permutation[i]];
+        for (size_t j = 0; j < i; j++)
+            sum -= m_lu(i, j) * y[j];
+        y[i] = sum;
+    }
+
+    for (size_t i = n; i-- > 0; )
+    {
+        double sum = y[i];
+        for (size_t j = i + 1; j < n; j++)
+            sum -= m_lu(i, j) * b[j];
+        b[i] = sum / m_lu(i, i);
+    }
+}
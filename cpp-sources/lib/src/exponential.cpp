@@ -0,0 +1,161 @@
+#include "dsiterpp/exponential.hpp"
+#include "dsiterpp/krylov.hpp"
+
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+
+using namespace dsiterpp;
+
+void ExponentialIntegratorBase::set_krylov_dimension(size_t dimension)
+{
+    m_phi.set_krylov_dimension(dimension);
+}
+
+void ExponentialIntegratorBase::set_krylov_tolerance(double tolerance)
+{
+    m_phi.set_tolerance(tolerance);
+}
+
+const PhiCombination& ExponentialIntegratorBase::phi_combination() const
+{
+    return m_phi;
+}
+
+ISemilinearRHS* ExponentialIntegratorBase::semilinear_rhs(IRHS* rhs)
+{
+    ISemilinearRHS* semilinear = dynamic_cast<ISemilinearRHS*>(rhs);
+    if (semilinear == nullptr)
+        throw std::invalid_argument("Exponential integrator: RHS should implement ISemilinearRHS");
+    return semilinear;
+}
+
+void ExponentialIntegratorBase::evaluate_nonlinear(IVariable* variable, ISemilinearRHS* rhs, double t, const std::vector<double>& x, std::vector<double>& n) const
+{
+    auto it = x.cbegin();
+    variable->set_values(it);
+    rhs->pre_sub_iteration_job(t);
+    rhs->calculate_nonlinear(t);
+    variable->clear_subiteration();
+    variable->add_rhs_to_delta(1.0);
+    n.clear();
+    variable->collect_deltas(n);
+    variable->clear_subiteration();
+}
+
+/////////////////////////
+// ETDRK4Iterator
+
+void ETDRK4Iterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    ISemilinearRHS* semilinear = semilinear_rhs(rhs);
+    rhs->pre_iteration_job(t);
+
+    m_evaluator.set_target(variable, rhs);
+    m_evaluator.collect_values(m_x0);
+    const LinearOperator& l = semilinear->linear_operator();
+    const size_t n = m_x0.size();
+    const double half = 0.5 * dt;
+
+    m_v.resize(2);
+
+    // a = phi(h/2) applied to x, N(x)
+    evaluate_nonlinear(variable, semilinear, t, m_x0, m_nx);
+    m_v[0] = m_x0;
+    m_v[1] = m_nx;
+    m_phi.calculate(l, half, m_v, m_a);
+
+    // b: the same with N(a)
+    evaluate_nonlinear(variable, semilinear, t + half, m_a, m_na);
+    m_v[1] = m_na;
+    m_phi.calculate(l, half, m_v, m_b);
+
+    // c = phi(h/2) applied to a, 2 N(b) - N(x)
+    evaluate_nonlinear(variable, semilinear, t + half, m_b, m_nb);
+    m_v[0] = m_a;
+    for (size_t i = 0; i < n; i++)
+        m_v[1][i] = 2.0 * m_nb[i] - m_nx[i];
+    m_phi.calculate(l, half, m_v, m_c);
+
+    evaluate_nonlinear(variable, semilinear, t + dt, m_c, m_nc);
+
+    m_v.resize(4);
+    m_v[0] = m_x0;
+    m_v[1] = m_nx;
+    m_v[2].resize(n);
+    m_v[3].resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        m_v[2][i] = (-3.0 * m_nx[i] + 2.0 * m_na[i] + 2.0 * m_nb[i] - m_nc[i]) / dt;
+        m_v[3][i] = 4.0 * (m_nx[i] - m_na[i] - m_nb[i] + m_nc[i]) / (dt * dt);
+    }
+    m_phi.calculate(l, dt, m_v, m_delta);
+
+    for (size_t i = 0; i < n; i++)
+        m_delta[i] -= m_x0[i];
+
+    m_evaluator.restore(m_x0, m_delta);
+}
+
+int ETDRK4Iterator::method_order() const
+{
+    return 4;
+}
+
+/////////////////////////
+// ExponentialRosenbrockEulerIterator
+
+void ExponentialRosenbrockEulerIterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    ISemilinearRHS* semilinear = semilinear_rhs(rhs);
+    rhs->pre_iteration_job(t);
+
+    m_evaluator.set_target(variable, rhs);
+    m_evaluator.collect_values(m_x0);
+    const LinearOperator& l = semilinear->linear_operator();
+    const size_t n = m_x0.size();
+    const double sqrt_eps = sqrt(std::numeric_limits<double>::epsilon());
+
+    evaluate_nonlinear(variable, semilinear, t, m_x0, m_n0);
+    l.multiply(m_x0, m_lx);
+
+    // df/dt = dN/dt, L does not depend on time
+    const double time_step = sqrt_eps * std::max(fabs(t), 1.0);
+    evaluate_nonlinear(variable, semilinear, t + time_step, m_x0, m_nt);
+    for (size_t i = 0; i < n; i++)
+        m_nt[i] = (m_nt[i] - m_n0[i]) / time_step;
+
+    const double x_norm = norm2(m_x0);
+    LinearOperator jacobian = LinearOperator::matvec(
+        [this, &l, variable, semilinear, t, n, x_norm, sqrt_eps](const std::vector<double>& x, std::vector<double>& y)
+        {
+            l.multiply(x, y);
+            const double x_direction_norm = norm2(x);
+            if (x_direction_norm == 0.0)
+                return;
+            const double epsilon = sqrt_eps * (1.0 + x_norm) / x_direction_norm;
+            m_perturbed.resize(n);
+            for (size_t i = 0; i < n; i++)
+                m_perturbed[i] = m_x0[i] + epsilon * x[i];
+            evaluate_nonlinear(variable, semilinear, t, m_perturbed, m_n_perturbed);
+            for (size_t i = 0; i < n; i++)
+                y[i] += (m_n_perturbed[i] - m_n0[i]) / epsilon;
+        },
+        n
+    );
+
+    m_v.resize(3);
+    m_v[0].assign(n, 0.0);
+    m_v[1].resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_v[1][i] = m_lx[i] + m_n0[i];
+    m_v[2] = m_nt;
+    m_phi.calculate(jacobian, dt, m_v, m_delta);
+
+    m_evaluator.restore(m_x0, m_delta);
+}
+
+int ExponentialRosenbrockEulerIterator::method_order() const
+{
+    return 2;
+}
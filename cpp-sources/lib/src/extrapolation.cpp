@@ -0,0 +1,200 @@
+#include "dsiterpp/extrapolation.hpp"
+#include "dsiterpp/thread-pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace dsiterpp;
+
+namespace {
+
+size_t substeps_count(size_t sequence_index)
+{
+    return 2 * (sequence_index + 1);
+}
+
+}
+
+GraggBulirschStoerIterator::GraggBulirschStoerIterator() :
+    m_columns(m_parameters.initial_columns)
+{
+}
+
+GraggBulirschStoerIterator::~GraggBulirschStoerIterator()
+{
+}
+
+void GraggBulirschStoerIterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    extrapolate(variable, rhs, t, dt, m_columns, 0.0);
+}
+
+int GraggBulirschStoerIterator::method_order() const
+{
+    return static_cast<int>(2 * m_columns);
+}
+
+void GraggBulirschStoerIterator::calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt)
+{
+    // Tableau is built until step may be coarsened, so step grows while order allows it
+    size_t used = extrapolate(variable, rhs, t, dt, m_columns, m_target_error);
+    bool converged = m_target_error > 0.0 && m_last_error < m_target_error;
+
+    m_error.max_rel_error = m_last_error;
+    m_error.max_abs_error = 0.0;
+    for (size_t i = 0; i < m_delta.size(); i++)
+        m_error.max_abs_error = std::max(m_error.max_abs_error, m_last_error * (fabs(m_x0[i]) + fabs(m_delta[i])));
+
+    if (m_target_error == 0.0)
+        return;
+
+    // Tableau converged far before last column: use lower order. Converged only at last
+    // column or not converged at all: higher order allows bigger steps
+    if (converged && used + 1 < m_columns)
+        m_columns = std::max(m_columns - 1, m_parameters.min_columns);
+    else if (used == m_columns)
+        m_columns = std::min(m_columns + 1, m_parameters.max_columns);
+}
+
+void GraggBulirschStoerIterator::set_step_tolerance(double max_rel_error, double min_rel_error)
+{
+    m_target_error = min_rel_error > 0.0 ? min_rel_error : max_rel_error;
+}
+
+void GraggBulirschStoerIterator::set_parallel_rhs(FlatRHSFunction rhs, size_t threads_count)
+{
+    m_parallel_rhs = rhs;
+    m_thread_pool.reset(new ThreadPool(threads_count));
+}
+
+ExtrapolationParameters& GraggBulirschStoerIterator::parameters()
+{
+    return m_parameters;
+}
+
+size_t GraggBulirschStoerIterator::columns() const
+{
+    return m_columns;
+}
+
+size_t GraggBulirschStoerIterator::extrapolate(IVariable* variable, IRHS* rhs, double t, double dt, size_t columns, double tolerance) const
+{
+    const bool parallel = static_cast<bool>(m_parallel_rhs);
+
+    rhs->pre_iteration_job(t);
+    m_evaluator.set_target(variable, rhs);
+    m_evaluator.collect_values(m_x0);
+    const size_t n = m_x0.size();
+
+    if (parallel)
+        m_parallel_rhs(t, m_x0, m_f0);
+    else
+        m_evaluator.evaluate_current(t, m_f0);
+
+    if (m_sequences.size() < columns)
+    {
+        m_sequences.resize(columns);
+        m_row.resize(columns);
+        m_previous_row.resize(columns);
+    }
+
+    if (parallel)
+    {
+        // The longest sequences go first for better load balance
+        m_thread_pool->parallel_for(columns, [this, columns, t, dt](size_t index) {
+            calculate_sequence(columns - 1 - index, t, dt, true);
+        });
+    }
+
+    size_t used = 0;
+    m_last_error = 0.0;
+    for (size_t row = 0; row < columns; row++)
+    {
+        if (!parallel)
+            calculate_sequence(row, t, dt, false);
+
+        extrapolate_row(row);
+        used = row + 1;
+
+        if (row == 0)
+            continue;
+
+        // Error of T(row, row) estimated as difference with T(row, row-1)
+        const std::vector<double>& best = m_row[row];
+        const std::vector<double>& previous = m_row[row - 1];
+        m_last_error = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            double abs_error = fabs(best[i] - previous[i]);
+            double base_value = fabs(m_x0[i]) + fabs(best[i] - m_x0[i]);
+            m_last_error = std::max(m_last_error, abs_error / base_value);
+        }
+
+        if (tolerance > 0.0 && used >= m_parameters.min_columns && m_last_error < tolerance)
+            break;
+    }
+
+    const std::vector<double>& result = m_row[used - 1];
+    m_delta.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_delta[i] = result[i] - m_x0[i];
+
+    m_evaluator.restore(m_x0, m_delta);
+    return used;
+}
+
+void GraggBulirschStoerIterator::calculate_sequence(size_t index, double t, double dt, bool parallel) const
+{
+    // Modified midpoint rule with Gragg smoothing
+    Sequence& s = m_sequences[index];
+    const size_t n = m_x0.size();
+    const size_t substeps = substeps_count(index);
+    const double h = dt / substeps;
+
+    s.z_previous = m_x0;
+    s.z.resize(n);
+    for (size_t i = 0; i < n; i++)
+        s.z[i] = m_x0[i] + h * m_f0[i];
+
+    for (size_t m = 1; m < substeps; m++)
+    {
+        evaluate(t + m * h, s.z, s.f, parallel);
+        for (size_t i = 0; i < n; i++)
+            s.z_previous[i] += 2.0 * h * s.f[i];
+        s.z_previous.swap(s.z);
+    }
+
+    evaluate(t + dt, s.z, s.f, parallel);
+    s.result.resize(n);
+    for (size_t i = 0; i < n; i++)
+        s.result[i] = 0.5 * (s.z[i] + s.z_previous[i] + h * s.f[i]);
+}
+
+void GraggBulirschStoerIterator::evaluate(double t, const std::vector<double>& x, std::vector<double>& f, bool parallel) const
+{
+    if (parallel)
+        m_parallel_rhs(t, x, f);
+    else
+        m_evaluator.evaluate(t, x, f);
+}
+
+void GraggBulirschStoerIterator::extrapolate_row(size_t row) const
+{
+    // Aitken-Neville: T(row, k) = T(row, k-1) + (T(row, k-1) - T(row-1, k-1)) / ((n_row / n_{row-k})^2 - 1),
+    // m_row holds T(row, 0..row) after call, m_previous_row holds T(row-1, ...)
+    m_previous_row.swap(m_row);
+    const size_t n = m_x0.size();
+
+    m_row[0] = m_sequences[row].result;
+    for (size_t k = 1; k <= row; k++)
+    {
+        double ratio = double(substeps_count(row)) / substeps_count(row - k);
+        double factor = 1.0 / (ratio * ratio - 1.0);
+        const std::vector<double>& current = m_row[k - 1];
+        const std::vector<double>& previous = m_previous_row[k - 1];
+        std::vector<double>& target = m_row[k];
+        target.resize(n);
+        for (size_t i = 0; i < n; i++)
+            target[i] = current[i] + (current[i] - previous[i]) * factor;
+    }
+}
@@ -0,0 +1,216 @@
+#include "dsiterpp/incremental-rhs.hpp"
+#include "dsiterpp/partitioned-variable.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+using namespace dsiterpp;
+
+void IncrementalRHSGroup::add_rhs(IRHS* rhs, const std::vector<VariableScalar*>& inputs, bool time_dependent)
+{
+    size_t member = add_member(rhs, time_dependent);
+    for (auto variable : inputs)
+        add_reader(scalar_block(variable), member);
+}
+
+void IncrementalRHSGroup::add_rhs(IRHS* rhs, PartitionedVariable& variable, const std::vector<size_t>& partitions, bool time_dependent)
+{
+    size_t member = add_member(rhs, time_dependent);
+    for (size_t partition : partitions)
+        add_reader(partition_block(variable, partition), member);
+}
+
+void IncrementalRHSGroup::pre_iteration_job(double time)
+{
+    for (auto& member : m_members)
+        member.rhs->pre_iteration_job(time);
+}
+
+void IncrementalRHSGroup::pre_sub_iteration_job(double time)
+{
+    for (auto& member : m_members)
+        member.rhs->pre_sub_iteration_job(time);
+}
+
+void IncrementalRHSGroup::calculate_rhs(double time)
+{
+    m_call++;
+    if (!m_valid)
+    {
+        for (const auto& block : m_blocks)
+            remember_values(block);
+        for (size_t i = 0; i < m_members.size(); i++)
+            evaluate(i, time);
+        m_tracker.clear();
+        m_evaluated_time = time;
+        m_valid = true;
+        return;
+    }
+
+    // Only blocks changed by variables since last call are visited
+    m_to_evaluate.clear();
+    for (size_t index : m_tracker.dirty_blocks())
+    {
+        const Block& block = m_blocks[index];
+        m_visited_blocks++;
+        if (!is_changed(block))
+            continue;
+        for (size_t member : block.readers)
+        {
+            if (m_members[member].evaluated_call != m_call)
+            {
+                m_members[member].evaluated_call = m_call;
+                m_to_evaluate.push_back(member);
+            }
+        }
+        remember_values(block);
+    }
+    m_tracker.clear();
+
+    if (time != m_evaluated_time)
+    {
+        for (size_t member : m_time_dependent)
+        {
+            if (m_members[member].evaluated_call != m_call)
+            {
+                m_members[member].evaluated_call = m_call;
+                m_to_evaluate.push_back(member);
+            }
+        }
+    }
+
+    // Members are evaluated in order they were added, as in RHSGroup
+    std::sort(m_to_evaluate.begin(), m_to_evaluate.end());
+    for (size_t member : m_to_evaluate)
+        evaluate(member, time);
+    m_skipped += m_members.size() - m_to_evaluate.size();
+    m_evaluated_time = time;
+}
+
+void IncrementalRHSGroup::set_change_threshold(double threshold)
+{
+    m_threshold = threshold;
+}
+
+void IncrementalRHSGroup::invalidate()
+{
+    m_valid = false;
+}
+
+size_t IncrementalRHSGroup::evaluations_count() const
+{
+    return m_evaluations;
+}
+
+size_t IncrementalRHSGroup::skipped_count() const
+{
+    return m_skipped;
+}
+
+size_t IncrementalRHSGroup::visited_blocks_count() const
+{
+    return m_visited_blocks;
+}
+
+size_t IncrementalRHSGroup::add_member(IRHS* rhs, bool time_dependent)
+{
+    Member member;
+    member.rhs = rhs;
+    m_members.push_back(member);
+    if (time_dependent)
+        m_time_dependent.push_back(m_members.size() - 1);
+    m_valid = false;
+    return m_members.size() - 1;
+}
+
+size_t IncrementalRHSGroup::scalar_block(VariableScalar* variable)
+{
+    auto it = m_first_blocks.find(variable);
+    if (it != m_first_blocks.end())
+        return it->second;
+
+    Block block;
+    block.scalar = variable;
+    block.values_begin = m_evaluated_values.size();
+    block.values_size = 1;
+    m_evaluated_values.push_back(0.0);
+
+    size_t index = m_tracker.add_block();
+    m_blocks.push_back(block);
+    m_first_blocks[variable] = index;
+    variable->set_change_tracker(&m_tracker, index);
+    return index;
+}
+
+size_t IncrementalRHSGroup::partition_block(PartitionedVariable& variable, size_t partition)
+{
+    if (partition >= variable.partitions_count())
+        throw std::out_of_range("IncrementalRHSGroup: partition index is out of range");
+
+    auto it = m_first_blocks.find(&variable);
+    if (it != m_first_blocks.end())
+        return it->second + partition;
+
+    // Every partition is a block, they are added together
+    size_t first = m_tracker.blocks_count();
+    for (size_t i = 0; i < variable.partitions_count(); i++)
+    {
+        Block block;
+        block.partitioned = &variable;
+        block.partition = i;
+        block.values_begin = m_evaluated_values.size();
+        block.values_size = variable.partition(i).size;
+        m_evaluated_values.resize(m_evaluated_values.size() + block.values_size, 0.0);
+        m_tracker.add_block();
+        m_blocks.push_back(block);
+    }
+    m_first_blocks[&variable] = first;
+    variable.set_change_tracker(&m_tracker, first);
+    return first + partition;
+}
+
+void IncrementalRHSGroup::add_reader(size_t block, size_t member)
+{
+    std::vector<size_t>& readers = m_blocks[block].readers;
+    if (readers.empty() || readers.back() != member)
+        readers.push_back(member);
+}
+
+bool IncrementalRHSGroup::is_changed(const Block& block) const
+{
+    const double* evaluated = m_evaluated_values.data() + block.values_begin;
+    if (block.scalar)
+        return is_value_changed(block.scalar->current_value(), evaluated[0]);
+
+    const double* current = block.partitioned->partition(block.partition).current;
+    for (size_t i = 0; i < block.values_size; i++)
+    {
+        if (is_value_changed(current[i], evaluated[i]))
+            return true;
+    }
+    return false;
+}
+
+bool IncrementalRHSGroup::is_value_changed(double value, double evaluated) const
+{
+    return m_threshold == 0.0 ? value != evaluated : fabs(value - evaluated) > m_threshold;
+}
+
+void IncrementalRHSGroup::remember_values(const Block& block)
+{
+    double* evaluated = m_evaluated_values.data() + block.values_begin;
+    if (block.scalar)
+    {
+        evaluated[0] = block.scalar->current_value();
+        return;
+    }
+    const double* current = block.partitioned->partition(block.partition).current;
+    std::copy(current, current + block.values_size, evaluated);
+}
+
+void IncrementalRHSGroup::evaluate(size_t member, double time)
+{
+    m_members[member].rhs->calculate_rhs(time);
+    m_evaluations++;
+}
@@ -1,7 +1,60 @@
 #include "dsiterpp/integration.hpp"
 
+#include <stdexcept>
+#include <cstddef>
+
 using namespace dsiterpp;
 
+/////////////////////////////////
+// IVariable
+
+void IVariable::set_deltas(std::vector<double>::const_iterator& deltas)
+{
+    DSITERPP_UNUSED(deltas);
+    throw std::logic_error("IVariable::set_deltas() is not implemented by variable, it is needed by implicit integrators");
+}
+
+void IVariable::clear_rhs()
+{
+    throw std::logic_error("IVariable::clear_rhs() is not implemented by variable, it is needed by IMEX and splitting integrators");
+}
+
+/////////////////////////////////
+// ChangeTracker
+
+size_t ChangeTracker::add_block()
+{
+    m_dirty.push_back(0);
+    // Marking does not allocate after all blocks are added
+    m_dirty_blocks.reserve(m_dirty.size());
+    return m_dirty.size() - 1;
+}
+
+void ChangeTracker::mark_dirty(size_t block)
+{
+    if (m_dirty[block])
+        return;
+    m_dirty[block] = 1;
+    m_dirty_blocks.push_back(block);
+}
+
+const std::vector<size_t>& ChangeTracker::dirty_blocks() const
+{
+    return m_dirty_blocks;
+}
+
+void ChangeTracker::clear()
+{
+    for (size_t block : m_dirty_blocks)
+        m_dirty[block] = 0;
+    m_dirty_blocks.clear();
+}
+
+size_t ChangeTracker::blocks_count() const
+{
+    return m_dirty.size();
+}
+
 /////////////////////////////////
 // VariableScalar
 
@@ -11,9 +64,24 @@ VariableScalar::VariableScalar(double value) :
     clear_subiteration();
 }
 
+VariableScalar::VariableScalar(const VariableScalar& other) :
+    m_previous_value(other.m_previous_value), m_current_value(other.m_current_value),
+    m_delta(other.m_delta), m_rhs(other.m_rhs)
+{
+}
+
+VariableScalar& VariableScalar::operator=(const VariableScalar& other)
+{
+    m_previous_value = other.m_previous_value;
+    set_current(other.m_current_value);
+    m_delta = other.m_delta;
+    m_rhs = other.m_rhs;
+    return *this;
+}
+
 void VariableScalar::clear_subiteration()
 {
-    m_current_value = m_previous_value; m_delta = 0.0;
+    set_current(m_previous_value); m_delta = 0.0;
 }
 
 void VariableScalar::add_rhs_to_delta(double m)
@@ -23,12 +91,13 @@ void VariableScalar::add_rhs_to_delta(double m)
 
 void VariableScalar::make_sub_iteration(double dt)
 {
-    m_current_value = m_previous_value + m_rhs * dt;
+    set_current(m_previous_value + m_rhs * dt);
 }
 
 void VariableScalar::step()
 {
-    m_current_value = m_previous_value = m_previous_value + m_delta;
+    m_previous_value = m_previous_value + m_delta;
+    set_current(m_previous_value);
     m_delta = 0.0;
 }
 
@@ -47,6 +116,16 @@ void VariableScalar::set_values(std::vector<double>::const_iterator& values)
     m_previous_value = *(values++); clear_subiteration();
 }
 
+void VariableScalar::set_deltas(std::vector<double>::const_iterator& deltas)
+{
+    m_delta = *(deltas++);
+}
+
+void VariableScalar::clear_rhs()
+{
+    m_rhs = 0.0;
+}
+
 double VariableScalar::current_value()
 {
     return m_current_value;
@@ -57,6 +136,24 @@ void VariableScalar::set_rhs(double rhs)
     m_rhs = rhs;
 }
 
+void VariableScalar::add_to_rhs(double rhs)
+{
+    m_rhs += rhs;
+}
+
+void VariableScalar::set_change_tracker(ChangeTracker* tracker, size_t block)
+{
+    m_tracker = tracker;
+    m_block = block;
+}
+
+void VariableScalar::set_current(double value)
+{
+    if (m_tracker != nullptr && value != m_current_value)
+        m_tracker->mark_dirty(m_block);
+    m_current_value = value;
+}
+
 VariableScalar::operator double&()
 {
     return m_previous_value;
@@ -116,9 +213,29 @@ void VariablesGroup::set_values(std::vector<double>::const_iterator& values)
     }
 }
 
-void RHSGroup::add_rhs(IRHS* rhs)
+void VariablesGroup::set_deltas(std::vector<double>::const_iterator& deltas)
+{
+    for (auto &var : m_variables) {
+        var->set_deltas(deltas);
+    }
+}
+
+void VariablesGroup::clear_rhs()
+{
+    for (auto &var : m_variables) {
+        var->clear_rhs();
+    }
+}
+
+void RHSGroup::add_rhs(IRHS* rhs, Treatment treatment)
 {
     m_RHSs.push_back(rhs);
+    m_treatments.push_back(treatment);
+}
+
+void RHSGroup::set_variable(IVariable* variable)
+{
+    m_variable = variable;
 }
 
 void RHSGroup::pre_iteration_job(double time)
@@ -139,12 +256,35 @@ void RHSGroup::pre_sub_iteration_job(double time)
 
 void RHSGroup::calculate_rhs(double time)
 {
+    if (m_variable)
+        m_variable->clear_rhs();
     for (auto rhs : m_RHSs)
     {
         rhs->calculate_rhs(time);
     }
 }
 
+void RHSGroup::calculate_rhs(double time, Treatment treatment)
+{
+    if (m_variable)
+        m_variable->clear_rhs();
+    for (std::size_t i = 0; i < m_RHSs.size(); i++)
+    {
+        if (m_treatments[i] == treatment)
+            m_RHSs[i]->calculate_rhs(time);
+    }
+}
+
+bool RHSGroup::has_part(Treatment treatment) const
+{
+    for (auto item : m_treatments)
+    {
+        if (item == treatment)
+            return true;
+    }
+    return false;
+}
+
 
 /////////////////////////////////
 // RHSScalar
@@ -0,0 +1,163 @@
+#include "dsiterpp/krylov.hpp"
+
+#include <cmath>
+
+using namespace dsiterpp;
+
+double dsiterpp::dot(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double result = 0.0;
+    for (size_t i = 0; i < a.size(); i++)
+        result += a[i] * b[i];
+    return result;
+}
+
+double dsiterpp::norm2(const std::vector<double>& a)
+{
+    return sqrt(dot(a, a));
+}
+
+void GMRESSolver::set_krylov_dimension(size_t dimension)
+{
+    m_krylov_dimension = dimension;
+}
+
+void GMRESSolver::set_max_restarts(size_t restarts)
+{
+    m_max_restarts = restarts;
+}
+
+void GMRESSolver::set_tolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+
+bool GMRESSolver::solve(const Operator& a, const Operator& preconditioner, const std::vector<double>& b, std::vector<double>& x)
+{
+    const size_t n = b.size();
+    const size_t m = m_krylov_dimension;
+
+    x.assign(n, 0.0);
+    m_iterations = 0;
+    m_residual = 0.0;
+
+    const double b_norm = norm2(b);
+    if (b_norm == 0.0)
+        return true;
+
+    m_basis.resize(m + 1);
+    for (auto &v : m_basis)
+        v.resize(n);
+    m_hessenberg.resize(m + 1);
+    for (auto &row : m_hessenberg)
+        row.assign(m, 0.0);
+    m_g.resize(m + 1);
+    m_cos.resize(m);
+    m_sin.resize(m);
+    m_y.resize(m);
+
+    // r = b - A x, zero x at first cycle
+    m_w = b;
+    for (size_t restart = 0; restart <= m_max_restarts; restart++)
+    {
+        if (restart != 0)
+        {
+            a(x, m_w);
+            m_iterations++;
+            for (size_t i = 0; i < n; i++)
+                m_w[i] = b[i] - m_w[i];
+        }
+
+        double beta = norm2(m_w);
+        m_residual = beta / b_norm;
+        if (m_residual <= m_tolerance)
+            return true;
+
+        for (size_t i = 0; i < n; i++)
+            m_basis[0][i] = m_w[i] / beta;
+        m_g.assign(m + 1, 0.0);
+        m_g[0] = beta;
+
+        // Arnoldi process with modified Gram-Schmidt and Givens rotations
+        size_t columns = 0;
+        for (size_t j = 0; j < m; j++)
+        {
+            if (preconditioner)
+            {
+                preconditioner(m_basis[j], m_z);
+                a(m_z, m_w);
+            } else {
+                a(m_basis[j], m_w);
+            }
+            m_iterations++;
+
+            for (size_t i = 0; i <= j; i++)
+            {
+                double h = dot(m_w, m_basis[i]);
+                m_hessenberg[i][j] = h;
+                for (size_t k = 0; k < n; k++)
+                    m_w[k] -= h * m_basis[i][k];
+            }
+            double h_next = norm2(m_w);
+
+            for (size_t i = 0; i < j; i++)
+            {
+                double temp = m_cos[i] * m_hessenberg[i][j] + m_sin[i] * m_hessenberg[i + 1][j];
+                m_hessenberg[i + 1][j] = - m_sin[i] * m_hessenberg[i][j] + m_cos[i] * m_hessenberg[i + 1][j];
+                m_hessenberg[i][j] = temp;
+            }
+            double r = sqrt(m_hessenberg[j][j] * m_hessenberg[j][j] + h_next * h_next);
+            m_cos[j] = m_hessenberg[j][j] / r;
+            m_sin[j] = h_next / r;
+            m_hessenberg[j][j] = r;
+            m_g[j + 1] = - m_sin[j] * m_g[j];
+            m_g[j] = m_cos[j] * m_g[j];
+            columns = j + 1;
+
+            m_residual = fabs(m_g[j + 1]) / b_norm;
+            if (m_residual <= m_tolerance || h_next == 0.0)
+                break;
+
+            for (size_t k = 0; k < n; k++)
+                m_basis[j + 1][k] = m_w[k] / h_next;
+        }
+
+        // Solve upper triangular system H y = g
+        for (size_t i = columns; i-- > 0; )
+        {
+            double sum = m_g[i];
+            for (size_t k = i + 1; k < columns; k++)
+                sum -= m_hessenberg[i][k] * m_y[k];
+            m_y[i] = sum / m_hessenberg[i][i];
+        }
+
+        m_update.assign(n, 0.0);
+        for (size_t i = 0; i < columns; i++)
+            for (size_t k = 0; k < n; k++)
+                m_update[k] += m_y[i] * m_basis[i][k];
+
+        if (preconditioner)
+        {
+            preconditioner(m_update, m_z);
+            for (size_t k = 0; k < n; k++)
+                x[k] += m_z[k];
+        } else {
+            for (size_t k = 0; k < n; k++)
+                x[k] += m_update[k];
+        }
+
+        if (m_residual <= m_tolerance)
+            return true;
+    }
+    return false;
+}
+
+size_t GMRESSolver::iterations() const
+{
+    return m_iterations;
+}
+
+double GMRESSolver::residual() const
+{
+    return m_residual;
+}
@@ -0,0 +1,302 @@
+#include "dsiterpp/partitioned-variable.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+using namespace dsiterpp;
+
+namespace {
+    // Blocks are multiples of cache line, so partitions never share lines of arrays
+    const size_t doubles_per_cache_line = 8;
+
+    /**
+     * Apply update(i) to every component of partition. If changed is not nullptr,
+     * it is set for partition when any current value was changed
+     */
+    template<typename Update>
+    void update_partition(const PartitionedVariable::Partition& p, char* changed, const Update& update)
+    {
+        if (changed == nullptr)
+        {
+            for (size_t i = 0; i < p.size; i++)
+                update(i);
+            return;
+        }
+        bool any = false;
+        for (size_t i = 0; i < p.size; i++)
+        {
+            const double before = p.current[i];
+            update(i);
+            any = any || p.current[i] != before;
+        }
+        changed[p.index] = any;
+    }
+}
+
+/////////////////////////
+// PartitionedVariable
+
+PartitionedVariable::PartitionedVariable(size_t size, PinnedThreadPool& pool) :
+    m_pool(pool), m_size(size)
+{
+    const size_t count = pool.threads_count();
+    m_block_size = (size + count - 1) / count;
+    m_block_size = (m_block_size + doubles_per_cache_line - 1) / doubles_per_cache_line * doubles_per_cache_line;
+    m_block_size = std::max(m_block_size, doubles_per_cache_line);
+
+    m_partitions.resize(count);
+    m_memory.resize(count);
+    m_changed.resize(count, 0);
+
+    // Zero initialization by worker is the first touch, so pages go to its NUMA node
+    m_pool.run_on_each([this](size_t index) {
+        Partition& partition = m_partitions[index];
+        partition.index = index;
+        partition.begin = std::min(index * m_block_size, m_size);
+        partition.size = std::min(m_block_size, m_size - partition.begin);
+
+        m_memory[index].reset(new double[4 * m_block_size]());
+        double* memory = m_memory[index].get();
+        partition.previous = memory;
+        partition.current = memory + m_block_size;
+        partition.delta = memory + 2 * m_block_size;
+        partition.rhs = memory + 3 * m_block_size;
+    });
+}
+
+void PartitionedVariable::clear_subiteration()
+{
+    char* changed = m_tracker ? m_changed.data() : nullptr;
+    for_each_partition([changed](const Partition& p) {
+        update_partition(p, changed, [&p](size_t i) {
+            p.current[i] = p.previous[i];
+            p.delta[i] = 0.0;
+        });
+    });
+    mark_changed_partitions();
+}
+
+void PartitionedVariable::add_rhs_to_delta(double m)
+{
+    for_each_partition([m](const Partition& p) {
+        for (size_t i = 0; i < p.size; i++)
+            p.delta[i] += p.rhs[i] * m;
+    });
+}
+
+void PartitionedVariable::make_sub_iteration(double dt)
+{
+    char* changed = m_tracker ? m_changed.data() : nullptr;
+    for_each_partition([changed, dt](const Partition& p) {
+        update_partition(p, changed, [&p, dt](size_t i) {
+            p.current[i] = p.previous[i] + p.rhs[i] * dt;
+        });
+    });
+    mark_changed_partitions();
+}
+
+void PartitionedVariable::step()
+{
+    char* changed = m_tracker ? m_changed.data() : nullptr;
+    for_each_partition([changed](const Partition& p) {
+        update_partition(p, changed, [&p](size_t i) {
+            p.current[i] = p.previous[i] = p.previous[i] + p.delta[i];
+            p.delta[i] = 0.0;
+        });
+    });
+    mark_changed_partitions();
+}
+
+void PartitionedVariable::collect_values(std::vector<double>& values) const
+{
+    const size_t offset = values.size();
+    values.resize(offset + m_size);
+    double* target = values.data() + offset;
+    for_each_partition([target](const Partition& p) {
+        std::copy(p.current, p.current + p.size, target + p.begin);
+    });
+}
+
+void PartitionedVariable::collect_deltas(std::vector<double>& deltas) const
+{
+    const size_t offset = deltas.size();
+    deltas.resize(offset + m_size);
+    double* target = deltas.data() + offset;
+    for_each_partition([target](const Partition& p) {
+        std::copy(p.delta, p.delta + p.size, target + p.begin);
+    });
+}
+
+void PartitionedVariable::set_values(std::vector<double>::const_iterator& values)
+{
+    if (m_size == 0)
+        return;
+    const double* source = &(*values);
+    char* changed = m_tracker ? m_changed.data() : nullptr;
+    for_each_partition([source, changed](const Partition& p) {
+        update_partition(p, changed, [&p, source](size_t i) {
+            p.current[i] = p.previous[i] = source[p.begin + i];
+            p.delta[i] = 0.0;
+        });
+    });
+    mark_changed_partitions();
+    values += m_size;
+}
+
+void PartitionedVariable::set_deltas(std::vector<double>::const_iterator& deltas)
+{
+    if (m_size == 0)
+        return;
+    const double* source = &(*deltas);
+    for_each_partition([source](const Partition& p) {
+        std::copy(source + p.begin, source + p.begin + p.size, p.delta);
+    });
+    deltas += m_size;
+}
+
+void PartitionedVariable::clear_rhs()
+{
+    for_each_partition([](const Partition& p) {
+        std::fill(p.rhs, p.rhs + p.size, 0.0);
+    });
+}
+
+void PartitionedVariable::for_each_partition(const PartitionTask& task) const
+{
+    if (m_size == 0)
+        return;
+    m_pool.run_on_each([this, &task](size_t index) { task(m_partitions[index]); });
+}
+
+size_t PartitionedVariable::size() const
+{
+    return m_size;
+}
+
+size_t PartitionedVariable::partitions_count() const
+{
+    return m_partitions.size();
+}
+
+const PartitionedVariable::Partition& PartitionedVariable::partition(size_t index) const
+{
+    return m_partitions[index];
+}
+
+PinnedThreadPool& PartitionedVariable::pool()
+{
+    return m_pool;
+}
+
+double PartitionedVariable::current_value(size_t index) const
+{
+    return m_partitions[index / m_block_size].current[index % m_block_size];
+}
+
+void PartitionedVariable::set_rhs(size_t index, double rhs)
+{
+    m_partitions[index / m_block_size].rhs[index % m_block_size] = rhs;
+}
+
+double& PartitionedVariable::value(size_t index)
+{
+    return m_partitions[index / m_block_size].previous[index % m_block_size];
+}
+
+void PartitionedVariable::set_change_tracker(ChangeTracker* tracker, size_t first_block)
+{
+    m_tracker = tracker;
+    m_first_block = first_block;
+}
+
+void PartitionedVariable::mark_changed_partitions()
+{
+    if (m_tracker == nullptr || m_size == 0)
+        return;
+    for (size_t i = 0; i < m_changed.size(); i++)
+    {
+        if (m_changed[i])
+            m_tracker->mark_dirty(m_first_block + i);
+    }
+}
+
+/////////////////////////
+// PartitionedRHS
+
+PartitionedRHS::PartitionedRHS(PartitionedVariable& variable, RHSFunction rhs) :
+    m_variable(variable), m_rhs_function(rhs)
+{
+}
+
+void PartitionedRHS::calculate_rhs(double time)
+{
+    m_variable.for_each_partition([this, time](const PartitionedVariable::Partition& p) {
+        m_rhs_function(time, p);
+    });
+}
+
+/////////////////////////
+// PartitionedRungeErrorEstimator
+
+void PartitionedRungeErrorEstimator::set_integrator(IIntegrator* integrator)
+{
+    ErrorEstimatorBase::set_integrator(integrator);
+    m_error_multiplier = 1.0 / (pow(2, m_integrator->method_order()) - 1);
+}
+
+void PartitionedRungeErrorEstimator::calculate_delta_and_estimate(IVariable* variable, IRHS* rhs, double t, double dt)
+{
+    PartitionedVariable* partitioned = dynamic_cast<PartitionedVariable*>(variable);
+    if (partitioned == nullptr)
+        throw std::invalid_argument("PartitionedRungeErrorEstimator: variable should be PartitionedVariable");
+
+    // Scratch buffers are resized by workers, so they are local to partitions too
+    m_scratch.resize(partitioned->partitions_count());
+
+    partitioned->for_each_partition([this](const PartitionedVariable::Partition& p) {
+        m_scratch[p.index].values.assign(p.current, p.current + p.size);
+    });
+
+    m_integrator->calculate_delta(variable, rhs, t, dt / 2.0);
+    partitioned->for_each_partition([this](const PartitionedVariable::Partition& p) {
+        m_scratch[p.index].deltas_h_2_part_1.assign(p.delta, p.delta + p.size);
+    });
+    variable->step();
+
+    m_integrator->calculate_delta(variable, rhs, t + dt / 2.0, dt / 2.0);
+    partitioned->for_each_partition([this](const PartitionedVariable::Partition& p) {
+        Scratch& scratch = m_scratch[p.index];
+        scratch.deltas_h_2_part_2.assign(p.delta, p.delta + p.size);
+        for (size_t i = 0; i < p.size; i++)
+        {
+            p.current[i] = p.previous[i] = scratch.values[i];
+            p.delta[i] = 0.0;
+        }
+    });
+
+    m_integrator->calculate_delta(variable, rhs, t, dt);
+    partitioned->for_each_partition([this](const PartitionedVariable::Partition& p) {
+        Scratch& scratch = m_scratch[p.index];
+        scratch.error = IntegrationError();
+        for (size_t i = 0; i < p.size; i++)
+        {
+            double abs_error = fabs(p.delta[i] - (scratch.deltas_h_2_part_1[i] + scratch.deltas_h_2_part_2[i])) * m_error_multiplier;
+            double base_value = fabs(scratch.values[i]) + fabs(p.delta[i]);
+            double rel_error = abs_error / base_value;
+
+            if (rel_error > scratch.error.max_rel_error)
+                scratch.error.max_rel_error = rel_error;
+
+            if (abs_error > scratch.error.max_abs_error)
+                scratch.error.max_abs_error = abs_error;
+        }
+    });
+
+    m_error = IntegrationError();
+    for (const Scratch& scratch : m_scratch)
+    {
+        m_error.max_rel_error = std::max(m_error.max_rel_error, scratch.error.max_rel_error);
+        m_error.max_abs_error = std::max(m_error.max_abs_error, scratch.error.max_abs_error);
+    }
+}
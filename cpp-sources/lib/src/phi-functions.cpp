@@ -0,0 +1,318 @@
+#include "dsiterpp/phi-functions.hpp"
+#include "dsiterpp/krylov.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+using namespace dsiterpp;
+
+namespace {
+
+void multiply_matrices(const DenseMatrix& a, const DenseMatrix& b, DenseMatrix& result)
+{
+    const size_t n = a.size();
+    result.resize(n);
+    result.set_zero();
+    for (size_t i = 0; i < n; i++)
+        for (size_t k = 0; k < n; k++)
+        {
+            const double a_ik = a(i, k);
+            if (a_ik == 0.0)
+                continue;
+            for (size_t j = 0; j < n; j++)
+                result(i, j) += a_ik * b(k, j);
+        }
+}
+
+}
+
+double dsiterpp::phi_function(size_t k, double z)
+{
+    if (fabs(z) < 1.0)
+    {
+        // phi_k(z) = sum_j z^j / (j + k)!
+        double term = 1.0;
+        for (size_t j = 2; j <= k; j++)
+            term /= j;
+        double sum = term;
+        for (size_t j = 1; j < 30; j++)
+        {
+            term *= z / (j + k);
+            sum += term;
+            if (fabs(term) < 1e-17 * fabs(sum))
+                break;
+        }
+        return sum;
+    }
+
+    double phi = exp(z);
+    double inverse_factorial = 1.0;
+    for (size_t j = 0; j < k; j++)
+    {
+        if (j > 1)
+            inverse_factorial /= j;
+        phi = (phi - inverse_factorial) / z;
+    }
+    return phi;
+}
+
+void dsiterpp::matrix_exponential(const DenseMatrix& a, DenseMatrix& result)
+{
+    const size_t n = a.size();
+    const int degree = 6;
+
+    double norm = 0.0;
+    for (size_t i = 0; i < n; i++)
+    {
+        double row_sum = 0.0;
+        for (size_t j = 0; j < n; j++)
+            row_sum += fabs(a(i, j));
+        norm = std::max(norm, row_sum);
+    }
+
+    int squarings = norm > 0.5 ? std::max(0, static_cast<int>(ceil(log2(norm))) + 1) : 0;
+    const double scale = ldexp(1.0, -squarings);
+
+    DenseMatrix scaled(n), power(n), temp(n), numerator(n), denominator(n);
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++)
+            scaled(i, j) = a(i, j) * scale;
+
+    // N = sum c_j A^j, D = sum (-1)^j c_j A^j
+    numerator.set_zero();
+    denominator.set_zero();
+    power.set_zero();
+    for (size_t i = 0; i < n; i++)
+    {
+        power(i, i) = 1.0;
+        numerator(i, i) = 1.0;
+        denominator(i, i) = 1.0;
+    }
+    double c = 1.0;
+    for (int j = 1; j <= degree; j++)
+    {
+        c *= static_cast<double>(degree - j + 1) / (j * (2 * degree - j + 1));
+        multiply_matrices(power, scaled, temp);
+        std::swap(power, temp);
+        const double sign = (j % 2 == 0) ? 1.0 : -1.0;
+        for (size_t i = 0; i < n; i++)
+            for (size_t k = 0; k < n; k++)
+            {
+                numerator(i, k) += c * power(i, k);
+                denominator(i, k) += sign * c * power(i, k);
+            }
+    }
+
+    // exp(A) ~ D^-1 N
+    LUDecomposition lu;
+    lu.decompose(denominator);
+    result.resize(n);
+    std::vector<double> column(n);
+    for (size_t j = 0; j < n; j++)
+    {
+        for (size_t i = 0; i < n; i++)
+            column[i] = numerator(i, j);
+        lu.solve(column);
+        for (size_t i = 0; i < n; i++)
+            result(i, j) = column[i];
+    }
+
+    for (int s = 0; s < squarings; s++)
+    {
+        multiply_matrices(result, result, temp);
+        std::swap(result, temp);
+    }
+}
+
+/////////////////////////
+// PhiCombination
+
+void PhiCombination::set_krylov_dimension(size_t dimension)
+{
+    m_krylov_dimension = dimension;
+}
+
+void PhiCombination::set_tolerance(double tolerance)
+{
+    m_tolerance = tolerance;
+}
+
+void PhiCombination::calculate(const LinearOperator& a, double t, const std::vector<std::vector<double>>& v, std::vector<double>& u)
+{
+    if (v.empty())
+        throw std::invalid_argument("PhiCombination: at least v_0 should be given");
+
+    m_matvec_count = 0;
+    m_substeps_count = 1;
+    if (a.type() == LinearOperator::Type::diagonal)
+    {
+        calculate_diagonal(a.diagonal_values(), t, v, u);
+        return;
+    }
+
+    const size_t p = v.size() - 1;
+    const size_t n = v[0].size();
+    m_w.resize(p + 1);
+
+    for (size_t substeps = 1; substeps <= (1u << 16); substeps *= 2)
+    {
+        const double tau = t / substeps;
+        m_u = v[0];
+        bool converged = true;
+        for (size_t s = 0; s < substeps; s++)
+        {
+            // Forcing sum t^(k-1)/(k-1)! v_k expanded at time of substep beginning
+            const double current = s * tau;
+            for (size_t k = 1; k <= p; k++)
+            {
+                m_w[k] = v[k];
+                double coefficient = 1.0;
+                for (size_t l = 1; k + l <= p; l++)
+                {
+                    coefficient *= current / l;
+                    for (size_t i = 0; i < n; i++)
+                        m_w[k][i] += coefficient * v[k + l][i];
+                }
+            }
+
+            double error = krylov_step(a, tau, m_w, m_u);
+            if (error > m_tolerance * (norm2(m_u) + 1e-300))
+            {
+                converged = false;
+                break;
+            }
+        }
+
+        if (converged)
+        {
+            m_substeps_count = substeps;
+            u = m_u;
+            return;
+        }
+    }
+    throw std::runtime_error("PhiCombination: Krylov approximation does not converge");
+}
+
+size_t PhiCombination::matvec_count() const
+{
+    return m_matvec_count;
+}
+
+size_t PhiCombination::substeps_count() const
+{
+    return m_substeps_count;
+}
+
+void PhiCombination::calculate_diagonal(const std::vector<double>& diagonal, double t, const std::vector<std::vector<double>>& v, std::vector<double>& u)
+{
+    const size_t n = diagonal.size();
+    u.assign(n, 0.0);
+    for (size_t i = 0; i < n; i++)
+    {
+        double t_power = 1.0;
+        for (size_t k = 0; k < v.size(); k++)
+        {
+            u[i] += t_power * phi_function(k, t * diagonal[i]) * v[k][i];
+            t_power *= t;
+        }
+    }
+}
+
+double PhiCombination::krylov_step(const LinearOperator& a, double tau, const std::vector<std::vector<double>>& w, std::vector<double>& u)
+{
+    const size_t n = u.size();
+    const size_t p = w.size() - 1;
+    const size_t size = n + p;
+    const size_t m = std::min(m_krylov_dimension, size);
+
+    m_basis.resize(m + 1);
+    for (auto &vector : m_basis)
+        vector.resize(size);
+
+    std::copy(u.begin(), u.end(), m_basis[0].begin());
+    std::fill(m_basis[0].begin() + n, m_basis[0].end(), 0.0);
+    if (p != 0)
+        m_basis[0][size - 1] = 1.0;
+
+    const double beta = norm2(m_basis[0]);
+    if (beta == 0.0)
+    {
+        std::fill(u.begin(), u.end(), 0.0);
+        return 0.0;
+    }
+    for (auto &value : m_basis[0])
+        value /= beta;
+
+    // Arnoldi process
+    m_hessenberg.resize(m + 1);
+    m_hessenberg.set_zero();
+    size_t dimension = m;
+    bool breakdown = false;
+    for (size_t j = 0; j < m; j++)
+    {
+        augmented_product(a, w, m_basis[j], m_basis[j + 1]);
+        std::vector<double>& next = m_basis[j + 1];
+        for (size_t i = 0; i <= j; i++)
+        {
+            double h = dot(next, m_basis[i]);
+            m_hessenberg(i, j) = h;
+            for (size_t k = 0; k < size; k++)
+                next[k] -= h * m_basis[i][k];
+        }
+        double h_next = norm2(next);
+        m_hessenberg(j + 1, j) = h_next;
+        if (h_next <= 1e-12 * beta)
+        {
+            // Invariant subspace is found, approximation is exact
+            dimension = j + 1;
+            breakdown = true;
+            break;
+        }
+        for (auto &value : next)
+            value /= h_next;
+    }
+
+    DenseMatrix small(dimension);
+    for (size_t i = 0; i < dimension; i++)
+        for (size_t j = 0; j < dimension; j++)
+            small(i, j) = tau * m_hessenberg(i, j);
+    matrix_exponential(small, m_exponential);
+
+    std::fill(u.begin(), u.end(), 0.0);
+    for (size_t j = 0; j < dimension; j++)
+    {
+        const double coefficient = beta * m_exponential(j, 0);
+        for (size_t i = 0; i < n; i++)
+            u[i] += coefficient * m_basis[j][i];
+    }
+
+    if (breakdown)
+        return 0.0;
+    return beta * tau * m_hessenberg(dimension, dimension - 1) * fabs(m_exponential(dimension - 1, 0));
+}
+
+void PhiCombination::augmented_product(const LinearOperator& a, const std::vector<std::vector<double>>& w, const std::vector<double>& x, std::vector<double>& y)
+{
+    // [A, (w_p ... w_1)] top block, shift matrix bottom block
+    const size_t n = a.size();
+    const size_t p = w.size() - 1;
+
+    m_top.assign(x.begin(), x.begin() + n);
+    a.multiply(m_top, m_product);
+    m_matvec_count++;
+
+    y.resize(n + p);
+    std::copy(m_product.begin(), m_product.end(), y.begin());
+    for (size_t i = 0; i < p; i++)
+    {
+        const double coefficient = x[n + i];
+        if (coefficient == 0.0)
+            continue;
+        const std::vector<double>& column = w[p - i];
+        for (size_t k = 0; k < n; k++)
+            y[k] += coefficient * column[k];
+    }
+    for (size_t i = 0; i < p; i++)
+        y[n + i] = i + 1 < p ? x[n + i + 1] : 0.0;
+}
@@ -0,0 +1,64 @@
+#include "dsiterpp/rhs-evaluator.hpp"
+#include "dsiterpp/integration.hpp"
+
+using namespace dsiterpp;
+
+void RHSEvaluator::set_target(IVariable* variable, IRHS* rhs)
+{
+    m_variable = variable;
+    m_rhs = rhs;
+}
+
+void RHSEvaluator::collect_values(std::vector<double>& values)
+{
+    values.clear();
+    m_variable->collect_values(values);
+}
+
+void RHSEvaluator::evaluate(double t, const std::vector<double>& x, std::vector<double>& f)
+{
+    auto it = x.cbegin();
+    m_variable->set_values(it);
+    evaluate_current(t, f);
+}
+
+void RHSEvaluator::evaluate_current(double t, std::vector<double>& f)
+{
+    m_rhs->pre_sub_iteration_job(t);
+    m_rhs->calculate_rhs(t);
+    m_variable->clear_subiteration();
+    m_variable->add_rhs_to_delta(1.0);
+    f.clear();
+    m_variable->collect_deltas(f);
+    m_variable->clear_subiteration();
+    m_evaluations_count++;
+}
+
+void RHSEvaluator::restore(const std::vector<double>& x, const std::vector<double>& delta)
+{
+    auto it = x.cbegin();
+    m_variable->set_values(it);
+    auto delta_it = delta.cbegin();
+    m_variable->set_deltas(delta_it);
+}
+
+void RHSEvaluator::restore(const std::vector<double>& x)
+{
+    auto it = x.cbegin();
+    m_variable->set_values(it);
+}
+
+IVariable* RHSEvaluator::variable()
+{
+    return m_variable;
+}
+
+IRHS* RHSEvaluator::rhs()
+{
+    return m_rhs;
+}
+
+size_t RHSEvaluator::evaluations_count()
+{
+    return m_evaluations_count;
+}
@@ -0,0 +1,192 @@
+#include "dsiterpp/sde.hpp"
+
+#include <stdexcept>
+#include <cmath>
+
+using namespace dsiterpp;
+
+/////////////////////////
+// StochasticIntegratorBase
+
+void StochasticIntegratorBase::set_seed(uint32_t seed, uint32_t stream)
+{
+    m_generator.set_seed(seed, stream);
+}
+
+void StochasticIntegratorBase::set_step_index(uint64_t step_index)
+{
+    m_step_index = step_index;
+}
+
+uint64_t StochasticIntegratorBase::step_index() const
+{
+    return m_step_index;
+}
+
+void StochasticIntegratorBase::step_done(double time, double dt, IteratingMetrics& metrics)
+{
+    DSITERPP_UNUSED(time); DSITERPP_UNUSED(dt); DSITERPP_UNUSED(metrics);
+    m_step_index++;
+}
+
+IStochasticRHS* StochasticIntegratorBase::stochastic_rhs(IRHS* rhs)
+{
+    IStochasticRHS* result = dynamic_cast<IStochasticRHS*>(rhs);
+    if (result == nullptr)
+        throw std::invalid_argument("Stochastic integrator needs RHS implementing IStochasticRHS");
+    return result;
+}
+
+void StochasticIntegratorBase::set_state(IVariable* variable, const std::vector<double>& x)
+{
+    auto it = x.cbegin();
+    variable->set_values(it);
+}
+
+void StochasticIntegratorBase::drift(IVariable* variable, IStochasticRHS* rhs, double t, std::vector<double>& f)
+{
+    rhs->pre_sub_iteration_job(t);
+    rhs->calculate_rhs(t);
+    variable->clear_subiteration();
+    variable->add_rhs_to_delta(1.0);
+    f.clear();
+    variable->collect_deltas(f);
+    variable->clear_subiteration();
+}
+
+void StochasticIntegratorBase::diffusion(IVariable* variable, IStochasticRHS* rhs, double t, std::vector<double>& g)
+{
+    rhs->calculate_diffusion(t);
+    variable->clear_subiteration();
+    variable->add_rhs_to_delta(1.0);
+    g.clear();
+    variable->collect_deltas(g);
+    variable->clear_subiteration();
+}
+
+void StochasticIntegratorBase::draw_normals(size_t count, std::vector<double>& normals) const
+{
+    normals.resize(count);
+    m_generator.fill(m_step_index, normals.data(), count);
+}
+
+/////////////////////////
+// EulerMaruyamaIterator
+
+void EulerMaruyamaIterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    IStochasticRHS* srhs = stochastic_rhs(rhs);
+    rhs->pre_iteration_job(t);
+
+    drift(variable, srhs, t, m_f);
+    diffusion(variable, srhs, t, m_g);
+
+    const size_t n = m_f.size();
+    draw_normals(n, m_normals);
+    const double sqrt_dt = sqrt(dt);
+    m_delta.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_delta[i] = m_f[i] * dt + m_g[i] * sqrt_dt * m_normals[i];
+
+    auto it = m_delta.cbegin();
+    variable->set_deltas(it);
+}
+
+int EulerMaruyamaIterator::method_order() const
+{
+    return 1;
+}
+
+/////////////////////////
+// StochasticRK1Iterator
+
+void StochasticRK1Iterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    IStochasticRHS* srhs = stochastic_rhs(rhs);
+    rhs->pre_iteration_job(t);
+
+    m_x.clear();
+    variable->collect_values(m_x);
+    drift(variable, srhs, t, m_f);
+    diffusion(variable, srhs, t, m_g);
+
+    const size_t n = m_x.size();
+    draw_normals(n, m_normals);
+    const double sqrt_dt = sqrt(dt);
+
+    // Supporting value x + f dt + g sqrt(dt) replaces derivative of g in Milstein scheme
+    m_support.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_support[i] = m_x[i] + m_f[i] * dt + m_g[i] * sqrt_dt;
+    set_state(variable, m_support);
+    diffusion(variable, srhs, t, m_g_support);
+    set_state(variable, m_x);
+
+    m_delta.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        double dw = sqrt_dt * m_normals[i];
+        m_delta[i] = m_f[i] * dt + m_g[i] * dw
+                + (m_g_support[i] - m_g[i]) * (dw * dw - dt) / (2.0 * sqrt_dt);
+    }
+
+    auto it = m_delta.cbegin();
+    variable->set_deltas(it);
+}
+
+int StochasticRK1Iterator::method_order() const
+{
+    return 1;
+}
+
+/////////////////////////
+// SRA1Iterator
+
+void SRA1Iterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    // Coefficients of SRA1:
+    // alpha = (1/3, 2/3), c0 = (0, 3/4), c1 = (1, 0), A0_21 = 3/4, B0_21 = 3/2,
+    // beta1 = (1, 0), beta2 = (-1, 1)
+    IStochasticRHS* srhs = stochastic_rhs(rhs);
+    rhs->pre_iteration_job(t);
+
+    m_x.clear();
+    variable->collect_values(m_x);
+    const size_t n = m_x.size();
+
+    drift(variable, srhs, t, m_f);
+    diffusion(variable, srhs, t, m_g);
+    diffusion(variable, srhs, t + dt, m_g_end);
+
+    // dW and independent dZ for I_(1,0) = dt / 2 * (dW + dZ / sqrt(3))
+    draw_normals(2 * n, m_normals);
+    const double sqrt_dt = sqrt(dt);
+    const double inv_sqrt3 = 1.0 / sqrt(3.0);
+
+    m_stage.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        double i10_per_dt = 0.5 * sqrt_dt * (m_normals[i] + m_normals[n + i] * inv_sqrt3);
+        m_stage[i] = m_x[i] + 0.75 * dt * m_f[i] + 1.5 * m_g_end[i] * i10_per_dt;
+    }
+    set_state(variable, m_stage);
+    drift(variable, srhs, t + 0.75 * dt, m_f2);
+    set_state(variable, m_x);
+
+    m_delta.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        double dw = sqrt_dt * m_normals[i];
+        double i10_per_dt = 0.5 * sqrt_dt * (m_normals[i] + m_normals[n + i] * inv_sqrt3);
+        m_delta[i] = dt * (m_f[i] / 3.0 + 2.0 * m_f2[i] / 3.0)
+                + m_g_end[i] * (dw - i10_per_dt) + m_g[i] * i10_per_dt;
+    }
+
+    auto it = m_delta.cbegin();
+    variable->set_deltas(it);
+}
+
+int SRA1Iterator::method_order() const
+{
+    return 2;
+}
@@ -0,0 +1,150 @@
+#include "dsiterpp/sdirk.hpp"
+
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+using namespace dsiterpp;
+
+namespace {
+    const double gamma_coeff = 1.0 - 1.0 / sqrt(2.0);
+}
+
+void SDIRK2Iterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    rhs->pre_iteration_job(t);
+
+    m_evaluator.set_target(variable, rhs);
+    m_evaluator.collect_values(m_x0);
+    m_evaluator.evaluate_current(t, m_f0);
+
+    update_newton_matrix(t, m_x0, m_f0, gamma_coeff * dt);
+
+    const size_t n = m_x0.size();
+
+    // k1 = f(t + gamma*dt, x0 + gamma*dt*k1)
+    m_k1 = m_f0;
+    solve_stage(t + gamma_coeff * dt, m_x0, gamma_coeff * dt, m_k1);
+
+    // k2 = f(t + dt, x0 + (1-gamma)*dt*k1 + gamma*dt*k2)
+    m_base.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_base[i] = m_x0[i] + (1.0 - gamma_coeff) * dt * m_k1[i];
+    m_k2 = m_k1;
+    solve_stage(t + dt, m_base, gamma_coeff * dt, m_k2);
+
+    m_delta.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_delta[i] = (1.0 - gamma_coeff) * dt * m_k1[i] + gamma_coeff * dt * m_k2[i];
+
+    m_evaluator.restore(m_x0, m_delta);
+}
+
+int SDIRK2Iterator::method_order() const
+{
+    return 2;
+}
+
+void SDIRK2Iterator::set_jacobian_function(JacobianFunction jacobian)
+{
+    m_jacobian_function = jacobian;
+}
+
+void SDIRK2Iterator::set_newton_tolerance(double tolerance)
+{
+    m_newton_tolerance = tolerance;
+}
+
+void SDIRK2Iterator::set_newton_max_iterations(size_t max_iterations)
+{
+    m_newton_max_iterations = max_iterations;
+}
+
+void SDIRK2Iterator::update_newton_matrix(double t, const std::vector<double>& x, const std::vector<double>& f, double m) const
+{
+    const size_t n = x.size();
+    m_jacobian.resize(n);
+
+    if (m_jacobian_function)
+    {
+        m_jacobian_function(t, x, m_jacobian);
+    } else {
+        const double sqrt_eps = sqrt(std::numeric_limits<double>::epsilon());
+        m_x_perturbed = x;
+        for (size_t j = 0; j < n; j++)
+        {
+            double h = sqrt_eps * std::max(fabs(x[j]), 1.0);
+            m_x_perturbed[j] = x[j] + h;
+            h = m_x_perturbed[j] - x[j];
+            m_evaluator.evaluate(t, m_x_perturbed, m_f);
+            for (size_t i = 0; i < n; i++)
+                m_jacobian(i, j) = (m_f[i] - f[i]) / h;
+            m_x_perturbed[j] = x[j];
+        }
+    }
+
+    m_newton_matrix.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        for (size_t j = 0; j < n; j++)
+            m_newton_matrix(i, j) = - m * m_jacobian(i, j);
+        m_newton_matrix(i, i) += 1.0;
+    }
+    m_lu.decompose(m_newton_matrix);
+}
+
+void SDIRK2Iterator::solve_stage(double t, const std::vector<double>& base, double m, std::vector<double>& k) const
+{
+    m_k_guess = k;
+    if (newton_iterations(t, base, m, k))
+        return;
+
+    // Jacobian from the step beginning is too far from stage one, so refresh it
+    // at initial guess point and start again
+    k = m_k_guess;
+    const size_t n = base.size();
+    m_stage.resize(n);
+    for (size_t i = 0; i < n; i++)
+        m_stage[i] = base[i] + m * k[i];
+    m_evaluator.evaluate(t, m_stage, m_f_stage);
+    update_newton_matrix(t, m_stage, m_f_stage, m);
+
+    if (!newton_iterations(t, base, m, k))
+        throw std::runtime_error("SDIRK2Iterator: Newton iterations do not converge");
+}
+
+bool SDIRK2Iterator::newton_iterations(double t, const std::vector<double>& base, double m, std::vector<double>& k) const
+{
+    const size_t n = base.size();
+    m_stage.resize(n);
+    for (size_t iteration = 0; iteration < m_newton_max_iterations; iteration++)
+    {
+        double max_value = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            m_stage[i] = base[i] + m * k[i];
+            max_value = std::max(max_value, fabs(m_stage[i]));
+        }
+
+        // Newton correction for k: (I - m*J) dk = f(stage) - k
+        m_evaluator.evaluate(t, m_stage, m_f);
+        for (size_t i = 0; i < n; i++)
+            m_f[i] -= k[i];
+        m_lu.solve(m_f);
+
+        double max_correction = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            k[i] += m_f[i];
+            max_correction = std::max(max_correction, fabs(m * m_f[i]));
+        }
+
+        if (!std::isfinite(max_correction))
+            return false;
+
+        if (max_correction <= m_newton_tolerance * (1.0 + max_value))
+            return true;
+    }
+    return false;
+}
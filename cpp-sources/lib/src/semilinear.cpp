@@ -0,0 +1,67 @@
+#include "dsiterpp/semilinear.hpp"
+
+#include <stdexcept>
+
+using namespace dsiterpp;
+
+LinearOperator LinearOperator::diagonal(const std::vector<double>& diagonal)
+{
+    LinearOperator result;
+    result.m_type = Type::diagonal;
+    result.m_size = diagonal.size();
+    result.m_diagonal = diagonal;
+    return result;
+}
+
+LinearOperator LinearOperator::sparse(const SparseMatrix& matrix)
+{
+    LinearOperator result;
+    result.m_type = Type::sparse;
+    result.m_size = matrix.pattern().size;
+    result.m_matrix = matrix;
+    return result;
+}
+
+LinearOperator LinearOperator::matvec(MatVec matvec, size_t size)
+{
+    LinearOperator result;
+    result.m_type = Type::matvec;
+    result.m_size = size;
+    result.m_matvec = matvec;
+    return result;
+}
+
+LinearOperator::Type LinearOperator::type() const
+{
+    return m_type;
+}
+
+size_t LinearOperator::size() const
+{
+    return m_size;
+}
+
+const std::vector<double>& LinearOperator::diagonal_values() const
+{
+    if (m_type != Type::diagonal)
+        throw std::logic_error("LinearOperator: operator is not diagonal");
+    return m_diagonal;
+}
+
+void LinearOperator::multiply(const std::vector<double>& x, std::vector<double>& y) const
+{
+    switch (m_type)
+    {
+    case Type::diagonal:
+        y.resize(m_size);
+        for (size_t i = 0; i < m_size; i++)
+            y[i] = m_diagonal[i] * x[i];
+        break;
+    case Type::sparse:
+        m_matrix.multiply(x, y);
+        break;
+    case Type::matvec:
+        m_matvec(x, y);
+        break;
+    }
+}
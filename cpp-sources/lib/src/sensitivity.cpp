@@ -0,0 +1,61 @@
+#include "dsiterpp/sensitivity.hpp"
+#include "dsiterpp/integration.hpp"
+
+using namespace dsiterpp;
+
+/////////////////////////
+// InterfaceParametricRHS
+
+InterfaceParametricRHS::InterfaceParametricRHS(IVariable* variable, IRHS* rhs, std::vector<double*> parameters) :
+    m_parameters(std::move(parameters))
+{
+    m_evaluator.set_target(variable, rhs);
+    m_saved_parameters.resize(m_parameters.size());
+}
+
+void InterfaceParametricRHS::operator()(double t, const std::vector<double>& x, const std::vector<double>& p, std::vector<double>& dxdt)
+{
+    for (size_t j = 0; j < m_parameters.size(); j++)
+    {
+        m_saved_parameters[j] = *m_parameters[j];
+        *m_parameters[j] = p[j];
+    }
+
+    try {
+        m_evaluator.evaluate(t, x, dxdt);
+    } catch (...) {
+        restore_parameters();
+        throw;
+    }
+    restore_parameters();
+}
+
+void InterfaceParametricRHS::restore_parameters()
+{
+    for (size_t j = 0; j < m_parameters.size(); j++)
+        *m_parameters[j] = m_saved_parameters[j];
+}
+
+std::vector<double> InterfaceParametricRHS::state()
+{
+    std::vector<double> values;
+    m_evaluator.collect_values(values);
+    return values;
+}
+
+std::vector<double> InterfaceParametricRHS::parameters() const
+{
+    std::vector<double> values;
+    values.reserve(m_parameters.size());
+    for (const double* parameter : m_parameters)
+        values.push_back(*parameter);
+    return values;
+}
+
+SensitivityRHS<InterfaceParametricRHS> dsiterpp::make_sensitivity_rhs(IVariable* variable, IRHS* rhs, std::vector<double*> parameters)
+{
+    InterfaceParametricRHS parametric_rhs(variable, rhs, std::move(parameters));
+    size_t state_size = parametric_rhs.state().size();
+    std::vector<double> values = parametric_rhs.parameters();
+    return SensitivityRHS<InterfaceParametricRHS>(std::move(parametric_rhs), state_size, std::move(values));
+}
@@ -0,0 +1,214 @@
+#include "dsiterpp/shm-metrics.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+
+using namespace dsiterpp;
+
+namespace {
+
+const uint32_t layout_magic = 0x64736d74; // "dsmt"
+const uint32_t layout_version = 1;
+
+}
+
+/**
+ * Fields are relaxed atomics so concurrent access from reader is defined behaviour,
+ * ordering is provided by fences around sequence updates
+ */
+struct SharedMetricsExporter::Layout
+{
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint64_t> sequence;
+    std::atomic<double> time;
+    std::atomic<double> dt;
+    std::atomic<uint64_t> steps;
+    std::atomic<uint64_t> rejected_steps;
+    std::atomic<uint64_t> min_step_limitations;
+    std::atomic<uint64_t> max_step_limitations;
+    std::atomic<uint64_t> rhs_evaluations;
+};
+
+/////////////////////////
+// RHSEvaluationCounter
+
+RHSEvaluationCounter::RHSEvaluationCounter(IRHS* rhs) :
+    m_rhs(rhs)
+{
+}
+
+void RHSEvaluationCounter::pre_iteration_job(double time)
+{
+    m_rhs->pre_iteration_job(time);
+}
+
+void RHSEvaluationCounter::pre_sub_iteration_job(double time)
+{
+    m_rhs->pre_sub_iteration_job(time);
+}
+
+void RHSEvaluationCounter::calculate_rhs(double time)
+{
+    m_rhs->calculate_rhs(time);
+    m_evaluations_count++;
+}
+
+uint64_t RHSEvaluationCounter::evaluations_count() const
+{
+    return m_evaluations_count;
+}
+
+/////////////////////////
+// SharedMetricsExporter
+
+SharedMetricsExporter::SharedMetricsExporter(const std::string& name) :
+    m_name(name)
+{
+    // Reader in other process may see atomics only when they are lock-free, i.e. plain memory
+    std::atomic<double> double_field(0.0);
+    std::atomic<uint64_t> integer_field(0);
+    if (!double_field.is_lock_free() || !integer_field.is_lock_free())
+        throw std::runtime_error("SharedMetricsExporter: atomics are not lock-free on this platform");
+
+    // Segment of other exporter or left by crashed process is not reused
+    int fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST)
+        throw std::runtime_error("SharedMetricsExporter: segment " + m_name + " already exists");
+    if (fd < 0)
+        throw std::runtime_error("SharedMetricsExporter: cannot create segment " + m_name + ": " + strerror(errno));
+
+    if (ftruncate(fd, sizeof(Layout)) != 0)
+    {
+        close(fd);
+        shm_unlink(m_name.c_str());
+        throw std::runtime_error("SharedMetricsExporter: cannot resize segment " + m_name);
+    }
+
+    void* memory = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(m_name.c_str());
+        throw std::runtime_error("SharedMetricsExporter: cannot map segment " + m_name);
+    }
+
+    m_layout = new (memory) Layout();
+    m_layout->version = layout_version;
+    m_layout->sequence.store(0, std::memory_order_relaxed);
+    m_layout->time.store(0.0, std::memory_order_relaxed);
+    m_layout->dt.store(0.0, std::memory_order_relaxed);
+    m_layout->steps.store(0, std::memory_order_relaxed);
+    m_layout->rejected_steps.store(0, std::memory_order_relaxed);
+    m_layout->min_step_limitations.store(0, std::memory_order_relaxed);
+    m_layout->max_step_limitations.store(0, std::memory_order_relaxed);
+    m_layout->rhs_evaluations.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // Reader checks magic last written
+    m_layout->magic = layout_magic;
+}
+
+SharedMetricsExporter::~SharedMetricsExporter()
+{
+    munmap(m_layout, sizeof(Layout));
+    shm_unlink(m_name.c_str());
+}
+
+void SharedMetricsExporter::set_rhs_counter(const RHSEvaluationCounter* counter)
+{
+    m_rhs_counter = counter;
+}
+
+void SharedMetricsExporter::publish(double time, double dt, const IteratingMetrics& metrics)
+{
+    m_steps++;
+
+    // Odd sequence means update in progress
+    m_layout->sequence.store(++m_sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    m_layout->time.store(time, std::memory_order_relaxed);
+    m_layout->dt.store(dt, std::memory_order_relaxed);
+    m_layout->steps.store(m_steps, std::memory_order_relaxed);
+    m_layout->rejected_steps.store(metrics.rejected_steps, std::memory_order_relaxed);
+    m_layout->min_step_limitations.store(metrics.min_step_limitations, std::memory_order_relaxed);
+    m_layout->max_step_limitations.store(metrics.max_step_limitations, std::memory_order_relaxed);
+    if (m_rhs_counter != nullptr)
+        m_layout->rhs_evaluations.store(m_rhs_counter->evaluations_count(), std::memory_order_relaxed);
+
+    m_layout->sequence.store(++m_sequence, std::memory_order_release);
+}
+
+const std::string& SharedMetricsExporter::name() const
+{
+    return m_name;
+}
+
+/////////////////////////
+// SharedMetricsReader
+
+SharedMetricsReader::SharedMetricsReader(const std::string& name)
+{
+    using Layout = SharedMetricsExporter::Layout;
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        throw std::runtime_error("SharedMetricsReader: cannot open segment " + name + ": " + strerror(errno));
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Layout))
+    {
+        close(fd);
+        throw std::runtime_error("SharedMetricsReader: segment " + name + " is not initialized");
+    }
+
+    void* memory = mmap(nullptr, sizeof(Layout), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+        throw std::runtime_error("SharedMetricsReader: cannot map segment " + name);
+
+    const Layout* layout = static_cast<const Layout*>(memory);
+    if (layout->magic != layout_magic || layout->version != layout_version)
+    {
+        munmap(memory, sizeof(Layout));
+        throw std::runtime_error("SharedMetricsReader: segment " + name + " has unknown format");
+    }
+    m_layout = memory;
+}
+
+SharedMetricsReader::~SharedMetricsReader()
+{
+    munmap(const_cast<void*>(m_layout), sizeof(SharedMetricsExporter::Layout));
+}
+
+bool SharedMetricsReader::read(SharedMetricsSnapshot& snapshot, size_t max_attempts) const
+{
+    const SharedMetricsExporter::Layout* layout = static_cast<const SharedMetricsExporter::Layout*>(m_layout);
+    for (size_t attempt = 0; attempt < max_attempts; attempt++)
+    {
+        uint64_t before = layout->sequence.load(std::memory_order_acquire);
+        if (before % 2 != 0)
+            continue;
+
+        snapshot.time = layout->time.load(std::memory_order_relaxed);
+        snapshot.dt = layout->dt.load(std::memory_order_relaxed);
+        snapshot.steps = layout->steps.load(std::memory_order_relaxed);
+        snapshot.rejected_steps = layout->rejected_steps.load(std::memory_order_relaxed);
+        snapshot.min_step_limitations = layout->min_step_limitations.load(std::memory_order_relaxed);
+        snapshot.max_step_limitations = layout->max_step_limitations.load(std::memory_order_relaxed);
+        snapshot.rhs_evaluations = layout->rhs_evaluations.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (layout->sequence.load(std::memory_order_relaxed) == before)
+            return true;
+    }
+    return false;
+}
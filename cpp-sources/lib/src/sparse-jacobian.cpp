@@ -0,0 +1,235 @@
+#include "dsiterpp/sparse-jacobian.hpp"
+#include "dsiterpp/integration.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+
+using namespace dsiterpp;
+
+/////////////////////////
+// SparseJacobian
+
+void SparseJacobian::set_target(IVariable* variable, IRHS* rhs)
+{
+    m_evaluator.set_target(variable, rhs);
+}
+
+void SparseJacobian::set_pattern(const SparsityPattern& pattern)
+{
+    m_matrix.set_pattern(pattern);
+    m_has_pattern = true;
+
+    const size_t n = pattern.size;
+    m_col_offsets.assign(n + 1, 0);
+    for (size_t col : pattern.columns)
+        m_col_offsets[col + 1]++;
+    for (size_t i = 0; i < n; i++)
+        m_col_offsets[i + 1] += m_col_offsets[i];
+
+    m_col_rows.resize(pattern.nonzeros_count());
+    m_col_value_index.resize(pattern.nonzeros_count());
+    std::vector<size_t> filled(m_col_offsets.begin(), m_col_offsets.end() - 1);
+    for (size_t row = 0; row < n; row++)
+    {
+        for (size_t k = pattern.row_offsets[row]; k < pattern.row_offsets[row + 1]; k++)
+        {
+            size_t position = filled[pattern.columns[k]]++;
+            m_col_rows[position] = row;
+            m_col_value_index[position] = k;
+        }
+    }
+
+    color_columns();
+}
+
+void SparseJacobian::detect_pattern(double t, const std::vector<double>& x)
+{
+    const size_t n = x.size();
+    m_evaluator.evaluate(t, x, m_f);
+
+    std::vector<std::pair<size_t, size_t>> entries;
+    m_perturbed = x;
+    for (size_t col = 0; col < n; col++)
+    {
+        // Big perturbation to avoid loss of small dependencies
+        double h = 1e-3 * std::max(fabs(x[col]), 1.0);
+        m_perturbed[col] = x[col] + h;
+        m_evaluator.evaluate(t, m_perturbed, m_f_perturbed);
+        m_perturbed[col] = x[col];
+        for (size_t row = 0; row < n; row++)
+        {
+            if (m_f_perturbed[row] != m_f[row])
+                entries.push_back(std::make_pair(row, col));
+        }
+    }
+    m_evaluator.restore(x);
+
+    set_pattern(SparsityPattern::from_entries(n, entries));
+}
+
+void SparseJacobian::update(double t, const std::vector<double>& x)
+{
+    if (!m_has_pattern)
+        detect_pattern(t, x);
+
+    const size_t n = x.size();
+    if (n != m_matrix.pattern().size)
+        throw std::runtime_error("SparseJacobian: state size is not equal to pattern size");
+
+    m_evaluator.evaluate(t, x, m_f);
+    const double sqrt_eps = sqrt(std::numeric_limits<double>::epsilon());
+    std::vector<double>& values = m_matrix.values();
+
+    m_perturbed = x;
+    m_steps.resize(n);
+    for (auto &columns : m_color_columns)
+    {
+        for (size_t col : columns)
+        {
+            double h = sqrt_eps * std::max(fabs(x[col]), 1.0);
+            m_perturbed[col] = x[col] + h;
+            m_steps[col] = m_perturbed[col] - x[col];
+        }
+
+        m_evaluator.evaluate(t, m_perturbed, m_f_perturbed);
+
+        // Columns of one color have no common rows, so row difference belongs to one column
+        for (size_t col : columns)
+        {
+            for (size_t k = m_col_offsets[col]; k < m_col_offsets[col + 1]; k++)
+            {
+                size_t row = m_col_rows[k];
+                values[m_col_value_index[k]] = (m_f_perturbed[row] - m_f[row]) / m_steps[col];
+            }
+            m_perturbed[col] = x[col];
+        }
+    }
+    m_evaluator.restore(x);
+}
+
+const SparseMatrix& SparseJacobian::matrix() const
+{
+    return m_matrix;
+}
+
+const SparsityPattern& SparseJacobian::pattern() const
+{
+    return m_matrix.pattern();
+}
+
+bool SparseJacobian::has_pattern() const
+{
+    return m_has_pattern;
+}
+
+size_t SparseJacobian::colors_count() const
+{
+    return m_color_columns.size();
+}
+
+size_t SparseJacobian::column_color(size_t col) const
+{
+    return m_colors[col];
+}
+
+size_t SparseJacobian::evaluations_count()
+{
+    return m_evaluator.evaluations_count();
+}
+
+void SparseJacobian::color_columns()
+{
+    // Greedy distance-2 coloring of column intersection graph: columns sharing a row
+    // get different colors
+    const SparsityPattern& pattern = m_matrix.pattern();
+    const size_t n = pattern.size;
+    const size_t uncolored = std::numeric_limits<size_t>::max();
+
+    m_colors.assign(n, uncolored);
+    m_color_columns.clear();
+    std::vector<size_t> forbidden_for;
+    for (size_t col = 0; col < n; col++)
+    {
+        for (size_t k = m_col_offsets[col]; k < m_col_offsets[col + 1]; k++)
+        {
+            size_t row = m_col_rows[k];
+            for (size_t j = pattern.row_offsets[row]; j < pattern.row_offsets[row + 1]; j++)
+            {
+                size_t color = m_colors[pattern.columns[j]];
+                if (color != uncolored)
+                {
+                    if (forbidden_for.size() <= color)
+                        forbidden_for.resize(color + 1, uncolored);
+                    forbidden_for[color] = col;
+                }
+            }
+        }
+
+        size_t color = 0;
+        while (color < forbidden_for.size() && forbidden_for[color] == col)
+            color++;
+
+        m_colors[col] = color;
+        if (m_color_columns.size() <= color)
+            m_color_columns.resize(color + 1);
+        m_color_columns[color].push_back(col);
+    }
+}
+
+/////////////////////////
+// ILU0Preconditioner
+
+ILU0Preconditioner::ILU0Preconditioner(IVariable* variable, IRHS* rhs)
+{
+    m_jacobian.set_target(variable, rhs);
+}
+
+void ILU0Preconditioner::setup(double t, const std::vector<double>& x, double gamma)
+{
+    if (m_jacobian_outdated || !m_jacobian.has_pattern() || m_jacobian.pattern().size != x.size())
+    {
+        m_jacobian.update(t, x);
+        m_jacobian_outdated = false;
+        m_jacobian_updates++;
+
+        SparsityPattern pattern = m_jacobian.pattern();
+        pattern.add_diagonal();
+        m_newton_matrix.set_pattern(pattern);
+    }
+
+    // I - gamma * J on pattern with diagonal
+    const SparseMatrix& jacobian = m_jacobian.matrix();
+    const SparsityPattern& pattern = m_newton_matrix.pattern();
+    std::vector<double>& values = m_newton_matrix.values();
+    for (size_t row = 0; row < pattern.size; row++)
+    {
+        for (size_t k = pattern.row_offsets[row]; k < pattern.row_offsets[row + 1]; k++)
+        {
+            size_t col = pattern.columns[k];
+            values[k] = - gamma * jacobian.get(row, col) + (row == col ? 1.0 : 0.0);
+        }
+    }
+    m_ilu.decompose(m_newton_matrix);
+}
+
+void ILU0Preconditioner::apply(const std::vector<double>& r, std::vector<double>& z)
+{
+    m_ilu.solve(r, z);
+}
+
+void ILU0Preconditioner::jacobian_outdated()
+{
+    m_jacobian_outdated = true;
+}
+
+SparseJacobian& ILU0Preconditioner::jacobian()
+{
+    return m_jacobian;
+}
+
+size_t ILU0Preconditioner::jacobian_updates_count() const
+{
+    return m_jacobian_updates;
+}
@@ -0,0 +1,173 @@
+#include "dsiterpp/sparse-matrix.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace dsiterpp;
+
+/////////////////////////
+// SparsityPattern
+
+SparsityPattern SparsityPattern::from_entries(size_t size, std::vector<std::pair<size_t, size_t>> entries)
+{
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    SparsityPattern pattern;
+    pattern.size = size;
+    pattern.row_offsets.assign(size + 1, 0);
+    pattern.columns.reserve(entries.size());
+    for (auto &entry : entries)
+    {
+        if (entry.first >= size || entry.second >= size)
+            throw std::out_of_range("SparsityPattern: entry is out of matrix");
+        pattern.row_offsets[entry.first + 1]++;
+        pattern.columns.push_back(entry.second);
+    }
+    for (size_t i = 0; i < size; i++)
+        pattern.row_offsets[i + 1] += pattern.row_offsets[i];
+    return pattern;
+}
+
+void SparsityPattern::add_diagonal()
+{
+    std::vector<std::pair<size_t, size_t>> entries;
+    entries.reserve(columns.size() + size);
+    for (size_t row = 0; row < size; row++)
+    {
+        for (size_t k = row_offsets[row]; k < row_offsets[row + 1]; k++)
+            entries.push_back(std::make_pair(row, columns[k]));
+        entries.push_back(std::make_pair(row, row));
+    }
+    *this = from_entries(size, entries);
+}
+
+size_t SparsityPattern::nonzeros_count() const
+{
+    return columns.size();
+}
+
+size_t SparsityPattern::find(size_t row, size_t col) const
+{
+    auto begin = columns.begin() + row_offsets[row];
+    auto end = columns.begin() + row_offsets[row + 1];
+    auto it = std::lower_bound(begin, end, col);
+    if (it == end || *it != col)
+        return nonzeros_count();
+    return it - columns.begin();
+}
+
+/////////////////////////
+// SparseMatrix
+
+void SparseMatrix::set_pattern(const SparsityPattern& pattern)
+{
+    m_pattern = pattern;
+    m_values.assign(pattern.nonzeros_count(), 0.0);
+}
+
+const SparsityPattern& SparseMatrix::pattern() const
+{
+    return m_pattern;
+}
+
+std::vector<double>& SparseMatrix::values()
+{
+    return m_values;
+}
+
+const std::vector<double>& SparseMatrix::values() const
+{
+    return m_values;
+}
+
+double SparseMatrix::get(size_t row, size_t col) const
+{
+    size_t index = m_pattern.find(row, col);
+    return index == m_pattern.nonzeros_count() ? 0.0 : m_values[index];
+}
+
+void SparseMatrix::multiply(const std::vector<double>& x, std::vector<double>& y) const
+{
+    y.resize(m_pattern.size);
+    for (size_t row = 0; row < m_pattern.size; row++)
+    {
+        double sum = 0.0;
+        for (size_t k = m_pattern.row_offsets[row]; k < m_pattern.row_offsets[row + 1]; k++)
+            sum += m_values[k] * x[m_pattern.columns[k]];
+        y[row] = sum;
+    }
+}
+
+/////////////////////////
+// ILU0Decomposition
+
+void ILU0Decomposition::decompose(const SparseMatrix& matrix)
+{
+    m_lu = matrix;
+    const SparsityPattern& pattern = m_lu.pattern();
+    std::vector<double>& a = m_lu.values();
+    const size_t n = pattern.size;
+    const size_t absent = pattern.nonzeros_count();
+
+    m_diagonal.resize(n);
+    for (size_t row = 0; row < n; row++)
+    {
+        m_diagonal[row] = pattern.find(row, row);
+        if (m_diagonal[row] == absent)
+            throw std::runtime_error("ILU0Decomposition: pattern has no diagonal element");
+    }
+
+    // Positions of row elements by column, absent for columns out of pattern
+    m_positions.assign(n, absent);
+    for (size_t row = 0; row < n; row++)
+    {
+        const size_t begin = pattern.row_offsets[row], end = pattern.row_offsets[row + 1];
+        for (size_t k = begin; k < end; k++)
+            m_positions[pattern.columns[k]] = k;
+
+        for (size_t k = begin; k < end && pattern.columns[k] < row; k++)
+        {
+            const size_t col = pattern.columns[k];
+            const double pivot = a[m_diagonal[col]];
+            if (pivot == 0.0)
+                throw std::runtime_error("ILU0Decomposition: zero pivot");
+            a[k] /= pivot;
+            for (size_t j = m_diagonal[col] + 1; j < pattern.row_offsets[col + 1]; j++)
+            {
+                size_t position = m_positions[pattern.columns[j]];
+                if (position != absent)
+                    a[position] -= a[k] * a[j];
+            }
+        }
+
+        for (size_t k = begin; k < end; k++)
+            m_positions[pattern.columns[k]] = absent;
+    }
+}
+
+void ILU0Decomposition::solve(const std::vector<double>& b, std::vector<double>& x) const
+{
+    const SparsityPattern& pattern = m_lu.pattern();
+    const std::vector<double>& a = m_lu.values();
+    const size_t n = pattern.size;
+    x.resize(n);
+
+    // L y = b, L has unit diagonal
+    for (size_t row = 0; row < n; row++)
+    {
+        double sum = b[row];
+        for (size_t k = pattern.row_offsets[row]; k < m_diagonal[row]; k++)
+            sum -= a[k] * x[pattern.columns[k]];
+        x[row] = sum;
+    }
+
+    // U x = y
+    for (size_t row = n; row-- > 0; )
+    {
+        double sum = x[row];
+        for (size_t k = m_diagonal[row] + 1; k < pattern.row_offsets[row + 1]; k++)
+            sum -= a[k] * x[pattern.columns[k]];
+        x[row] = sum / a[m_diagonal[row]];
+    }
+}
@@ -0,0 +1,77 @@
+#include "dsiterpp/splitting.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+
+using namespace dsiterpp;
+
+void SplittingIterator::add_operator(IRHS* rhs, IIntegrator* integrator, size_t substeps)
+{
+    if (substeps == 0)
+        throw std::invalid_argument("SplittingIterator: substeps count should be positive");
+    m_operators.push_back(Operator{rhs, integrator, substeps});
+}
+
+void SplittingIterator::set_scheme(SplittingScheme scheme)
+{
+    m_scheme = scheme;
+}
+
+void SplittingIterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    DSITERPP_UNUSED(rhs);
+    if (m_operators.empty())
+        throw std::logic_error("SplittingIterator: no operators added");
+
+    variable->clear_subiteration();
+    m_x0.clear();
+    variable->collect_values(m_x0);
+
+    const size_t n = m_operators.size();
+    if (m_scheme == SplittingScheme::lie || n == 1)
+    {
+        for (const auto& op : m_operators)
+            advance(variable, op, t, dt);
+    } else {
+        const double half = 0.5 * dt;
+        for (size_t i = 0; i + 1 < n; i++)
+            advance(variable, m_operators[i], t, half);
+        advance(variable, m_operators[n - 1], t, dt);
+        for (size_t i = n - 1; i-- > 0; )
+            advance(variable, m_operators[i], t + half, half);
+    }
+
+    m_x1.clear();
+    variable->collect_values(m_x1);
+    for (size_t i = 0; i < m_x1.size(); i++)
+        m_x1[i] -= m_x0[i];
+
+    auto it = m_x0.cbegin();
+    variable->set_values(it);
+    auto delta_it = m_x1.cbegin();
+    variable->set_deltas(delta_it);
+}
+
+int SplittingIterator::method_order() const
+{
+    int order = m_scheme == SplittingScheme::lie ? 1 : 2;
+    for (const auto& op : m_operators)
+        order = std::min(order, op.integrator->method_order());
+    return order;
+}
+
+void SplittingIterator::advance(IVariable* variable, const Operator& op, double t, double dt) const
+{
+    // Variables not covered by operator should not move with stale rhs of previous one
+    variable->clear_rhs();
+
+    const double h = dt / op.substeps;
+    for (size_t s = 0; s < op.substeps; s++)
+    {
+        const double time = t + s * h;
+        variable->clear_subiteration();
+        op.integrator->calculate_delta(variable, op.rhs, time, h);
+        variable->step();
+        op.integrator->step_done(time, h, m_substep_metrics);
+    }
+}
@@ -0,0 +1,131 @@
+#include "dsiterpp/step-schedule.hpp"
+
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+
+using namespace dsiterpp;
+
+namespace {
+
+const char file_magic[8] = {'D', 'S', 'I', 'T', 'S', 'T', 'P', '1'};
+
+template<typename T>
+void write_value(std::ostream& stream, const T& value)
+{
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+void read_value(std::istream& stream, T& value)
+{
+    stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+    if (!stream)
+        throw std::runtime_error("StepSchedule: unexpected end of data");
+}
+
+}
+
+StepSchedule StepSchedule::from_log(const std::vector<double>& time_steps_log)
+{
+    StepSchedule schedule;
+    for (double dt : time_steps_log)
+        schedule.add_step(dt);
+    return schedule;
+}
+
+void StepSchedule::add_step(double dt)
+{
+    // Bitwise comparison, so -0.0 and 0.0 or different NaNs are not merged
+    if (!m_steps.empty()
+            && std::memcmp(&m_steps.back(), &dt, sizeof(dt)) == 0
+            && m_repeats.back() < std::numeric_limits<uint32_t>::max())
+    {
+        m_repeats.back()++;
+    } else {
+        m_steps.push_back(dt);
+        m_repeats.push_back(1);
+    }
+    m_size++;
+}
+
+void StepSchedule::clear()
+{
+    m_steps.clear();
+    m_repeats.clear();
+    m_size = 0;
+    rewind();
+}
+
+size_t StepSchedule::size() const
+{
+    return m_size;
+}
+
+size_t StepSchedule::runs_count() const
+{
+    return m_steps.size();
+}
+
+void StepSchedule::rewind()
+{
+    m_current_run = 0;
+    m_current_repeat = 0;
+}
+
+bool StepSchedule::next_step(double& dt)
+{
+    if (is_finished())
+        return false;
+
+    dt = m_steps[m_current_run];
+    if (++m_current_repeat == m_repeats[m_current_run])
+    {
+        m_current_run++;
+        m_current_repeat = 0;
+    }
+    return true;
+}
+
+bool StepSchedule::is_finished() const
+{
+    return m_current_run >= m_steps.size();
+}
+
+void StepSchedule::save(std::ostream& stream) const
+{
+    stream.write(file_magic, sizeof(file_magic));
+    write_value(stream, static_cast<uint64_t>(m_steps.size()));
+    for (size_t i = 0; i < m_steps.size(); i++)
+    {
+        write_value(stream, m_steps[i]);
+        write_value(stream, m_repeats[i]);
+    }
+}
+
+void StepSchedule::load(std::istream& stream)
+{
+    char magic[sizeof(file_magic)];
+    stream.read(magic, sizeof(magic));
+    if (!stream || std::memcmp(magic, file_magic, sizeof(magic)) != 0)
+        throw std::runtime_error("StepSchedule: invalid data format");
+
+    uint64_t runs = 0;
+    read_value(stream, runs);
+
+    clear();
+    for (uint64_t i = 0; i < runs; i++)
+    {
+        double dt;
+        uint32_t repeats;
+        read_value(stream, dt);
+        read_value(stream, repeats);
+        if (repeats == 0)
+            throw std::runtime_error("StepSchedule: invalid run length");
+        m_steps.push_back(dt);
+        m_repeats.push_back(repeats);
+        m_size += repeats;
+    }
+}
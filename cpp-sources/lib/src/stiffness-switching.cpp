@@ -0,0 +1,144 @@
+#include "dsiterpp/stiffness-switching.hpp"
+#include "dsiterpp/time-iter.hpp"
+
+#include <limits>
+#include <cmath>
+
+using namespace dsiterpp;
+
+namespace {
+
+double norm(const std::vector<double>& v)
+{
+    double sum = 0.0;
+    for (double value : v)
+        sum += value * value;
+    return sqrt(sum);
+}
+
+}
+
+StiffnessSwitchingIterator::StiffnessSwitchingIterator(IIntegrator* non_stiff, IIntegrator* stiff) :
+    m_non_stiff(non_stiff), m_stiff(stiff)
+{
+}
+
+void StiffnessSwitchingIterator::calculate_delta(IVariable* variable, IRHS* rhs, double t, double dt) const
+{
+    m_variable = variable;
+    m_rhs = rhs;
+    active()->calculate_delta(variable, rhs, t, dt);
+}
+
+int StiffnessSwitchingIterator::method_order() const
+{
+    return active()->method_order();
+}
+
+void StiffnessSwitchingIterator::step_done(double time, double dt, IteratingMetrics& metrics)
+{
+    active()->step_done(time, dt, metrics);
+
+    // Repeated throttling by min_step_limit is a sign of stiffness without any estimation
+    bool throttled = metrics.min_step_limitations != m_last_min_step_limitations;
+    m_last_min_step_limitations = metrics.min_step_limitations;
+    if (!m_stiff_mode)
+    {
+        m_limited_steps = throttled ? m_limited_steps + 1 : 0;
+        if (m_limited_steps >= m_parameters.min_step_limitations_to_switch)
+        {
+            switch_method(time + dt, m_dominant_eigenvalue * dt, metrics);
+            return;
+        }
+    }
+
+    if (++m_steps_since_check < m_parameters.check_period || m_variable == nullptr)
+        return;
+    m_steps_since_check = 0;
+
+    m_dominant_eigenvalue = estimate_dominant_eigenvalue(time + dt);
+    double stiffness = m_dominant_eigenvalue * dt;
+
+    bool wants_switch = m_stiff_mode ?
+        stiffness < m_parameters.non_stiff_threshold * m_parameters.stability_limit :
+        stiffness > m_parameters.stiff_threshold * m_parameters.stability_limit;
+
+    m_confirmations = wants_switch ? m_confirmations + 1 : 0;
+    if (m_confirmations >= m_parameters.switch_confirmations)
+        switch_method(time + dt, stiffness, metrics);
+}
+
+StiffnessDetectionParameters& StiffnessSwitchingIterator::parameters()
+{
+    return m_parameters;
+}
+
+bool StiffnessSwitchingIterator::is_stiff_mode() const
+{
+    return m_stiff_mode;
+}
+
+double StiffnessSwitchingIterator::dominant_eigenvalue() const
+{
+    return m_dominant_eigenvalue;
+}
+
+IIntegrator* StiffnessSwitchingIterator::active() const
+{
+    return m_stiff_mode ? m_stiff : m_non_stiff;
+}
+
+void StiffnessSwitchingIterator::switch_method(double time, double stiffness, IteratingMetrics& metrics)
+{
+    m_stiff_mode = !m_stiff_mode;
+    m_confirmations = 0;
+    m_limited_steps = 0;
+    m_steps_since_check = 0;
+
+    IntegratorSwitch record;
+    record.time = time;
+    record.stiffness = stiffness;
+    record.to_stiff = m_stiff_mode;
+    metrics.integrator_switches.push_back(record);
+}
+
+double StiffnessSwitchingIterator::estimate_dominant_eigenvalue(double time)
+{
+    // Power iterations with J*v = (f(x + eps*v) - f(x)) / eps. Direction is kept between
+    // estimations, so usually it is already close to dominant eigenvector
+    m_evaluator.set_target(m_variable, m_rhs);
+    m_evaluator.collect_values(m_x);
+    m_evaluator.evaluate_current(time, m_f);
+
+    const size_t n = m_x.size();
+    double direction_norm = m_direction.size() == n ? norm(m_direction) : 0.0;
+    if (direction_norm == 0.0 || !std::isfinite(direction_norm))
+    {
+        // First estimation or J*v was zero (i.e. locally constant RHS) or overflowed
+        m_direction.resize(n);
+        for (size_t i = 0; i < n; i++)
+            m_direction[i] = (i % 2 == 0 ? 1.0 : -1.0) * (1.0 + 0.1 * (i % 7));
+        direction_norm = norm(m_direction);
+    }
+
+    const double eps = sqrt(std::numeric_limits<double>::epsilon()) * (1.0 + norm(m_x));
+    double eigenvalue = 0.0;
+    m_perturbed.resize(n);
+    for (size_t iteration = 0; iteration < m_parameters.power_iterations; iteration++)
+    {
+        for (size_t i = 0; i < n; i++)
+            m_perturbed[i] = m_x[i] + eps * m_direction[i] / direction_norm;
+
+        m_evaluator.evaluate(time, m_perturbed, m_f_perturbed);
+        for (size_t i = 0; i < n; i++)
+            m_direction[i] = (m_f_perturbed[i] - m_f[i]) / eps;
+
+        direction_norm = norm(m_direction);
+        eigenvalue = direction_norm;
+        if (direction_norm == 0.0)
+            break;
+    }
+
+    m_evaluator.restore(m_x);
+    return eigenvalue;
+}
@@ -0,0 +1,224 @@
+#include "dsiterpp/thread-pool.hpp"
+
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+using namespace dsiterpp;
+
+ThreadPool::ThreadPool(size_t threads_count)
+{
+    for (size_t i = 1; i < threads_count; i++)
+        m_workers.emplace_back(&ThreadPool::worker, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_task_ready.notify_all();
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::parallel_for(size_t count, const Task& task)
+{
+    if (count == 0)
+        return;
+
+    if (m_workers.empty())
+    {
+        for (size_t i = 0; i < count; i++)
+            task(i);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_count = count;
+        m_next_index = 0;
+        m_unfinished = count;
+        m_exception = nullptr;
+        m_generation++;
+    }
+    m_task_ready.notify_all();
+
+    run_available_tasks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task_done.wait(lock, [this] { return m_unfinished == 0; });
+    m_task = nullptr;
+
+    if (m_exception)
+        std::rethrow_exception(m_exception);
+}
+
+size_t ThreadPool::threads_count() const
+{
+    return m_workers.size() + 1;
+}
+
+void ThreadPool::worker()
+{
+    size_t seen_generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_task_ready.wait(lock, [this, seen_generation] { return m_stop || m_generation != seen_generation; });
+            if (m_stop)
+                return;
+            seen_generation = m_generation;
+        }
+        run_available_tasks();
+    }
+}
+
+void ThreadPool::run_available_tasks()
+{
+    for (;;)
+    {
+        size_t index;
+        const Task* task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_task == nullptr || m_next_index >= m_count)
+                return;
+            index = m_next_index++;
+            task = m_task;
+        }
+
+        try {
+            (*task)(index);
+        } catch (...) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_exception)
+                m_exception = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (--m_unfinished == 0)
+            m_task_done.notify_all();
+    }
+}
+
+/////////////////////////
+// PinnedThreadPool
+
+namespace {
+
+bool pin_current_thread(int cpu)
+{
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void) cpu;
+    return false;
+#endif
+}
+
+}
+
+PinnedThreadPool::PinnedThreadPool(size_t threads_count, const std::vector<int>& cpus)
+{
+    if (threads_count == 0)
+        throw std::invalid_argument("PinnedThreadPool: threads count should be positive");
+    if (!cpus.empty() && cpus.size() != threads_count)
+        throw std::invalid_argument("PinnedThreadPool: CPU should be given for every thread");
+
+    const size_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < threads_count; i++)
+    {
+        int cpu = cpus.empty() ? static_cast<int>(i % hardware_threads) : cpus[i];
+        m_workers.emplace_back(&PinnedThreadPool::worker, this, i, cpu);
+    }
+
+    // Workers pin themselves before waiting for the first task
+    run_on_each([](size_t) {});
+}
+
+PinnedThreadPool::~PinnedThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_task_ready.notify_all();
+    for (auto &worker : m_workers)
+        worker.join();
+}
+
+void PinnedThreadPool::run_on_each(const Task& task)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task = &task;
+    m_unfinished = m_workers.size();
+    m_exception = nullptr;
+    m_generation++;
+    m_task_ready.notify_all();
+
+    m_task_done.wait(lock, [this] { return m_unfinished == 0; });
+    m_task = nullptr;
+
+    if (m_exception)
+        std::rethrow_exception(m_exception);
+}
+
+size_t PinnedThreadPool::threads_count() const
+{
+    return m_workers.size();
+}
+
+bool PinnedThreadPool::is_pinned() const
+{
+    return m_pinned_count == m_workers.size();
+}
+
+void PinnedThreadPool::worker(size_t index, int cpu)
+{
+    bool pinned = pin_current_thread(cpu);
+    size_t seen_generation = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (pinned)
+            m_pinned_count++;
+    }
+
+    for (;;)
+    {
+        const Task* task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_task_ready.wait(lock, [this, seen_generation] { return m_stop || m_generation != seen_generation; });
+            if (m_stop)
+                return;
+            seen_generation = m_generation;
+            task = m_task;
+        }
+
+        try {
+            (*task)(index);
+        } catch (...) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (!m_exception)
+                m_exception = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (--m_unfinished == 0)
+            m_task_done.notify_all();
+    }
+}
@@ -2,9 +2,12 @@
 #include "dsiterpp/integration.hpp"
 #include "dsiterpp/bifurcation.hpp"
 #include "dsiterpp/error-estimator.hpp"
+#include "dsiterpp/step-schedule.hpp"
+#include "dsiterpp/shm-metrics.hpp"
 
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
 
 #include <cmath>
 
@@ -113,6 +116,22 @@ void TimeIterator::set_bifurcator(IBifurcator* bifurcator)
     m_bifurcationIterable = bifurcator;
 }
 
+void TimeIterator::set_replay_schedule(StepSchedule* schedule)
+{
+    m_replay_schedule = schedule;
+}
+
+void TimeIterator::set_step_observer(IStepObserver* observer)
+{
+    m_step_observer = observer;
+    m_step_observer_started = false;
+}
+
+void TimeIterator::set_metrics_exporter(SharedMetricsExporter* exporter)
+{
+    m_metrics_exporter = exporter;
+}
+
 StepAdjustmentParameters& TimeIterator::step_adj_pars()
 {
     return m_step_adj_pars;
@@ -121,6 +140,8 @@ StepAdjustmentParameters& TimeIterator::step_adj_pars()
 void TimeIterator::set_time(double time)
 {
 	m_lastBifurcationTime = time;
+    m_initial_step_pending = true;
+    m_step_observer_started = false;
 }
 
 void TimeIterator::set_bifurcation_run_period(double bifurcationPeriod)
@@ -161,26 +182,71 @@ double TimeIterator::get_time()
 
 bool TimeIterator::is_done()
 {
+    if (m_replay_schedule && m_replay_schedule->is_finished())
+        return true;
     return m_time >= m_stopTime;
 }
 
 void TimeIterator::iterate()
 {
     assert_pointers_are_set();
+    if (m_step_observer && !m_step_observer_started)
+    {
+        m_step_observer->step_accepted(m_time);
+        m_step_observer_started = true;
+    }
     call_hook();
+
+    if (m_replay_schedule)
+    {
+        if (!m_replay_schedule->next_step(m_dt))
+            throw std::runtime_error("TimeIterator: replay schedule is finished");
+    } else if (m_initial_step_pending && is_initial_step_estimation_enabled()) {
+        m_dt = estimate_initial_step();
+        m_initial_step_pending = false;
+        m_metrics.initial_step_estimations++;
+    }
+
+    // Step should end exactly on breakpoint, after it previous step size is restored
+    double unclamped_dt = m_dt;
+    double clamped_dt = 0.0;
+    if (m_step_observer && !m_replay_schedule)
+    {
+        double breakpoint = m_step_observer->next_breakpoint(m_time);
+        if (m_time + m_dt > breakpoint)
+        {
+            m_dt = breakpoint - m_time;
+            clamped_dt = m_dt;
+        }
+    }
+
     double next_dt = integrate_iteration();
+    if (clamped_dt != 0.0 && m_dt == clamped_dt)
+        next_dt = std::max(next_dt, unclamped_dt);
+
+    m_continiousIterator->step_done(m_time, m_dt, m_metrics);
     bifurcate_iteration();
 
-    m_metrics.time_steps_log.push_back(m_dt);
+    if (m_log_steps)
+        m_metrics.time_steps_log.push_back(m_dt);
 
     m_time += m_dt;
+
+    // Step just done is published, as in advance()
+    if (m_metrics_exporter)
+        publish_metrics();
+
     m_dt = next_dt;
+
+    if (m_step_observer)
+        m_step_observer->step_accepted(m_time);
 }
 
 
 double TimeIterator::integrate_iteration()
 {
-    if (m_step_adj_pars.autoStepAdjustment && m_estimator == nullptr)
+    bool auto_step_adjustment = m_step_adj_pars.autoStepAdjustment && m_replay_schedule == nullptr;
+    if (auto_step_adjustment && m_estimator == nullptr)
         throw std::logic_error("Error estimator must be set to use auto step ajustment");
 
     double next_dt = m_dt;
@@ -188,17 +254,22 @@ double TimeIterator::integrate_iteration()
     // If user set values, he set previous ones, so lets write previous to current reset deltas
     m_variable->clear_subiteration();
 
-    if (m_step_adj_pars.autoStepAdjustment)
+    if (auto_step_adjustment)
     {
         m_estimator->set_integrator(m_continiousIterator);
         bool error_is_ok = false;
         do {
+            m_estimator->set_step_tolerance(
+                m_step_adj_pars.relative_deconvergence_speed_max * m_dt,
+                m_step_adj_pars.relative_deconvergence_speed_min * m_dt
+            );
             m_estimator->calculate_delta_and_estimate(m_variable, m_rhs, m_time, m_dt);
             auto error = m_estimator->get_error();
             //error_is_ok = error.max_rel_error < m_step_adj_pars.rel_error_per_step_refining_treshold;
             error_is_ok = error.max_rel_error < m_step_adj_pars.relative_deconvergence_speed_max * m_dt;
             if (!error_is_ok)
             {
+                m_metrics.rejected_steps++;
                 m_dt *= m_step_adj_pars.step_refining_factor;
                 next_dt = m_dt;
                 m_variable->clear_subiteration();
@@ -209,6 +280,7 @@ double TimeIterator::integrate_iteration()
                     m_dt = m_step_adj_pars.min_step_limit;
                     next_dt = m_dt;
                     m_metrics.min_step_limitations++;
+                    m_continiousIterator->calculate_delta(m_variable, m_rhs, m_time, m_dt);
                     break;
                 }
             }
@@ -234,16 +306,118 @@ double TimeIterator::integrate_iteration()
 
 void TimeIterator::bifurcate_iteration()
 {
-    if (
-            (m_bifurcationPeriod == 0.0 || m_time - m_lastBifurcationTime >= m_bifurcationPeriod) &&
-            m_bifurcationIterable != nullptr
-        )
+    if (m_bifurcationIterable != nullptr && is_bifurcation_period_elapsed())
     {
+        bool track_state_change = is_initial_step_estimation_enabled();
+        if (track_state_change)
+        {
+            m_initial_values.clear();
+            m_variable->collect_values(m_initial_values);
+        }
+
         double dt = m_time - m_lastBifurcationTime;
         m_bifurcationIterable->prepare_bifurcation(m_time, dt);
         m_bifurcationIterable->do_bifurcation(m_time, dt);
         m_lastBifurcationTime = m_time;
+
+        if (track_state_change)
+        {
+            // Bifurcator may change previous values only
+            m_variable->clear_subiteration();
+            m_bifurcated_values.clear();
+            m_variable->collect_values(m_bifurcated_values);
+            if (relative_state_change(m_initial_values, m_bifurcated_values) > m_step_adj_pars.initial_step_reestimation_threshold)
+                m_initial_step_pending = true;
+        }
+    }
+}
+
+bool TimeIterator::is_initial_step_estimation_enabled()
+{
+    return m_step_adj_pars.autoStepAdjustment && m_step_adj_pars.auto_initial_step;
+}
+
+double TimeIterator::relative_state_change(const std::vector<double>& before, const std::vector<double>& after)
+{
+    // Topology change
+    if (before.size() != after.size())
+        return std::numeric_limits<double>::infinity();
+
+    double change = 0.0;
+    for (size_t i = 0; i < before.size(); i++)
+    {
+        double diff = fabs(after[i] - before[i]);
+        if (diff == 0.0)
+            continue;
+        change = std::max(change, diff / fabs(before[i]));
     }
+    return change;
+}
+
+double TimeIterator::estimate_initial_step()
+{
+    // Algorithm from E. Hairer, S.P. Norsett, G. Wanner, Solving ODE I, II.4,
+    // but with tolerance relative_deconvergence_speed_max * dt used by step adjustment
+    const int order = m_continiousIterator->method_order();
+    const double speed = m_step_adj_pars.relative_deconvergence_speed_max;
+
+    m_initial_values.clear();
+    m_initial_rhs.clear();
+    m_trial_rhs.clear();
+
+    // f0 = f(t0, x0)
+    m_variable->clear_subiteration();
+    m_variable->collect_values(m_initial_values);
+    m_rhs->pre_iteration_job(m_time);
+    m_rhs->pre_sub_iteration_job(m_time);
+    m_rhs->calculate_rhs(m_time);
+    m_variable->add_rhs_to_delta(1.0);
+    m_variable->collect_deltas(m_initial_rhs);
+
+    // Components are scaled by its absolute values, zero components are scaled by small part of state norm
+    double max_value = 0.0;
+    for (double value : m_initial_values)
+        max_value = std::max(max_value, fabs(value));
+    const double scale_floor = 1e-6 * max_value + std::numeric_limits<double>::min();
+
+    auto scaled_norm = [this, scale_floor](const std::vector<double>& v) {
+        double sum = 0.0;
+        for (size_t i = 0; i < v.size(); i++)
+        {
+            double scaled = v[i] / std::max(fabs(m_initial_values[i]), scale_floor);
+            sum += scaled * scaled;
+        }
+        return v.empty() ? 0.0 : sqrt(sum / v.size());
+    };
+
+    double d1 = scaled_norm(m_initial_rhs);
+    double h0 = d1 < 1e-5 ? 1e-6 : 0.01 / d1;
+    h0 = std::min(h0, m_step_adj_pars.max_step_limit);
+
+    // Explicit Euler trial step and f1 = f(t0 + h0, x0 + h0 * f0)
+    m_variable->make_sub_iteration(h0);
+    m_rhs->pre_sub_iteration_job(m_time + h0);
+    m_rhs->calculate_rhs(m_time + h0);
+    m_variable->clear_subiteration();
+    m_variable->add_rhs_to_delta(1.0);
+    m_variable->collect_deltas(m_trial_rhs);
+    m_variable->clear_subiteration();
+
+    for (size_t i = 0; i < m_trial_rhs.size(); i++)
+        m_trial_rhs[i] -= m_initial_rhs[i];
+    double d2 = scaled_norm(m_trial_rhs) / h0;
+
+    // Characteristic rate of solution change. Relative local error of order p method is
+    // about (rate * h)^(p+1), it should fit allowed error speed * h
+    double rate = std::max(d1, sqrt(d2));
+    double h1 = rate <= 1e-15 ?
+                m_step_adj_pars.max_step_limit :
+                pow(m_step_adj_pars.initial_step_safety_factor * speed / pow(rate, order + 1), 1.0 / order);
+
+    double dt = std::min(100 * h0, h1);
+    dt = std::min(dt, m_step_adj_pars.max_step_limit);
+    dt = std::max(dt, m_step_adj_pars.min_step_limit);
+    return dt;
 }
 
 void TimeIterator::call_hook()
@@ -253,31 +427,33 @@ void TimeIterator::call_hook()
 
     using THPair = std::pair<double, ITimeHook*>;
 
-    // Searching for hooks ready to be called
-    std::vector<THPair> hooks_to_call_now;
+    // Searching for hooks ready to be called. Buffer is not reallocated after warm-up
+    m_due_hooks.clear();
+    m_due_hooks.reserve(m_timeHooks.size());
     for (auto &hook : m_timeHooks)
     {
         double this_hook_time = hook->get_next_time();
         if (this_hook_time <= m_time)
         {
-            hooks_to_call_now.push_back(THPair(this_hook_time, hook));
+            m_due_hooks.push_back(THPair(this_hook_time, hook));
         }
     }
 
     // Sorting it by call time (important in case of many hooks applicable for one iteration)
     std::sort(
-        hooks_to_call_now.begin(),
-        hooks_to_call_now.end(),
+        m_due_hooks.begin(),
+        m_due_hooks.end(),
         [](const THPair& p1, const THPair& p2)
         {
             return p1.first < p2.first;
         }
     );
 
-    // Calling
-    for (auto &time_hook_pair : hooks_to_call_now)
+    // Calling. Hook may add hooks, so only hooks found above are called
+    const size_t due_count = m_due_hooks.size();
+    for (size_t i = 0; i < due_count; i++)
     {
-        time_hook_pair.second->run_hook(m_time);
+        m_due_hooks[i].second->run_hook(m_time);
     }
 }
 
@@ -297,6 +473,24 @@ void TimeIterator::find_next_hook()
 	}
 }
 
+double TimeIterator::next_hook_time()
+{
+    double result = std::numeric_limits<double>::infinity();
+    for (auto hook : m_timeHooks)
+        result = std::min(result, hook->get_next_time());
+    return result;
+}
+
+void TimeIterator::publish_metrics()
+{
+    m_metrics_exporter->publish(m_time, m_dt, m_metrics);
+}
+
+bool TimeIterator::is_fast_path_applicable()
+{
+    return !m_step_adj_pars.autoStepAdjustment && m_replay_schedule == nullptr && m_step_observer == nullptr;
+}
+
 void TimeIterator::assert_pointers_are_set()
 {
     if (!m_variable)
@@ -324,6 +518,16 @@ void TimeIterator::reset_metrics()
    m_metrics.reset();
 }
 
+void TimeIterator::set_steps_logging(bool enabled)
+{
+    m_log_steps = enabled;
+}
+
+void TimeIterator::reserve_steps_log(size_t steps)
+{
+    m_metrics.time_steps_log.reserve(m_metrics.time_steps_log.size() + steps);
+}
+
 
 void TimeIterator::stop()
 {
@@ -0,0 +1,389 @@
+#include "dsiterpp/trajectory-store.hpp"
+#include "dsiterpp/integration.hpp"
+#include "dsiterpp/utils.hpp"
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+using namespace dsiterpp;
+
+namespace {
+
+const size_t max_pending_chunks = 4;
+// Bits for leading zeros count and meaningful bits count of new window
+const unsigned window_header_bits = 12;
+
+uint64_t to_bits(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double from_bits(uint64_t bits)
+{
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/**
+ * Linear extrapolation by two previous values. Encoder and decoder should get
+ * exactly the same bits, so optimizer is not allowed to contract or reorder it
+ */
+uint64_t predict(const uint64_t previous[2], size_t seen, uint64_t mask)
+{
+    if (seen == 0)
+        return 0;
+    if (seen == 1)
+        return previous[1];
+    double prediction = fp_barrier(2.0 * from_bits(previous[1])) - from_bits(previous[0]);
+    return to_bits(fp_barrier(prediction)) & mask;
+}
+
+class BitWriter
+{
+public:
+    BitWriter(std::vector<uint8_t>& data) : m_data(data) {}
+
+    /// Write count lower bits of value, most significant first
+    void write(uint64_t value, unsigned count)
+    {
+        while (count > 0)
+        {
+            if (m_bit == 0)
+                m_data.push_back(0);
+            const unsigned free_bits = 8 - m_bit;
+            const unsigned take = std::min(free_bits, count);
+            const uint8_t part = static_cast<uint8_t>((value >> (count - take)) & ((1u << take) - 1));
+            m_data.back() |= static_cast<uint8_t>(part << (free_bits - take));
+            m_bit = (m_bit + take) % 8;
+            count -= take;
+        }
+    }
+
+private:
+    std::vector<uint8_t>& m_data;
+    unsigned m_bit = 0;
+};
+
+struct ComponentEncoder
+{
+    uint64_t previous[2] = {0, 0};
+    size_t seen = 0;
+    unsigned leading = 0;
+    unsigned trailing = 0;
+    bool has_window = false;
+};
+
+void encode(BitWriter& writer, ComponentEncoder& encoder, double value, uint64_t mask)
+{
+    const uint64_t bits = to_bits(value) & mask;
+    const uint64_t x = bits ^ predict(encoder.previous, encoder.seen, mask);
+    encoder.previous[0] = encoder.previous[1];
+    encoder.previous[1] = bits;
+    encoder.seen++;
+
+    // Control bits: 0 - same as prediction, 10 - meaningful bits fit previous window, 11 - new window
+    if (x == 0)
+    {
+        writer.write(0, 1);
+        return;
+    }
+
+    const unsigned leading = __builtin_clzll(x);
+    const unsigned trailing = __builtin_ctzll(x);
+    const unsigned length = 64 - leading - trailing;
+    // Previous window is reused only if it is cheaper than new one, otherwise after
+    // a single big XOR (i.e. exponent change) all next values take wide window
+    const bool fits_window = encoder.has_window && leading >= encoder.leading && trailing >= encoder.trailing;
+    if (fits_window && 64 - encoder.leading - encoder.trailing <= length + window_header_bits)
+    {
+        writer.write(2, 2);
+        writer.write(x >> encoder.trailing, 64 - encoder.leading - encoder.trailing);
+        return;
+    }
+
+    writer.write(3, 2);
+    writer.write(leading, 6);
+    writer.write(length - 1, 6);
+    writer.write(x >> trailing, length);
+    encoder.leading = leading;
+    encoder.trailing = trailing;
+    encoder.has_window = true;
+}
+
+}
+
+/////////////////////////
+// TrajectoryStore::Cursor
+
+TrajectoryStore::Cursor::Cursor(TrajectoryStore* store, size_t chunk, double from_time) :
+    m_store(store), m_from_time(from_time), m_chunk(chunk)
+{
+}
+
+bool TrajectoryStore::Cursor::next(double& time, std::vector<double>& state)
+{
+    const size_t n = m_store->m_state_size;
+    for (;;)
+    {
+        if (m_remaining == 0)
+        {
+            if (!load_chunk(m_chunk))
+                return false;
+            m_chunk++;
+        }
+
+        m_remaining--;
+        time = decode(m_decoders[0], ~uint64_t(0));
+        state.resize(n);
+        for (size_t i = 0; i < n; i++)
+            state[i] = decode(m_decoders[i + 1], m_store->m_state_mask);
+
+        if (time >= m_from_time)
+            return true;
+    }
+}
+
+bool TrajectoryStore::Cursor::load_chunk(size_t chunk)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_store->m_mutex);
+        if (chunk >= m_store->m_chunks.size())
+            return false;
+        const Chunk& stored = m_store->m_chunks[chunk];
+        m_data = &stored.data;
+        m_remaining = stored.count;
+    }
+    m_bit_position = 0;
+    m_decoders.assign(m_store->m_state_size + 1, ComponentDecoder());
+    return true;
+}
+
+uint64_t TrajectoryStore::Cursor::read_bits(unsigned count)
+{
+    uint64_t result = 0;
+    while (count > 0)
+    {
+        const unsigned bit = m_bit_position % 8;
+        const unsigned available = 8 - bit;
+        const unsigned take = std::min(available, count);
+        const uint8_t byte = (*m_data)[m_bit_position / 8];
+        const uint64_t part = (byte >> (available - take)) & ((1u << take) - 1);
+        result = (result << take) | part;
+        m_bit_position += take;
+        count -= take;
+    }
+    return result;
+}
+
+double TrajectoryStore::Cursor::decode(ComponentDecoder& decoder, uint64_t mask)
+{
+    uint64_t x = 0;
+    if (read_bits(1) != 0)
+    {
+        if (read_bits(1) != 0)
+        {
+            decoder.leading = static_cast<unsigned>(read_bits(6));
+            const unsigned length = static_cast<unsigned>(read_bits(6)) + 1;
+            decoder.trailing = 64 - decoder.leading - length;
+        }
+        x = read_bits(64 - decoder.leading - decoder.trailing) << decoder.trailing;
+    }
+
+    const uint64_t bits = x ^ predict(decoder.previous, decoder.seen, mask);
+    decoder.previous[0] = decoder.previous[1];
+    decoder.previous[1] = bits;
+    decoder.seen++;
+    return from_bits(bits);
+}
+
+/////////////////////////
+// TrajectoryStore
+
+TrajectoryStore::TrajectoryStore(size_t state_size, size_t chunk_snapshots, unsigned mantissa_bits) :
+    m_state_size(state_size), m_chunk_snapshots(chunk_snapshots)
+{
+    if (chunk_snapshots == 0)
+        throw std::invalid_argument("TrajectoryStore: chunk should contain at least one snapshot");
+    if (mantissa_bits > 52)
+        throw std::invalid_argument("TrajectoryStore: double has only 52 mantissa bits");
+
+    m_state_mask = ~((uint64_t(1) << (52 - mantissa_bits)) - 1);
+    m_worker = std::thread(&TrajectoryStore::worker, this);
+}
+
+TrajectoryStore::~TrajectoryStore()
+{
+    flush();
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_raw_ready.notify_all();
+    m_worker.join();
+}
+
+void TrajectoryStore::append(double time, const std::vector<double>& state)
+{
+    if (state.size() != m_state_size)
+        throw std::invalid_argument("TrajectoryStore: state size differs from given in constructor");
+    if (time < m_last_time)
+        throw std::invalid_argument("TrajectoryStore: snapshot times should not decrease");
+    m_last_time = time;
+
+    // Filling chunk is not visible to worker, so no lock here
+    const size_t stride = m_state_size + 1;
+    if (m_filling.values.size() != stride * m_chunk_snapshots)
+        m_filling.values.resize(stride * m_chunk_snapshots);
+
+    double* snapshot = &m_filling.values[stride * m_filling.count];
+    snapshot[0] = time;
+    std::copy(state.begin(), state.end(), snapshot + 1);
+    m_filling.count++;
+
+    if (m_filling.count == m_chunk_snapshots)
+        submit_filling();
+}
+
+void TrajectoryStore::flush()
+{
+    if (m_filling.count != 0)
+        submit_filling();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_raw_done.wait(lock, [this] { return m_pending.empty() && !m_compressing; });
+}
+
+TrajectoryStore::Cursor TrajectoryStore::read_from(double from_time)
+{
+    return Cursor(this, find_chunk(from_time), from_time);
+}
+
+size_t TrajectoryStore::state_size() const
+{
+    return m_state_size;
+}
+
+size_t TrajectoryStore::snapshots_count()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_snapshots;
+}
+
+size_t TrajectoryStore::chunks_count()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_chunks.size();
+}
+
+size_t TrajectoryStore::compressed_bytes()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_compressed_bytes;
+}
+
+size_t TrajectoryStore::raw_bytes()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_snapshots * (m_state_size + 1) * sizeof(double);
+}
+
+void TrajectoryStore::worker()
+{
+    for (;;)
+    {
+        RawChunk raw;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_raw_ready.wait(lock, [this] { return !m_pending.empty() || m_stop; });
+            if (m_pending.empty())
+                return;
+            raw = std::move(m_pending.front());
+            m_pending.pop_front();
+            m_compressing = true;
+        }
+
+        Chunk chunk;
+        compress(raw, chunk);
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_snapshots += chunk.count;
+            m_compressed_bytes += chunk.data.size();
+            m_chunks.push_back(std::move(chunk));
+            // Buffer is returned to producer, so steady state appending does not allocate
+            raw.count = 0;
+            m_free.push_back(std::move(raw));
+            m_compressing = false;
+        }
+        m_raw_done.notify_all();
+    }
+}
+
+void TrajectoryStore::compress(const RawChunk& raw, Chunk& chunk) const
+{
+    const size_t stride = m_state_size + 1;
+    chunk.count = raw.count;
+    chunk.begin_time = raw.values[0];
+    chunk.end_time = raw.values[stride * (raw.count - 1)];
+    chunk.data.clear();
+    chunk.data.reserve(raw.count * stride * sizeof(double) / 4);
+
+    BitWriter writer(chunk.data);
+    std::vector<ComponentEncoder> encoders(stride);
+    for (size_t s = 0; s < raw.count; s++)
+    {
+        const double* snapshot = &raw.values[stride * s];
+        encode(writer, encoders[0], snapshot[0], ~uint64_t(0));
+        for (size_t i = 0; i < m_state_size; i++)
+            encode(writer, encoders[i + 1], snapshot[i + 1], m_state_mask);
+    }
+    chunk.data.shrink_to_fit();
+}
+
+void TrajectoryStore::submit_filling()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_raw_done.wait(lock, [this] { return m_pending.size() < max_pending_chunks; });
+        m_pending.push_back(std::move(m_filling));
+        if (m_free.empty())
+        {
+            m_filling = RawChunk();
+        } else {
+            m_filling = std::move(m_free.back());
+            m_free.pop_back();
+        }
+        m_filling.count = 0;
+    }
+    m_raw_ready.notify_one();
+}
+
+size_t TrajectoryStore::find_chunk(double time)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = std::lower_bound(
+        m_chunks.begin(), m_chunks.end(), time,
+        [](const Chunk& chunk, double t) { return chunk.end_time < t; }
+    );
+    return static_cast<size_t>(it - m_chunks.begin());
+}
+
+/////////////////////////
+// TrajectoryRecorderHook
+
+TrajectoryRecorderHook::TrajectoryRecorderHook(IVariable* variable, TrajectoryStore* store) :
+    m_variable(variable), m_store(store)
+{
+}
+
+void TrajectoryRecorderHook::hook(double real_time, double wanted_time)
+{
+    DSITERPP_UNUSED(wanted_time);
+    m_values.clear();
+    m_variable->collect_values(m_values);
+    m_store->append(real_time, m_values);
+}
@@ -0,0 +1,86 @@
+/**
+ * Console monitor of solver metrics exported by SharedMetricsExporter:
+ *     dsiterpp-metrics-reader <segment name> [period in ms] [--once]
+ */
+
+#include "dsiterpp/shm-metrics.hpp"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+
+using namespace dsiterpp;
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <segment name> [period in ms] [--once]" << std::endl;
+        return 1;
+    }
+
+    const std::string name = argv[1];
+    int period_ms = 1000;
+    bool once = false;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--once") == 0)
+            once = true;
+        else
+            period_ms = atoi(argv[i]);
+    }
+    if (period_ms <= 0)
+        period_ms = 1000;
+
+    try {
+        SharedMetricsReader reader(name);
+        SharedMetricsSnapshot previous, current;
+        auto previous_time = std::chrono::steady_clock::now();
+        bool has_previous = false;
+
+        std::cout << std::setw(14) << "time" << std::setw(14) << "dt"
+                  << std::setw(12) << "steps" << std::setw(12) << "steps/s"
+                  << std::setw(10) << "rejected" << std::setw(10) << "min lim" << std::setw(10) << "max lim"
+                  << std::setw(12) << "rhs/s" << std::endl;
+
+        for (;;)
+        {
+            if (!reader.read(current))
+            {
+                std::cerr << "Segment is busy, skipping sample" << std::endl;
+            } else {
+                auto now = std::chrono::steady_clock::now();
+                double elapsed = std::chrono::duration<double>(now - previous_time).count();
+                double steps_rate = 0.0, rhs_rate = 0.0;
+                if (has_previous && elapsed > 0.0)
+                {
+                    steps_rate = (current.steps - previous.steps) / elapsed;
+                    rhs_rate = (current.rhs_evaluations - previous.rhs_evaluations) / elapsed;
+                }
+
+                std::cout << std::setw(14) << current.time << std::setw(14) << current.dt
+                          << std::setw(12) << current.steps << std::setw(12) << steps_rate
+                          << std::setw(10) << current.rejected_steps
+                          << std::setw(10) << current.min_step_limitations
+                          << std::setw(10) << current.max_step_limitations
+                          << std::setw(12) << rhs_rate << std::endl;
+
+                previous = current;
+                previous_time = now;
+                has_previous = true;
+            }
+
+            if (once)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(period_ms));
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
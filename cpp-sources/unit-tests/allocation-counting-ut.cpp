@@ -0,0 +1,210 @@
+#include "dsiterpp/time-iter.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/runge-error-estimator.hpp"
+#include "dsiterpp/sdirk.hpp"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+std::atomic<size_t> allocations_count(0);
+
+void* counted_allocation(std::size_t size)
+{
+    allocations_count++;
+    void* pointer = malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+}
+
+void* operator new(std::size_t size) { return counted_allocation(size); }
+void* operator new[](std::size_t size) { return counted_allocation(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { allocations_count++; return malloc(size == 0 ? 1 : size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { allocations_count++; return malloc(size == 0 ? 1 : size); }
+void operator delete(void* pointer) noexcept { free(pointer); }
+void operator delete[](void* pointer) noexcept { free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { free(pointer); }
+
+// Every deallocation compiler may call should match replaced allocation
+#ifdef __cpp_sized_deallocation
+void operator delete(void* pointer, std::size_t) noexcept { free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { free(pointer); }
+#endif
+
+#ifdef __cpp_aligned_new
+namespace {
+
+void* counted_aligned_allocation(std::size_t size, std::align_val_t alignment) noexcept
+{
+    allocations_count++;
+    // aligned_alloc() needs size multiple of alignment
+    std::size_t align = static_cast<std::size_t>(alignment);
+    return aligned_alloc(align, (size + align - 1) / align * align);
+}
+
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    void* pointer = counted_aligned_allocation(size == 0 ? 1 : size, alignment);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return counted_aligned_allocation(size == 0 ? 1 : size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return counted_aligned_allocation(size == 0 ? 1 : size, alignment); }
+void operator delete(void* pointer, std::align_val_t) noexcept { free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { free(pointer); }
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { free(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { free(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { free(pointer); }
+#endif
+
+namespace {
+
+/// Two coupled oscillators in a group, so the group paths are used too
+class Oscillators
+{
+public:
+    Oscillators() :
+        x1(1.0), v1(0.0), x2(0.0), v2(1.0),
+        rhs1(x1, [this](double, double) { return v1.current_value(); }),
+        rhs2(v1, [this](double, double x) { DSITERPP_UNUSED(x); return -x1.current_value() + 0.1 * x2.current_value(); }),
+        rhs3(x2, [this](double, double) { return v2.current_value(); }),
+        rhs4(v2, [this](double, double) { return -4.0 * x2.current_value(); })
+    {
+        for (VariableScalar* v : {&x1, &v1, &x2, &v2})
+            variable.add_variable(*v);
+        for (RHSScalar* r : {&rhs1, &rhs2, &rhs3, &rhs4})
+            rhs.add_rhs(r);
+    }
+
+    VariableScalar x1, v1, x2, v2;
+    RHSScalar rhs1, rhs2, rhs3, rhs4;
+    VariablesGroup variable;
+    RHSGroup rhs;
+};
+
+class CountingHook : public TimeHookPeriodic
+{
+public:
+    void hook(double real_time, double wanted_time) override
+    {
+        DSITERPP_UNUSED(real_time); DSITERPP_UNUSED(wanted_time);
+        calls++;
+    }
+
+    size_t calls = 0;
+};
+
+size_t allocations_in_steady_state(TimeIterator& time_iterator, size_t warm_up_steps, size_t steps)
+{
+    for (size_t i = 0; i < warm_up_steps; i++)
+        time_iterator.iterate();
+
+    size_t before = allocations_count;
+    for (size_t i = 0; i < steps; i++)
+        time_iterator.iterate();
+    return allocations_count - before;
+}
+
+}
+
+TEST(AllocationCounting, CounterWorks)
+{
+    size_t before = allocations_count;
+    std::vector<double>* v = new std::vector<double>(10);
+    delete v;
+    ASSERT_EQ(before + 2, allocations_count);
+}
+
+TEST(AllocationCounting, AdaptiveStepsWithHooks)
+{
+    Oscillators problem;
+    RungeKuttaIterator rk4;
+    RungeErrorEstimator estimator;
+    CountingHook hook1, hook2;
+    hook1.set_period(0.01);
+    hook2.set_period(0.025);
+
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&problem.variable);
+    time_iterator.set_rhs(&problem.rhs);
+    time_iterator.set_continious_iterator(&rk4);
+    time_iterator.set_error_estimator(&estimator);
+    time_iterator.add_hook(&hook1);
+    time_iterator.add_hook(&hook2);
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-6);
+    time_iterator.set_steps_logging(false);
+    time_iterator.set_stop_time(1e9);
+
+    ASSERT_EQ(0u, allocations_in_steady_state(time_iterator, 100, 2000));
+    ASSERT_GT(hook1.calls, 10u);
+    ASSERT_GT(time_iterator.metrics().rejected_steps + time_iterator.metrics().max_step_limitations, 0u);
+    ASSERT_TRUE(time_iterator.metrics().time_steps_log.empty());
+}
+
+TEST(AllocationCounting, ReservedStepsLog)
+{
+    Oscillators problem;
+    SDIRK2Iterator sdirk;
+
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&problem.variable);
+    time_iterator.set_rhs(&problem.rhs);
+    time_iterator.set_continious_iterator(&sdirk);
+    time_iterator.set_step(0.01);
+    time_iterator.set_stop_time(1e9);
+    time_iterator.reserve_steps_log(1000);
+
+    ASSERT_EQ(0u, allocations_in_steady_state(time_iterator, 10, 900));
+    ASSERT_EQ(910u, time_iterator.metrics().time_steps_log.size());
+}
+
+TEST(AllocationCounting, HookAddsHooks)
+{
+    Oscillators problem;
+    RungeKuttaIterator rk4;
+
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&problem.variable);
+    time_iterator.set_rhs(&problem.rhs);
+    time_iterator.set_continious_iterator(&rk4);
+    time_iterator.set_step(0.001);
+
+    // Every call of adder registers one more hook, so reused buffer of due hooks grows
+    // while hooks are called
+    std::vector<std::unique_ptr<TimeHookPeriodicFunc>> added;
+    size_t added_calls = 0;
+    TimeHookPeriodicFunc adder(
+        [&](double, double)
+        {
+            added.emplace_back(new TimeHookPeriodicFunc([&](double, double) { added_calls++; }));
+            added.back()->set_period(0.1);
+            time_iterator.add_hook(added.back().get());
+        }
+    );
+    adder.set_period(0.05);
+    time_iterator.add_hook(&adder);
+
+    time_iterator.set_stop_time(1.0);
+    time_iterator.run();
+
+    ASSERT_GT(added.size(), 15u);
+    ASSERT_GT(added_calls, added.size());
+}
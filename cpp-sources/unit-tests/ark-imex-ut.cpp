@@ -0,0 +1,172 @@
+#include "dsiterpp/ark-imex.hpp"
+#include "dsiterpp/time-iter.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "test-utils.hpp"
+#include <stdexcept>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/// Variable written before set_deltas() and clear_rhs() were added to IVariable
+class OutOfTreeVariable : public IVariable
+{
+public:
+    void clear_subiteration() override { current = previous; delta = 0.0; }
+    void add_rhs_to_delta(double m) override { delta += rhs * m; }
+    void make_sub_iteration(double dt) override { current = previous + rhs * dt; }
+    void step() override { current = previous = previous + delta; delta = 0.0; }
+    void collect_values(std::vector<double>& values) const override { values.push_back(current); }
+    void collect_deltas(std::vector<double>& deltas) const override { deltas.push_back(delta); }
+    void set_values(std::vector<double>::const_iterator& values) override { current = previous = *values++; delta = 0.0; }
+
+    double previous = 0.0, current = 0.0, delta = 0.0, rhs = 0.0;
+};
+
+/**
+ * Oscillator x' = z, z' = -x is non-stiff, w is stiffly relaxed to x + sin(t):
+ *     w' = [z + cos(t)] + [-k (w - x - sin(t))]
+ * so w = cos(t) + sin(t). Both parts of w' are added to the same variable,
+ * IMEX integrator evaluates them separately, others evaluate their sum
+ */
+class RelaxedOscillator
+{
+public:
+    RelaxedOscillator(double k) :
+        x(1.0), z(0.0), w(1.0),
+        oscillator([this](double) { x.set_rhs(z.current_value()); z.set_rhs(-x.current_value()); }),
+        forcing([this](double t) { w.add_to_rhs(z.current_value() + cos(t)); }),
+        relaxation([this, k](double t) { w.add_to_rhs(-k * (w.current_value() - x.current_value() - sin(t))); })
+    {
+        variable.add_variable(x);
+        variable.add_variable(z);
+        variable.add_variable(w);
+        rhs.add_rhs(&oscillator, RHSGroup::Treatment::explicit_part);
+        rhs.add_rhs(&forcing, RHSGroup::Treatment::explicit_part);
+        rhs.add_rhs(&relaxation, RHSGroup::Treatment::implicit_part);
+        rhs.set_variable(&variable);
+    }
+
+    double max_error(double t)
+    {
+        double error = std::max(fabs(x - cos(t)), fabs(z + sin(t)));
+        return std::max(error, fabs(w - cos(t) - sin(t)));
+    }
+
+    VariableScalar x, z, w;
+    FunctionRHS oscillator, forcing, relaxation;
+    VariablesGroup variable;
+    RHSGroup rhs;
+};
+
+double integrate(RelaxedOscillator& problem, IIntegrator& integrator, double dt)
+{
+    return problem.max_error(run_fixed_step(&problem.variable, &problem.rhs, &integrator, dt, 1.0));
+}
+
+}
+
+TEST(ARKIMEX, TableauxAreConsistent)
+{
+    for (const ARKIMEXTableau& tableau : {ARKIMEXTableau::ark324l2sa(), ARKIMEXTableau::ark436l2sa()})
+    {
+        double b_sum = 0.0, d_sum = 0.0;
+        for (size_t s = 0; s < tableau.stages; s++)
+        {
+            b_sum += tableau.b[s];
+            d_sum += tableau.d[s];
+            double explicit_sum = 0.0, implicit_sum = 0.0;
+            for (auto a : tableau.a_explicit[s])
+                explicit_sum += a;
+            for (auto a : tableau.a_implicit[s])
+                implicit_sum += a;
+            ASSERT_NEAR(tableau.c[s], explicit_sum, 1e-14);
+            ASSERT_NEAR(tableau.c[s], implicit_sum, 1e-14);
+        }
+        ASSERT_NEAR(1.0, b_sum, 1e-14);
+        ASSERT_NEAR(1.0, d_sum, 1e-14);
+    }
+}
+
+TEST(ARKIMEX, ConvergenceOrder)
+{
+    for (const ARKIMEXTableau& tableau : {ARKIMEXTableau::ark324l2sa(), ARKIMEXTableau::ark436l2sa()})
+    {
+        ARKIMEXIterator ark(tableau);
+        RelaxedOscillator coarse(1.0);
+        double coarse_error = integrate(coarse, ark, 0.05);
+        RelaxedOscillator fine(1.0);
+        double fine_error = integrate(fine, ark, 0.025);
+
+        ASSERT_GT(coarse_error / fine_error, 0.75 * pow(2.0, tableau.order));
+    }
+}
+
+TEST(ARKIMEX, StiffProblemWithLargeStep)
+{
+    // Explicit methods need dt < 3e-5 here. Stiff component has order reduction,
+    // so accuracy is checked only
+    ARKIMEXIterator ark3(ARKIMEXTableau::ark324l2sa());
+    RelaxedOscillator problem3(1e5);
+    ASSERT_LT(integrate(problem3, ark3, 0.05), 1e-3);
+
+    ARKIMEXIterator ark4(ARKIMEXTableau::ark436l2sa());
+    RelaxedOscillator problem4(1e5);
+    ASSERT_LT(integrate(problem4, ark4, 0.05), 1e-6);
+}
+
+TEST(ARKIMEX, ImplicitSolvesCoverStiffPartOnly)
+{
+    RelaxedOscillator problem(1e5);
+    ARKIMEXIterator ark(ARKIMEXTableau::ark436l2sa());
+
+    // Jacobian of the implicit part has only the row of w
+    bool jacobian_is_checked = false;
+    ark.set_jacobian_function([&jacobian_is_checked](double, const std::vector<double>&, DenseMatrix& jacobian) {
+        jacobian.set_zero();
+        jacobian(2, 0) = 1e5;
+        jacobian(2, 2) = -1e5;
+        jacobian_is_checked = true;
+    });
+
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&problem.variable);
+    time_iterator.set_rhs(&problem.rhs);
+    time_iterator.set_continious_iterator(&ark);
+    time_iterator.set_error_estimator(&ark);
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().max_step_limit = 0.5;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-4);
+    time_iterator.set_step(1e-3);
+    time_iterator.set_stop_time(1.0);
+    time_iterator.run();
+
+    ASSERT_TRUE(jacobian_is_checked);
+    ASSERT_LT(problem.max_error(time_iterator.get_time()), 1e-5);
+    ASSERT_LT(time_iterator.metrics().time_steps_log.size(), 1000u);
+
+    // Linear implicit part converges in two Newton iterations with exact Jacobian
+    ASSERT_LE(ark.implicit_evaluations_count(), 2 * ark.explicit_evaluations_count());
+}
+
+TEST(ARKIMEX, ClearRHSIsOptionalForVariables)
+{
+    OutOfTreeVariable variable;
+    ASSERT_THROW(variable.clear_rhs(), std::logic_error);
+}
+
+TEST(ARKIMEX, TaggedGroupIsTheSameModelForOtherIntegrators)
+{
+    RelaxedOscillator explicit_problem(1.0);
+    RungeKuttaIterator rk4;
+    ASSERT_LT(integrate(explicit_problem, rk4, 0.01), 1e-8);
+
+    RelaxedOscillator imex_problem(1.0);
+    ARKIMEXIterator ark(ARKIMEXTableau::ark436l2sa());
+    integrate(imex_problem, ark, 0.01);
+    ASSERT_NEAR(explicit_problem.w, imex_problem.w, 1e-8);
+    ASSERT_NEAR(explicit_problem.x, imex_problem.x, 1e-8);
+}
@@ -0,0 +1,81 @@
+#include "exponent-time-iterable.hpp"
+#include "dsiterpp/async-hook.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include <thread>
+#include <chrono>
+#include <stdexcept>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+struct HookRecord
+{
+    double real_time;
+    double wanted_time;
+    double value;
+};
+
+}
+
+TEST(AsyncHook, BlockPolicyKeepsAllSnapshotsInOrder)
+{
+    RungeKuttaIterator rk;
+    ExponentProblem problem(&rk);
+    std::vector<HookRecord> records;
+    AsyncTimeHook hook(&problem.variable, [&records](double real_time, double wanted_time, const std::vector<double>& state) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        records.push_back(HookRecord{real_time, wanted_time, state[0]});
+    }, 2, AsyncTimeHook::OverflowPolicy::block);
+    hook.set_period(0.01);
+    problem.time_iterator.add_hook(&hook);
+    problem.iterate(1.0);
+    hook.wait();
+
+    ASSERT_EQ(0u, hook.dropped_count());
+    ASSERT_GE(records.size(), 99u);
+    ASSERT_EQ(records.size(), hook.processed_count());
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        if (i != 0)
+        {
+            ASSERT_LT(records[i - 1].wanted_time, records[i].wanted_time);
+        }
+        ASSERT_LE(records[i].wanted_time, records[i].real_time);
+        // Snapshot is taken at hook time, not when hook function runs
+        ASSERT_NEAR(exp(records[i].real_time), records[i].value, 1e-6);
+    }
+}
+
+TEST(AsyncHook, DropPolicyDoesNotBlock)
+{
+    RungeKuttaIterator rk;
+    ExponentProblem problem(&rk);
+    std::vector<double> wanted_times;
+    AsyncTimeHook hook(&problem.variable, [&wanted_times](double, double wanted_time, const std::vector<double>&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        wanted_times.push_back(wanted_time);
+    }, 1, AsyncTimeHook::OverflowPolicy::drop);
+    hook.set_period(0.01);
+    problem.time_iterator.add_hook(&hook);
+    problem.iterate(1.0);
+    hook.wait();
+
+    ASSERT_GT(hook.dropped_count(), 0u);
+    ASSERT_EQ(wanted_times.size(), hook.processed_count());
+    for (size_t i = 1; i < wanted_times.size(); i++)
+        ASSERT_LT(wanted_times[i - 1], wanted_times[i]);
+}
+
+TEST(AsyncHook, ExceptionIsRethrown)
+{
+    VariableScalar x(1.0);
+    AsyncTimeHook hook(&x, [](double, double, const std::vector<double>&) {
+        throw std::runtime_error("hook failed");
+    });
+    hook.run_hook(0.0);
+    ASSERT_THROW(hook.wait(), std::runtime_error);
+}
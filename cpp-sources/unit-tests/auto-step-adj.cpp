@@ -1,6 +1,7 @@
 #include "exponent-time-iterable.hpp"
 #include "dsiterpp/euler-explicit.hpp"
 #include "dsiterpp/runge-error-estimator.hpp"
+#include "dsiterpp/bifurcation.hpp"
 #include <cmath>
 
 #include "gtest/gtest.h"
@@ -28,3 +29,71 @@ TEST(AutoStepAdj, EulerBasedTest)
 
     ASSERT_NEAR(ground_thruth, exp_problem.value(), allowed_result_relative_error * ground_thruth);
 }
+
+TEST(AutoStepAdj, AutoInitialStep)
+{
+    double time_limit = 3.0;
+    double allowed_result_relative_error = 0.01;
+    size_t rejected_steps[2];
+    for (int auto_initial_step = 0; auto_initial_step < 2; auto_initial_step++)
+    {
+        EulerExplicitIterator euler;
+        RungeErrorEstimator estimator;
+
+        ExponentProblem exp_problem(&euler, 1.0);
+        exp_problem.time_iterator.set_error_estimator(&estimator);
+        exp_problem.time_iterator.step_adj_pars().autoStepAdjustment = true;
+        exp_problem.time_iterator.step_adj_pars().auto_initial_step = auto_initial_step == 1;
+        exp_problem.time_iterator.step_adj_pars().max_step_limit = 0.01;
+        exp_problem.time_iterator.step_adj_pars().min_step_limit = 1e-9;
+        exp_problem.time_iterator.step_adj_pars().setup_relative_deconvergence_speed(allowed_result_relative_error / time_limit);
+
+        // Very bad initial guess
+        exp_problem.time_iterator.set_time(0.0);
+        exp_problem.time_iterator.set_step(1.0);
+        exp_problem.time_iterator.set_stop_time(time_limit);
+        exp_problem.time_iterator.run();
+
+        if (auto_initial_step)
+        {
+            double ground_thruth = exp(exp_problem.time_iterator.get_time());
+            ASSERT_NEAR(ground_thruth, exp_problem.value(), allowed_result_relative_error * ground_thruth);
+        }
+        ASSERT_EQ(size_t(auto_initial_step), exp_problem.time_iterator.metrics().initial_step_estimations);
+        rejected_steps[auto_initial_step] = exp_problem.time_iterator.metrics().rejected_steps;
+    }
+    ASSERT_LT(rejected_steps[1], rejected_steps[0]);
+}
+
+class ValueJumpBifurcator : public IBifurcator
+{
+public:
+    ValueJumpBifurcator(VariableScalar& variable) : m_variable(variable) {}
+    void do_bifurcation(double time, double dt) override
+    {
+        DSITERPP_UNUSED(time); DSITERPP_UNUSED(dt);
+        m_variable = m_variable * 100.0;
+    }
+
+private:
+    VariableScalar& m_variable;
+};
+
+TEST(AutoStepAdj, InitialStepReestimationAfterBifurcation)
+{
+    EulerExplicitIterator euler;
+    RungeErrorEstimator estimator;
+
+    ExponentProblem exp_problem(&euler, 1.0);
+    ValueJumpBifurcator bifurcator(exp_problem.variable);
+    exp_problem.time_iterator.set_error_estimator(&estimator);
+    exp_problem.time_iterator.set_bifurcator(&bifurcator);
+    exp_problem.time_iterator.set_bifurcation_run_period(1.0);
+    exp_problem.time_iterator.step_adj_pars().autoStepAdjustment = true;
+    exp_problem.time_iterator.step_adj_pars().auto_initial_step = true;
+
+    exp_problem.iterate(2.5);
+
+    // Initial one and one after each of 2 bifurcations
+    ASSERT_EQ(3u, exp_problem.time_iterator.metrics().initial_step_estimations);
+}
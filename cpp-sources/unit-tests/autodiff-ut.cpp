@@ -0,0 +1,152 @@
+#include "dsiterpp/autodiff.hpp"
+#include "dsiterpp/sdirk.hpp"
+#include "dsiterpp/time-iter.hpp"
+#include "dsiterpp/integration.hpp"
+#include <vector>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/// Robertson chemical kinetics, classic stiff problem
+struct RobertsonRHS
+{
+    template<typename T>
+    void operator()(double t, const std::vector<T>& x, std::vector<T>& dxdt)
+    {
+        DSITERPP_UNUSED(t);
+        dxdt.resize(3);
+        dxdt[0] = -0.04 * x[0] + 1e4 * x[1] * x[2];
+        dxdt[1] = 0.04 * x[0] - 1e4 * x[1] * x[2] - 3e7 * x[1] * x[1];
+        dxdt[2] = 3e7 * x[1] * x[1];
+    }
+
+    static void jacobian(const std::vector<double>& x, DenseMatrix& j)
+    {
+        j.resize(3);
+        j(0, 0) = -0.04; j(0, 1) = 1e4 * x[2];                  j(0, 2) = 1e4 * x[1];
+        j(1, 0) = 0.04;  j(1, 1) = -1e4 * x[2] - 6e7 * x[1];    j(1, 2) = -1e4 * x[1];
+        j(2, 0) = 0.0;   j(2, 1) = 6e7 * x[1];                  j(2, 2) = 0.0;
+    }
+};
+
+/// Interface path RHS for the same system
+class RobertsonProblem : public IRHS
+{
+public:
+    RobertsonProblem() : x0(1.0), x1(0.0), x2(0.0)
+    {
+        variable.add_variable(x0);
+        variable.add_variable(x1);
+        variable.add_variable(x2);
+    }
+
+    void calculate_rhs(double time) override
+    {
+        m_x = {x0.current_value(), x1.current_value(), x2.current_value()};
+        m_rhs(time, m_x, m_f);
+        x0.set_rhs(m_f[0]);
+        x1.set_rhs(m_f[1]);
+        x2.set_rhs(m_f[2]);
+    }
+
+    void run(IIntegrator* integrator)
+    {
+        TimeIterator time_iterator;
+        time_iterator.set_variable(&variable);
+        time_iterator.set_rhs(this);
+        time_iterator.set_continious_iterator(integrator);
+        time_iterator.set_step(0.001);
+        time_iterator.set_stop_time(0.5);
+        time_iterator.run();
+    }
+
+    VariableScalar x0, x1, x2;
+    VariablesGroup variable;
+
+private:
+    RobertsonRHS m_rhs;
+    std::vector<double> m_x, m_f;
+};
+
+}
+
+TEST(Autodiff, DualDerivatives)
+{
+    using D = Dual<2>;
+    const double x = 0.7, y = 1.3;
+    D a = D::variable(x, 0), b = D::variable(y, 1);
+    D f = sin(a) * exp(b) / (1.0 + a * a) + pow(b, 3.0) + sqrt(a) * log(b) - 2.0 * tanh(a - b);
+
+    double value = sin(x) * exp(y) / (1.0 + x * x) + pow(y, 3.0) + sqrt(x) * log(y) - 2.0 * tanh(x - y);
+    double df_dx = (cos(x) * (1.0 + x * x) - 2.0 * x * sin(x)) * exp(y) / pow(1.0 + x * x, 2.0)
+        + 0.5 / sqrt(x) * log(y) - 2.0 * (1.0 - pow(tanh(x - y), 2.0));
+    double df_dy = sin(x) * exp(y) / (1.0 + x * x) + 3.0 * y * y + sqrt(x) / y + 2.0 * (1.0 - pow(tanh(x - y), 2.0));
+
+    ASSERT_NEAR(value, f.value, 1e-14);
+    ASSERT_NEAR(df_dx, f.derivatives[0], 1e-13);
+    ASSERT_NEAR(df_dy, f.derivatives[1], 1e-13);
+    ASSERT_TRUE(a < b);
+}
+
+TEST(Autodiff, JacobianIsExact)
+{
+    std::vector<double> x{0.9, 3e-5, 0.1};
+    DenseMatrix expected, jacobian;
+    RobertsonRHS::jacobian(x, expected);
+
+    auto dual_jacobian = make_dual_jacobian<2>(RobertsonRHS());
+    dual_jacobian(0.0, x, jacobian);
+    ASSERT_EQ(2u, dual_jacobian.passes_count());
+    for (size_t i = 0; i < 3; i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+            ASSERT_NEAR(expected(i, j), jacobian(i, j), 1e-12 * (1.0 + fabs(expected(i, j))));
+    }
+}
+
+TEST(Autodiff, JacobianVectorProductsInBatches)
+{
+    std::vector<double> x{0.9, 3e-5, 0.1};
+    std::vector<std::vector<double>> directions{{1.0, 0.0, 0.0}, {0.5, -1.0, 2.0}, {0.0, 0.0, 1.0}};
+    DenseMatrix expected;
+    RobertsonRHS::jacobian(x, expected);
+
+    DualJacobian<RobertsonRHS, 2> dual_jacobian;
+    std::vector<std::vector<double>> products;
+    std::vector<double> f;
+    dual_jacobian.jacobian_vector_products(0.0, x, directions, products, &f);
+    ASSERT_EQ(2u, dual_jacobian.passes_count());
+
+    std::vector<double> f_expected;
+    RobertsonRHS()(0.0, x, f_expected);
+    ASSERT_EQ(3u, f.size());
+    for (size_t i = 0; i < 3; i++)
+        ASSERT_NEAR(f_expected[i], f[i], 1e-15);
+
+    std::vector<double> product;
+    for (size_t k = 0; k < directions.size(); k++)
+    {
+        expected.multiply(directions[k], product);
+        for (size_t i = 0; i < 3; i++)
+            ASSERT_NEAR(product[i], products[k][i], 1e-12 * (1.0 + fabs(product[i])));
+    }
+}
+
+TEST(Autodiff, FeedsImplicitIntegrator)
+{
+    SDIRK2Iterator finite_differences_sdirk, dual_sdirk;
+    dual_sdirk.set_jacobian_function(make_dual_jacobian<3>(RobertsonRHS()));
+
+    RobertsonProblem reference, problem;
+    reference.run(&finite_differences_sdirk);
+    problem.run(&dual_sdirk);
+
+    ASSERT_NEAR(1.0, problem.x0 + problem.x1 + problem.x2, 1e-12);
+    ASSERT_NEAR(reference.x0, problem.x0, 1e-8);
+    ASSERT_NEAR(reference.x1, problem.x1, 1e-8 * reference.x1);
+    ASSERT_NEAR(reference.x2, problem.x2, 1e-8);
+}
@@ -0,0 +1,194 @@
+#include "dsiterpp/bdf.hpp"
+#include "dsiterpp/time-iter.hpp"
+#include <memory>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/// Semi-discrete heat equation u' = u_xx on (0, 1) with zero boundary values
+class HeatEquation : public IRHS
+{
+public:
+    HeatEquation(size_t size) :
+        h(1.0 / (size + 1))
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            nodes.emplace_back(new VariableScalar(sin(M_PI * h * (i + 1))));
+            variable.add_variable(*nodes.back());
+        }
+    }
+
+    void calculate_rhs(double time) override
+    {
+        DSITERPP_UNUSED(time);
+        const size_t n = nodes.size();
+        for (size_t i = 0; i < n; i++)
+        {
+            double left = i == 0 ? 0.0 : nodes[i - 1]->current_value();
+            double right = i + 1 == n ? 0.0 : nodes[i + 1]->current_value();
+            nodes[i]->set_rhs((left - 2.0 * nodes[i]->current_value() + right) / (h * h));
+        }
+    }
+
+    /// Exact solution of semi-discrete system
+    double exact(size_t i, double t)
+    {
+        double lambda = -4.0 / (h * h) * pow(sin(M_PI * h / 2.0), 2);
+        return sin(M_PI * h * (i + 1)) * exp(lambda * t);
+    }
+
+    double h;
+    std::vector<std::unique_ptr<VariableScalar>> nodes;
+    VariablesGroup variable;
+};
+
+/// Exact solution of (I - gamma * A) z = r for tridiagonal A by Thomas algorithm
+class TridiagonalPreconditioner : public IPreconditioner
+{
+public:
+    TridiagonalPreconditioner(double h) : m_h(h) {}
+
+    void setup(double t, const std::vector<double>& x, double gamma) override
+    {
+        DSITERPP_UNUSED(t); DSITERPP_UNUSED(x);
+        m_gamma = gamma;
+    }
+
+    void apply(const std::vector<double>& r, std::vector<double>& z) override
+    {
+        const size_t n = r.size();
+        const double off = - m_gamma / (m_h * m_h), diag = 1.0 + 2.0 * m_gamma / (m_h * m_h);
+        m_c.resize(n);
+        z.resize(n);
+        m_c[0] = off / diag;
+        z[0] = r[0] / diag;
+        for (size_t i = 1; i < n; i++)
+        {
+            double denominator = diag - off * m_c[i - 1];
+            m_c[i] = off / denominator;
+            z[i] = (r[i] - off * z[i - 1]) / denominator;
+        }
+        for (size_t i = n - 1; i-- > 0; )
+            z[i] -= m_c[i] * z[i + 1];
+    }
+
+private:
+    double m_h;
+    double m_gamma = 0.0;
+    std::vector<double> m_c;
+};
+
+size_t integrate_heat_equation(BDFIterator& bdf, HeatEquation& heat, double stop_time)
+{
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&heat.variable);
+    time_iterator.set_rhs(&heat);
+    time_iterator.set_continious_iterator(&bdf);
+    time_iterator.set_error_estimator(&bdf);
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().min_step_limit = 1e-9;
+    time_iterator.step_adj_pars().max_step_limit = 0.05;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-4);
+    time_iterator.set_step(1e-5);
+    time_iterator.set_stop_time(stop_time);
+    time_iterator.run();
+
+    double max_error = 0.0;
+    for (size_t i = 0; i < heat.nodes.size(); i++)
+        max_error = std::max(max_error, fabs(heat.exact(i, time_iterator.get_time()) - *heat.nodes[i]));
+    double amplitude = heat.exact(heat.nodes.size() / 2, time_iterator.get_time());
+    EXPECT_LT(max_error, 1e-3 * amplitude);
+    return time_iterator.metrics().time_steps_log.size();
+}
+
+}
+
+TEST(BDF, StiffHeatEquation)
+{
+    HeatEquation heat(100);
+    BDFIterator bdf;
+    size_t steps = integrate_heat_equation(bdf, heat, 0.5);
+
+    // Explicit method would need dt < h^2 / 2, that is about 10^4 steps
+    EXPECT_LT(steps, 500u);
+    EXPECT_GE(bdf.statistics().max_used_order, 3u);
+    EXPECT_EQ(0u, bdf.statistics().preconditioner_setups);
+}
+
+TEST(BDF, Preconditioner)
+{
+    HeatEquation heat(100), heat_preconditioned(100);
+    BDFIterator bdf, bdf_preconditioned;
+    TridiagonalPreconditioner preconditioner(heat.h);
+    bdf_preconditioned.set_preconditioner(&preconditioner);
+
+    integrate_heat_equation(bdf, heat, 0.5);
+    integrate_heat_equation(bdf_preconditioned, heat_preconditioned, 0.5);
+
+    const BDFStatistics& statistics = bdf_preconditioned.statistics();
+    EXPECT_LT(statistics.krylov_iterations, bdf.statistics().krylov_iterations / 2);
+    // Preconditioner is reused by many steps
+    EXPECT_GT(statistics.preconditioner_setups, 0u);
+    EXPECT_LT(statistics.preconditioner_setups, statistics.steps / 2);
+}
+
+TEST(BDF, FixedStepOrder)
+{
+    // x' = -x with fixed step
+    auto error = [](size_t max_order, double dt) {
+        VariableScalar x(1.0);
+        RHSScalar rhs(x, [](double, double x) { return -x; });
+        BDFIterator bdf;
+        bdf.parameters().max_order = max_order;
+        TimeIterator time_iterator;
+        time_iterator.set_variable(&x);
+        time_iterator.set_rhs(&rhs);
+        time_iterator.set_continious_iterator(&bdf);
+        time_iterator.set_step(dt);
+        time_iterator.set_stop_time(1.0 - dt / 2);
+        time_iterator.run();
+        return fabs(x - exp(-time_iterator.get_time()));
+    };
+    double ratio = error(1, 0.01) / error(1, 0.005);
+    EXPECT_NEAR(2.0, ratio, 0.2);
+    // Higher orders after startup from implicit Euler step
+    EXPECT_LT(error(3, 0.01), 0.05 * error(1, 0.01));
+}
+
+TEST(BDF, OrderIsHeldOnLongSmoothRun)
+{
+    // Harmonic oscillator, history should never be restarted by rounding of variable
+    VariableScalar x(1.0), v(0.0);
+    RHSScalar x_rhs(x, [&v](double, double) { return v.current_value(); });
+    RHSScalar v_rhs(v, [&x](double, double) { return -x.current_value(); });
+    VariablesGroup variable;
+    variable.add_variable(x);
+    variable.add_variable(v);
+    RHSGroup rhs;
+    rhs.add_rhs(&x_rhs);
+    rhs.add_rhs(&v_rhs);
+
+    BDFIterator bdf;
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&variable);
+    time_iterator.set_rhs(&rhs);
+    time_iterator.set_continious_iterator(&bdf);
+    time_iterator.set_error_estimator(&bdf);
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().min_step_limit = 1e-9;
+    time_iterator.step_adj_pars().max_step_limit = 0.1;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-5);
+    time_iterator.set_step(1e-4);
+    time_iterator.set_stop_time(20.0);
+    time_iterator.run();
+
+    EXPECT_EQ(0u, bdf.statistics().history_restarts);
+    EXPECT_GE(bdf.statistics().max_used_order, 4u);
+    EXPECT_GE(bdf.order(), 3u);
+    EXPECT_NEAR(cos(time_iterator.get_time()), x, 1e-2);
+}
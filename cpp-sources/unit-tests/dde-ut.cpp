@@ -0,0 +1,92 @@
+#include "dsiterpp/dde.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/runge-error-estimator.hpp"
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/// x'(t) = -x(t - 1), x(t) = 1 for t <= 0
+class DelayedDecayRHS : public IRHS
+{
+public:
+    DelayedDecayRHS(VariableScalar& x, DelayHistory& history) :
+        m_x(x), m_history(history)
+    { }
+
+    void calculate_rhs(double time) override
+    {
+        m_x.set_rhs(-m_history.value(time - 1.0, 0));
+    }
+
+private:
+    VariableScalar& m_x;
+    DelayHistory& m_history;
+};
+
+/// Solution by method of steps at t = 1, 2, 3
+const double exact_values[] = {0.0, -0.5, -1.0 / 6.0};
+
+}
+
+TEST(DDE, MethodOfStepsSolution)
+{
+    VariableScalar x(1.0);
+    DelayHistory history;
+    DelayedDecayRHS rhs(x, history);
+    history.set_target(&x, &rhs);
+    history.add_delay(1.0);
+
+    RungeKuttaIterator rk;
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&x);
+    time_iterator.set_rhs(&rhs);
+    time_iterator.set_continious_iterator(&rk);
+    time_iterator.set_step_observer(&history);
+    time_iterator.set_step(0.007);
+
+    for (int i = 0; i < 3; i++)
+    {
+        time_iterator.set_stop_time(i + 1.0);
+        time_iterator.run();
+        // Breakpoints are hit exactly
+        ASSERT_NEAR(i + 1.0, time_iterator.get_time(), 1e-12);
+        EXPECT_NEAR(exact_values[i], x, 1e-9);
+    }
+
+    // History covers only max delay
+    EXPECT_LE(history.samples_count(), size_t(1.0 / 0.007) + 3);
+    EXPECT_NEAR(-0.5, history.value(2.0, 0), 1e-9);
+    EXPECT_THROW(history.value(1.5, 0), std::runtime_error);
+}
+
+TEST(DDE, StepAdjustmentWithDelay)
+{
+    VariableScalar x(1.0);
+    DelayHistory history;
+    DelayedDecayRHS rhs(x, history);
+    history.set_target(&x, &rhs);
+    history.add_delay(1.0);
+    history.set_initial_history([](double, size_t) { return 1.0; });
+
+    RungeKuttaIterator rk;
+    RungeErrorEstimator estimator;
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&x);
+    time_iterator.set_rhs(&rhs);
+    time_iterator.set_continious_iterator(&rk);
+    time_iterator.set_error_estimator(&estimator);
+    time_iterator.set_step_observer(&history);
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().max_step_limit = 0.1;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-7);
+    time_iterator.set_step(0.001);
+    time_iterator.set_stop_time(3.0);
+    time_iterator.run();
+
+    ASSERT_NEAR(3.0, time_iterator.get_time(), 1e-12);
+    EXPECT_NEAR(exact_values[2], x, 1e-6);
+}
@@ -0,0 +1,163 @@
+#include "dsiterpp/exponential.hpp"
+#include "dsiterpp/time-iter.hpp"
+#include "test-utils.hpp"
+#include <memory>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/// x_i' = a_i x_i + x_i^2 with very different a_i
+class StiffRiccati : public ISemilinearRHS
+{
+public:
+    StiffRiccati(bool diagonal_operator) :
+        rates{-1.0, -10.0, -100.0, -1e3, -1e4}
+    {
+        for (size_t i = 0; i < rates.size(); i++)
+        {
+            nodes.emplace_back(new VariableScalar(initial));
+            variable.add_variable(*nodes.back());
+        }
+
+        if (diagonal_operator)
+        {
+            l = LinearOperator::diagonal(rates);
+        } else {
+            std::vector<double> a = rates;
+            l = LinearOperator::matvec(
+                [a](const std::vector<double>& x, std::vector<double>& y)
+                {
+                    y.resize(x.size());
+                    for (size_t i = 0; i < x.size(); i++)
+                        y[i] = a[i] * x[i];
+                },
+                rates.size()
+            );
+        }
+    }
+
+    void calculate_rhs(double time) override
+    {
+        DSITERPP_UNUSED(time);
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            double x = nodes[i]->current_value();
+            nodes[i]->set_rhs(rates[i] * x + x * x);
+        }
+    }
+
+    void calculate_nonlinear(double time) override
+    {
+        DSITERPP_UNUSED(time);
+        for (auto &node : nodes)
+        {
+            double x = node->current_value();
+            node->set_rhs(x * x);
+        }
+    }
+
+    const LinearOperator& linear_operator() override
+    {
+        return l;
+    }
+
+    double exact(size_t i, double t) const
+    {
+        // Bernoulli equation for 1/x is linear
+        const double a = rates[i];
+        return 1.0 / ((1.0 / initial + 1.0 / a) * exp(-a * t) - 1.0 / a);
+    }
+
+    double max_error(double t) const
+    {
+        double error = 0.0;
+        for (size_t i = 0; i < nodes.size(); i++)
+            error = std::max(error, fabs(static_cast<double&>(*nodes[i]) - exact(i, t)));
+        return error;
+    }
+
+    const double initial = 0.5;
+    std::vector<double> rates;
+    LinearOperator l;
+    std::vector<std::unique_ptr<VariableScalar>> nodes;
+    VariablesGroup variable;
+};
+
+double integrate(StiffRiccati& problem, IIntegrator& integrator, double dt, double stop_time = 1.0)
+{
+    return problem.max_error(run_fixed_step(&problem.variable, &problem, &integrator, dt, stop_time));
+}
+
+}
+
+TEST(Exponential, PhiFunctions)
+{
+    ASSERT_NEAR(exp(2.0), phi_function(0, 2.0), 1e-12);
+    ASSERT_NEAR((exp(-3.0) - 1.0) / -3.0, phi_function(1, -3.0), 1e-14);
+    ASSERT_NEAR((exp(-3.0) - 1.0 + 3.0) / 9.0, phi_function(2, -3.0), 1e-14);
+    // Series branch is continuous with recurrence branch
+    ASSERT_NEAR(phi_function(3, 0.999999), phi_function(3, 1.000001), 1e-6);
+    ASSERT_NEAR(1.0 / 6.0, phi_function(3, 0.0), 1e-15);
+
+    DenseMatrix a(2);
+    a(0, 0) = 0.0; a(0, 1) = 1.0;
+    a(1, 0) = -1.0; a(1, 1) = 0.0;
+    DenseMatrix rotation;
+    matrix_exponential(a, rotation);
+    ASSERT_NEAR(cos(1.0), rotation(0, 0), 1e-13);
+    ASSERT_NEAR(sin(1.0), rotation(0, 1), 1e-13);
+    ASSERT_NEAR(-sin(1.0), rotation(1, 0), 1e-13);
+}
+
+TEST(Exponential, KrylovMatchesDiagonal)
+{
+    StiffRiccati diagonal(true);
+    StiffRiccati matvec(false);
+    std::vector<std::vector<double>> v(3, std::vector<double>(5));
+    for (size_t i = 0; i < 5; i++)
+    {
+        v[0][i] = 1.0 + i;
+        v[1][i] = sin(i);
+        v[2][i] = cos(i);
+    }
+
+    PhiCombination phi;
+    std::vector<double> u_diagonal, u_krylov;
+    phi.calculate(diagonal.linear_operator(), 0.1, v, u_diagonal);
+    phi.calculate(matvec.linear_operator(), 0.1, v, u_krylov);
+    ASSERT_GT(phi.matvec_count(), 0u);
+    for (size_t i = 0; i < 5; i++)
+        ASSERT_NEAR(u_diagonal[i], u_krylov[i], 1e-9 * (1.0 + fabs(u_diagonal[i])));
+}
+
+TEST(Exponential, ETDRK4Order)
+{
+    // Explicit methods are unstable here with step above 2e-4
+    ETDRK4Iterator etdrk4;
+    StiffRiccati coarse(true);
+    double coarse_error = integrate(coarse, etdrk4, 0.05);
+    StiffRiccati fine(true);
+    double fine_error = integrate(fine, etdrk4, 0.025);
+
+    ASSERT_LT(coarse_error, 1e-5);
+    ASSERT_GT(coarse_error / fine_error, 10.0);
+
+    StiffRiccati krylov(false);
+    ASSERT_NEAR(coarse_error, integrate(krylov, etdrk4, 0.05), 1e-8);
+}
+
+TEST(Exponential, RosenbrockEulerOrder)
+{
+    ExponentialRosenbrockEulerIterator rosenbrock;
+    StiffRiccati coarse(true);
+    double coarse_error = integrate(coarse, rosenbrock, 0.05);
+    StiffRiccati fine(true);
+    double fine_error = integrate(fine, rosenbrock, 0.025);
+
+    ASSERT_LT(coarse_error, 1e-3);
+    ASSERT_NEAR(4.0, coarse_error / fine_error, 0.8);
+}
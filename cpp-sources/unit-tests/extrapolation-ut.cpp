@@ -0,0 +1,87 @@
+#include "exponent-time-iterable.hpp"
+#include "dsiterpp/extrapolation.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/runge-error-estimator.hpp"
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+void setup_tight_tolerance(ExponentProblem& exp_problem, IErrorEstimator* estimator)
+{
+    exp_problem.time_iterator.set_error_estimator(estimator);
+    exp_problem.time_iterator.step_adj_pars().autoStepAdjustment = true;
+    exp_problem.time_iterator.step_adj_pars().max_step_limit = 0.5;
+    exp_problem.time_iterator.step_adj_pars().min_step_limit = 1e-8;
+    exp_problem.time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-10);
+}
+
+}
+
+TEST(GraggBulirschStoer, ExponentDiffEq)
+{
+    GraggBulirschStoerIterator gbs;
+    ExponentProblem exp_problem(&gbs, 1.0);
+    double time_limit = 3.0;
+    exp_problem.iterate(time_limit);
+
+    double ground_thruth = exp(exp_problem.time_iterator.get_time());
+    ASSERT_NEAR(ground_thruth, exp_problem.value(), 1e-10 * ground_thruth);
+}
+
+TEST(GraggBulirschStoer, FewerStepsThanRungeKutta)
+{
+    double time_limit = 3.0;
+    size_t gbs_steps, rk_steps;
+    {
+        GraggBulirschStoerIterator gbs;
+        ExponentProblem exp_problem(&gbs, 1.0);
+        setup_tight_tolerance(exp_problem, &gbs);
+        exp_problem.iterate(time_limit);
+
+        double ground_thruth = exp(exp_problem.time_iterator.get_time());
+        ASSERT_NEAR(ground_thruth, exp_problem.value(), 1e-9 * ground_thruth);
+        gbs_steps = exp_problem.time_iterator.metrics().time_steps_log.size();
+    }
+    {
+        RungeKuttaIterator rk;
+        RungeErrorEstimator estimator;
+        ExponentProblem exp_problem(&rk, 1.0);
+        setup_tight_tolerance(exp_problem, &estimator);
+        exp_problem.iterate(time_limit);
+        rk_steps = exp_problem.time_iterator.metrics().time_steps_log.size();
+    }
+    ASSERT_LT(gbs_steps * 10, rk_steps);
+}
+
+TEST(GraggBulirschStoer, ParallelSequences)
+{
+    double time_limit = 3.0;
+    double sequential_result;
+    {
+        GraggBulirschStoerIterator gbs;
+        ExponentProblem exp_problem(&gbs, 1.0);
+        setup_tight_tolerance(exp_problem, &gbs);
+        exp_problem.iterate(time_limit);
+        sequential_result = exp_problem.value();
+    }
+
+    GraggBulirschStoerIterator gbs;
+    gbs.set_parallel_rhs(
+        [](double t, const std::vector<double>& x, std::vector<double>& f)
+        {
+            DSITERPP_UNUSED(t);
+            f.resize(1);
+            f[0] = x[0];
+        },
+        4
+    );
+    ExponentProblem exp_problem(&gbs, 1.0);
+    setup_tight_tolerance(exp_problem, &gbs);
+    exp_problem.iterate(time_limit);
+
+    ASSERT_EQ(sequential_result, exp_problem.value());
+}
@@ -0,0 +1,118 @@
+#include "exponent-time-iterable.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/bifurcation.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+class HalvingBifurcator : public IBifurcator
+{
+public:
+    HalvingBifurcator(VariableScalar& variable) : m_variable(variable) {}
+
+    void do_bifurcation(double time, double dt) override
+    {
+        DSITERPP_UNUSED(time); DSITERPP_UNUSED(dt);
+        m_variable = m_variable * 0.5;
+        calls++;
+    }
+
+    size_t calls = 0;
+
+private:
+    VariableScalar& m_variable;
+};
+
+struct ProblemWithHookAndBifurcator
+{
+    ProblemWithHookAndBifurcator() :
+        problem(&rk), bifurcator(problem.variable),
+        hook([this](double real_time, double) { hook_times.push_back(real_time); })
+    {
+        hook.set_period(0.1);
+        problem.time_iterator.add_hook(&hook);
+        problem.time_iterator.set_bifurcator(&bifurcator);
+        problem.time_iterator.set_bifurcation_run_period(0.25);
+        problem.time_iterator.set_step(0.001);
+    }
+
+    RungeKuttaIterator rk;
+    ExponentProblem problem;
+    HalvingBifurcator bifurcator;
+    std::vector<double> hook_times;
+    TimeHookPeriodicFunc hook;
+};
+
+}
+
+TEST(FastPath, SameResultAsIterate)
+{
+    ProblemWithHookAndBifurcator reference;
+    reference.problem.time_iterator.set_stop_time(1.0);
+    reference.problem.time_iterator.run();
+
+    ProblemWithHookAndBifurcator fast;
+    fast.problem.time_iterator.advance_to<FixedStepPolicy<RungeKuttaIterator, false>>(1.0);
+
+    ASSERT_EQ(reference.problem.time_iterator.get_time(), fast.problem.time_iterator.get_time());
+    ASSERT_EQ(reference.problem.value(), fast.problem.value());
+    ASSERT_EQ(reference.bifurcator.calls, fast.bifurcator.calls);
+    ASSERT_EQ(reference.hook_times, fast.hook_times);
+    ASSERT_GT(fast.hook_times.size(), 5u);
+    ASSERT_LT(fast.problem.time_iterator.metrics().time_steps_log.size(), 20u);
+}
+
+TEST(FastPath, AdvanceN)
+{
+    RungeKuttaIterator rk;
+    ExponentProblem problem(&rk);
+    problem.time_iterator.set_step(0.001);
+    ASSERT_EQ(500u, problem.time_iterator.advance_n(500));
+    ASSERT_EQ(500u, problem.time_iterator.metrics().time_steps_log.size());
+    ASSERT_EQ(500u, problem.time_iterator.advance_n<FixedStepPolicy<RungeKuttaIterator>>(500));
+    ASSERT_NEAR(1.0, problem.time_iterator.get_time(), 1e-9);
+    ASSERT_NEAR(exp(problem.time_iterator.get_time()), problem.value(), 1e-9);
+}
+
+TEST(FastPath, WrongIntegratorType)
+{
+    RungeKuttaIterator rk;
+    ExponentProblem problem(&rk);
+    struct OtherIntegrator : public IIntegrator
+    {
+        void calculate_delta(IVariable*, IRHS*, double, double) const override {}
+        int method_order() const override { return 1; }
+    };
+    ASSERT_THROW(problem.time_iterator.advance_n<FixedStepPolicy<OtherIntegrator>>(1), std::logic_error);
+}
+
+TEST(FastPath, BifurcationTimeRounding)
+{
+    // After 7 steps t = 1.9999999999999998, so t - 0.6 >= 1.4 but t < 0.6 + 1.4
+    auto run = [](bool fast, size_t& calls) {
+        RungeKuttaIterator rk;
+        ExponentProblem problem(&rk);
+        HalvingBifurcator bifurcator(problem.variable);
+        problem.time_iterator.set_bifurcator(&bifurcator);
+        problem.time_iterator.set_time(0.6);
+        problem.time_iterator.set_bifurcation_run_period(1.4);
+        problem.time_iterator.set_step(0.2);
+        problem.time_iterator.set_stop_time(2.1);
+        if (fast)
+            problem.time_iterator.advance_to(2.1);
+        else
+            problem.time_iterator.run();
+        calls = bifurcator.calls;
+        return problem.value();
+    };
+
+    size_t reference_calls = 0, fast_calls = 0;
+    double reference = run(false, reference_calls);
+    double fast = run(true, fast_calls);
+    ASSERT_EQ(1u, reference_calls);
+    ASSERT_EQ(reference_calls, fast_calls);
+    ASSERT_EQ(reference, fast);
+}
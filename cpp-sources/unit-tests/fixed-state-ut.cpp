@@ -0,0 +1,50 @@
+#include "dsiterpp/runge-kutta-t.hpp"
+#include "dsiterpp/time-iter-t.hpp"
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+TEST(FixedState, HarmonicOscillator)
+{
+    using State = FixedState<2>;
+    double time_limit = 2.0;
+    auto time_iterator = make_time_iterator_t<RK4T<State>>(
+        State{{1.0, 0.0}},
+        [](double t, const State& x, State& dxdt)
+        {
+            DSITERPP_UNUSED(t);
+            dxdt[0] = x[1];
+            dxdt[1] = -x[0];
+        }
+    );
+    time_iterator.set_step(0.001);
+    time_iterator.set_stop_time(time_limit);
+    time_iterator.run();
+
+    ASSERT_NEAR(cos(time_iterator.get_time()), time_iterator.state()[0], 1e-9);
+    ASSERT_NEAR(-sin(time_iterator.get_time()), time_iterator.state()[1], 1e-9);
+}
+
+TEST(FixedState, AutoStepAdjEulerBased)
+{
+    using State = FixedState<1>;
+    double time_limit = 3.0;
+    double allowed_result_relative_error = 0.01;
+
+    auto time_iterator = make_time_iterator_t<EulerExplicitT<State>>(
+        State{{1.0}},
+        [](double t, const State& x, State& dxdt) { DSITERPP_UNUSED(t); dxdt[0] = x[0]; }
+    );
+    time_iterator.set_step(0.0001);
+    time_iterator.set_stop_time(time_limit);
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(allowed_result_relative_error / time_limit);
+    ASSERT_TRUE(time_iterator.step_adj_pars().is_self_consistent());
+
+    time_iterator.run();
+
+    double ground_thruth = exp(time_iterator.get_time());
+    ASSERT_NEAR(ground_thruth, time_iterator.state()[0], allowed_result_relative_error * ground_thruth);
+}
@@ -0,0 +1,149 @@
+#include "dsiterpp/incremental-rhs.hpp"
+#include "dsiterpp/partitioned-variable.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/time-iter.hpp"
+#include "test-utils.hpp"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/**
+ * Few active units x' = -x drive followers x_f' = x_a - x_f, other units are at rest
+ * in their equilibrium x' = -(x - 1) and never change
+ */
+class Network
+{
+public:
+    static constexpr size_t active = 3;
+    static constexpr size_t followers = 3;
+    static constexpr size_t resting = 100;
+
+    Network() :
+        units(active + followers + resting, VariableScalar(1.0))
+    {
+        for (auto& unit : units)
+            variable.add_variable(unit);
+
+        for (size_t i = 0; i < units.size(); i++)
+        {
+            VariableScalar& x = units[i];
+            std::vector<VariableScalar*> inputs{&x};
+            std::function<void(double)> rhs;
+            if (i < active)
+            {
+                rhs = [&x](double) { x.set_rhs(-x.current_value()); };
+            } else if (i < active + followers) {
+                VariableScalar& driver = units[i - active];
+                inputs.push_back(&driver);
+                rhs = [&x, &driver](double) { x.set_rhs(driver.current_value() - x.current_value()); };
+            } else {
+                rhs = [&x](double) { x.set_rhs(-(x.current_value() - 1.0)); };
+            }
+            members.emplace_back(new FunctionRHS(rhs));
+            group.add_rhs(members.back().get());
+            incremental.add_rhs(members.back().get(), inputs);
+        }
+    }
+
+    void run(IRHS* rhs, double stop_time = 1.0)
+    {
+        RungeKuttaIterator rk;
+        run_fixed_step(&variable, rhs, &rk, 0.01, stop_time);
+    }
+
+    std::vector<VariableScalar> units;
+    std::vector<std::unique_ptr<FunctionRHS>> members;
+    VariablesGroup variable;
+    RHSGroup group;
+    IncrementalRHSGroup incremental;
+};
+
+}
+
+TEST(IncrementalRHSGroup, SameResultAsFullEvaluation)
+{
+    Network full, lazy;
+    full.run(&full.group);
+    lazy.run(&lazy.incremental);
+
+    for (size_t i = 0; i < full.units.size(); i++)
+        ASSERT_EQ(double(full.units[i]), double(lazy.units[i]));
+    ASSERT_NEAR(exp(-1.0), double(lazy.units[0]), 1e-9);
+
+    // Resting units are evaluated only once
+    for (size_t i = Network::active + Network::followers; i < lazy.units.size(); i++)
+        ASSERT_EQ(1u, lazy.members[i]->evaluations);
+    ASSERT_EQ(full.members[0]->evaluations, lazy.members[0]->evaluations);
+    ASSERT_GT(lazy.incremental.skipped_count(), 10 * lazy.incremental.evaluations_count());
+
+    // Only blocks changed by active units and followers are visited
+    size_t calls = (lazy.incremental.evaluations_count() + lazy.incremental.skipped_count()) / lazy.units.size();
+    ASSERT_LE(lazy.incremental.visited_blocks_count(), (Network::active + Network::followers) * calls);
+}
+
+TEST(IncrementalRHSGroup, TimeDependentMember)
+{
+    VariableScalar x(0.0);
+    FunctionRHS forcing([&x](double time) { x.set_rhs(cos(time)); });
+    IncrementalRHSGroup group;
+    group.add_rhs(&forcing, {}, true);
+
+    RungeKuttaIterator rk;
+    double t = run_fixed_step(&x, &group, &rk, 0.01, 1.0);
+    ASSERT_NEAR(sin(t), x, 1e-9);
+}
+
+TEST(IncrementalRHSGroup, ThresholdSkipsSmallChanges)
+{
+    Network exact, latency;
+    latency.incremental.set_change_threshold(1e-3);
+    exact.run(&exact.incremental);
+    latency.run(&latency.incremental);
+
+    ASSERT_LT(latency.incremental.evaluations_count(), exact.incremental.evaluations_count());
+    for (size_t i = 0; i < exact.units.size(); i++)
+        ASSERT_NEAR(double(exact.units[i]), double(latency.units[i]), 1e-2);
+
+    // After invalidate() every member is evaluated again
+    size_t evaluations = latency.members.back()->evaluations;
+    latency.incremental.invalidate();
+    latency.incremental.calculate_rhs(1.0);
+    ASSERT_EQ(evaluations + 1, latency.members.back()->evaluations);
+}
+
+TEST(IncrementalRHSGroup, PartitionBlocks)
+{
+    // Partition 0 decays x' = -x, others rest in equilibrium x' = -(x - 1)
+    PinnedThreadPool pool(4);
+    PartitionedVariable variable(256, pool);
+    for (size_t i = 0; i < variable.size(); i++)
+        variable.value(i) = 1.0;
+
+    std::vector<std::unique_ptr<FunctionRHS>> members;
+    IncrementalRHSGroup group;
+    for (size_t index = 0; index < variable.partitions_count(); index++)
+    {
+        const PartitionedVariable::Partition& p = variable.partition(index);
+        const double equilibrium = index == 0 ? 0.0 : 1.0;
+        members.emplace_back(new FunctionRHS([&p, equilibrium](double) {
+            for (size_t i = 0; i < p.size; i++)
+                p.rhs[i] = -(p.current[i] - equilibrium);
+        }));
+        group.add_rhs(members.back().get(), variable, {index});
+    }
+
+    RungeKuttaIterator rk;
+    double t = run_fixed_step(&variable, &group, &rk, 0.01, 1.0);
+    ASSERT_NEAR(exp(-t), variable.value(0), 1e-9);
+    ASSERT_EQ(1.0, variable.value(variable.size() - 1));
+    for (size_t index = 1; index < members.size(); index++)
+        ASSERT_EQ(1u, members[index]->evaluations);
+    ASSERT_GT(members[0]->evaluations, 100u);
+}
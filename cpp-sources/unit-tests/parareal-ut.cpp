@@ -0,0 +1,76 @@
+#include "dsiterpp/parareal.hpp"
+#include "dsiterpp/runge-kutta-t.hpp"
+#include <vector>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+using State = std::vector<double>;
+
+/// Damped forced oscillator
+void oscillator(double t, const State& x, State& dxdt)
+{
+    dxdt[0] = x[1];
+    dxdt[1] = -x[0] - 0.1 * x[1] + sin(2.0 * t);
+}
+
+State sequential_fine(const std::vector<double>& times, const State& x0, double fine_step)
+{
+    RK4T<State> rk4;
+    State x = x0, delta;
+    auto rhs = oscillator;
+    for (size_t n = 0; n + 1 < times.size(); n++)
+    {
+        const size_t steps = static_cast<size_t>(ceil((times[n + 1] - times[n]) / fine_step - 1e-9));
+        const double h = (times[n + 1] - times[n]) / steps;
+        for (size_t s = 0; s < steps; s++)
+        {
+            rk4.calculate_delta(rhs, times[n] + s * h, x, h, delta);
+            for (size_t i = 0; i < x.size(); i++)
+                x[i] += delta[i];
+        }
+    }
+    return x;
+}
+
+}
+
+TEST(Parareal, ConvergesToFineSolution)
+{
+    ThreadPool pool(4);
+    auto parareal = make_parareal_t<EulerExplicitT<State>, RK4T<State>, State>(oscillator, pool);
+    parareal.set_slices_count(16);
+    parareal.set_coarse_step(0.1);
+    parareal.set_fine_step(0.001);
+    parareal.set_tolerance(1e-10);
+
+    const State x0 = {1.0, 0.0};
+    ASSERT_TRUE(parareal.solve(0.0, 20.0, x0));
+    ASSERT_LT(parareal.iterations(), 16u);
+
+    State reference = sequential_fine(parareal.slice_times(), x0, 0.001);
+    ASSERT_NEAR(reference[0], parareal.solution()[0], 1e-8);
+    ASSERT_NEAR(reference[1], parareal.solution()[1], 1e-8);
+}
+
+TEST(Parareal, ExactAfterSlicesCountIterations)
+{
+    ThreadPool pool(3);
+    auto parareal = make_parareal_t<EulerExplicitT<State>, RK4T<State>, State>(oscillator, pool);
+    parareal.set_slices_count(5);
+    parareal.set_coarse_step(1.0);
+    parareal.set_fine_step(0.01);
+    parareal.set_tolerance(0.0);
+
+    const State x0 = {0.0, 1.0};
+    ASSERT_TRUE(parareal.solve(0.0, 10.0, x0));
+    ASSERT_EQ(5u, parareal.iterations());
+
+    State reference = sequential_fine(parareal.slice_times(), x0, 0.01);
+    ASSERT_NEAR(reference[0], parareal.solution()[0], 1e-12);
+    ASSERT_NEAR(reference[1], parareal.solution()[1], 1e-12);
+}
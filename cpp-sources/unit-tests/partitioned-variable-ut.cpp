@@ -0,0 +1,123 @@
+#include "dsiterpp/partitioned-variable.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/runge-error-estimator.hpp"
+#include "dsiterpp/time-iter.hpp"
+#include "test-utils.hpp"
+#include <thread>
+#include <vector>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+// x_i' = -k_i * x_i + (x_{i-1} - x_i), coupling reads neighbour from other partition
+struct DecayChain
+{
+    DecayChain(size_t size, PinnedThreadPool& pool) :
+        variable(size, pool),
+        rhs(variable, [this](double time, const PartitionedVariable::Partition& p) {
+            DSITERPP_UNUSED(time);
+            for (size_t i = 0; i < p.size; i++)
+            {
+                size_t global = p.begin + i;
+                double left = global == 0 ? 0.0 : variable.current_value(global - 1);
+                p.rhs[i] = - rate(global) * p.current[i] + coupling * (left - p.current[i]);
+            }
+        })
+    {
+        for (size_t i = 0; i < size; i++)
+            variable.value(i) = 1.0 + 0.001 * i;
+    }
+
+    static double rate(size_t i) { return 1.0 + 0.01 * (i % 7); }
+
+    double coupling = 0.0;
+    PartitionedVariable variable;
+    PartitionedRHS rhs;
+};
+
+}
+
+TEST(PinnedThreadPool, TaskIndexRunsOnSameWorker)
+{
+    PinnedThreadPool pool(3);
+    ASSERT_EQ(3u, pool.threads_count());
+
+    std::vector<std::thread::id> first(3), second(3);
+    pool.run_on_each([&first](size_t index) { first[index] = std::this_thread::get_id(); });
+    pool.run_on_each([&second](size_t index) { second[index] = std::this_thread::get_id(); });
+    ASSERT_EQ(first, second);
+    ASSERT_NE(first[0], first[1]);
+    ASSERT_NE(first[0], std::this_thread::get_id());
+
+    ASSERT_THROW(pool.run_on_each([](size_t index) { if (index == 1) throw std::runtime_error("test"); }), std::runtime_error);
+}
+
+TEST(PartitionedVariable, PartitionsCoverState)
+{
+    PinnedThreadPool pool(4);
+    PartitionedVariable variable(1001, pool);
+    ASSERT_EQ(4u, variable.partitions_count());
+
+    size_t covered = 0;
+    for (size_t i = 0; i < variable.partitions_count(); i++)
+    {
+        const PartitionedVariable::Partition& p = variable.partition(i);
+        ASSERT_EQ(covered, p.begin);
+        covered += p.size;
+    }
+    ASSERT_EQ(1001u, covered);
+
+    for (size_t i = 0; i < variable.size(); i++)
+        variable.value(i) = i;
+    variable.clear_subiteration();
+
+    std::vector<double> values{-1.0};
+    variable.collect_values(values);
+    ASSERT_EQ(1002u, values.size());
+    for (size_t i = 0; i < variable.size(); i++)
+        ASSERT_EQ(double(i), values[i + 1]);
+}
+
+TEST(PartitionedVariable, IntegratesDecayChain)
+{
+    PinnedThreadPool pool(4);
+    DecayChain chain(1000, pool);
+
+    RungeKuttaIterator rk;
+    const double t = run_fixed_step(&chain.variable, &chain.rhs, &rk, 0.001, 1.0);
+    for (size_t i = 0; i < chain.variable.size(); i += 37)
+        ASSERT_NEAR((1.0 + 0.001 * i) * exp(- DecayChain::rate(i) * t), chain.variable.value(i), 1e-9);
+}
+
+TEST(PartitionedVariable, ErrorEstimatorSameAsRunge)
+{
+    PinnedThreadPool pool(3);
+    DecayChain partitioned_chain(500, pool);
+    DecayChain reference_chain(500, pool);
+    partitioned_chain.coupling = reference_chain.coupling = 0.5;
+
+    RungeKuttaIterator rk;
+    PartitionedRungeErrorEstimator partitioned_estimator;
+    RungeErrorEstimator reference_estimator;
+    partitioned_estimator.set_integrator(&rk);
+    reference_estimator.set_integrator(&rk);
+
+    partitioned_estimator.calculate_delta_and_estimate(&partitioned_chain.variable, &partitioned_chain.rhs, 0.0, 0.1);
+    reference_estimator.calculate_delta_and_estimate(&reference_chain.variable, &reference_chain.rhs, 0.0, 0.1);
+
+    ASSERT_GT(partitioned_estimator.get_error().max_abs_error, 0.0);
+    ASSERT_DOUBLE_EQ(reference_estimator.get_error().max_abs_error, partitioned_estimator.get_error().max_abs_error);
+    ASSERT_DOUBLE_EQ(reference_estimator.get_error().max_rel_error, partitioned_estimator.get_error().max_rel_error);
+
+    std::vector<double> partitioned_deltas, reference_deltas;
+    partitioned_chain.variable.collect_deltas(partitioned_deltas);
+    reference_chain.variable.collect_deltas(reference_deltas);
+    ASSERT_EQ(reference_deltas, partitioned_deltas);
+
+    VariableScalar scalar;
+    ASSERT_THROW(partitioned_estimator.calculate_delta_and_estimate(&scalar, &partitioned_chain.rhs, 0.0, 0.1), std::invalid_argument);
+}
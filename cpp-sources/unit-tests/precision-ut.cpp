@@ -0,0 +1,167 @@
+#include "dsiterpp/runge-kutta-t.hpp"
+#include "dsiterpp/time-iter-t.hpp"
+#include "dsiterpp/double-double.hpp"
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+template<typename State>
+struct Rotation
+{
+    void operator()(double t, const State& x, State& dxdt) const
+    {
+        DSITERPP_UNUSED(t);
+        dxdt[0] = -x[1];
+        dxdt[1] = x[0];
+    }
+};
+
+template<typename Integrator, typename State>
+double rotation_error(const State& x0, double dt, size_t steps, bool compensated = false)
+{
+    auto time_iterator = make_time_iterator_t<Integrator>(x0, Rotation<State>());
+    time_iterator.set_compensated_summation(compensated);
+    time_iterator.set_step(dt);
+    time_iterator.set_stop_time(dt * steps);
+    time_iterator.run();
+    const double t = time_iterator.get_time();
+    return std::max(
+        std::fabs(static_cast<double>(time_iterator.state()[0]) - cos(t)),
+        std::fabs(static_cast<double>(time_iterator.state()[1]) - sin(t))
+    );
+}
+
+template<typename Scalar>
+Scalar add_small_deltas(Scalar x0)
+{
+    using State = std::vector<Scalar>;
+    auto time_iterator = make_time_iterator_t<EulerExplicitT<State>>(
+        State{x0},
+        [](double t, const State& x, State& dxdt) { DSITERPP_UNUSED(t); DSITERPP_UNUSED(x); dxdt[0] = 1e-17; }
+    );
+    time_iterator.set_step(1.0);
+    time_iterator.set_stop_time(1000.0);
+    time_iterator.run();
+    return time_iterator.state()[0];
+}
+
+}
+
+TEST(Precision, FloatState)
+{
+    using State = std::vector<float>;
+    double error = rotation_error<RK4T<State>>(State{1.0f, 0.0f}, 0.01, 100);
+    ASSERT_LT(error, 1e-5);
+}
+
+TEST(Precision, FloatStateWithDoubleAccumulator)
+{
+    // Rounding of state updates is compensated, so on long run error is dominated by
+    // rounding of stage sums, which are float or double depending on accumulator
+    using State = FixedState<2, float>;
+    double float_error = rotation_error<RK4T<State>>(State{{1.0f, 0.0f}}, 0.01, 10000, true);
+    double double_accumulator_error = rotation_error<RK4T<State, double>>(State{{1.0f, 0.0f}}, 0.01, 10000, true);
+    ASSERT_LT(double_accumulator_error, 1e-7);
+    ASSERT_LT(double_accumulator_error * 20, float_error);
+}
+
+TEST(Precision, LongDoubleState)
+{
+    using State = std::vector<long double>;
+    double error = rotation_error<RK4T<State>>(State{1.0L, 0.0L}, 0.01, 100);
+    ASSERT_LT(error, 1e-9);
+}
+
+TEST(Precision, DoubleDoubleArithmetic)
+{
+    DoubleDouble x = DoubleDouble(1.0) + 1e-20;
+    ASSERT_EQ(x.hi, 1.0);
+    ASSERT_EQ(x.lo, 1e-20);
+    ASSERT_EQ(static_cast<double>(x - 1.0), 1e-20);
+
+    DoubleDouble third = DoubleDouble(1.0) / 3.0;
+    DoubleDouble one = third * 3.0;
+    ASSERT_LT(std::fabs(static_cast<double>(one - 1.0)), 1e-30);
+
+    ASSERT_TRUE(DoubleDouble(1.0) < x);
+    ASSERT_EQ(fabs(-x), x);
+}
+
+TEST(Precision, DoubleDoubleKeepsSmallDeltas)
+{
+    // Each step adds delta below half ulp of 1.0, so double state does not change at all
+    ASSERT_EQ(add_small_deltas(1.0), 1.0);
+
+    DoubleDouble result = add_small_deltas(DoubleDouble(1.0));
+    ASSERT_NEAR(static_cast<double>(result - 1.0), 1e-14, 1e-26);
+}
+
+TEST(Precision, DoubleDoubleAdaptiveStep)
+{
+    using State = std::vector<DoubleDouble>;
+    auto time_iterator = make_time_iterator_t<RK4T<State>>(State{1.0, 0.0}, Rotation<State>());
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().max_step_limit = 0.1;
+    time_iterator.step_adj_pars().min_step_limit = 1e-6;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-8);
+    time_iterator.set_step(0.01);
+    time_iterator.set_stop_time(1.0);
+    time_iterator.run();
+
+    const double t = time_iterator.get_time();
+    ASSERT_NEAR(static_cast<double>(time_iterator.state()[0]), cos(t), 1e-6);
+}
+
+namespace {
+
+template<typename State>
+State sum_small_steps(const State& x0, bool compensated, size_t steps, double dt, double& time)
+{
+    auto time_iterator = make_time_iterator_t<EulerExplicitT<State>>(
+        x0,
+        [](double t, const State& x, State& dxdt) { DSITERPP_UNUSED(t); DSITERPP_UNUSED(x); dxdt[0] = 1.0; dxdt[1] = -1.0; }
+    );
+    time_iterator.set_compensated_summation(compensated);
+    time_iterator.set_step(dt);
+    for (size_t i = 0; i < steps; i++)
+        time_iterator.iterate();
+    time = time_iterator.get_time();
+    return time_iterator.state();
+}
+
+}
+
+TEST(CompensatedSummation, NoDriftOnSmallSteps)
+{
+    using State = std::vector<double>;
+    const size_t steps = 1000000;
+    const double dt = 1e-7;
+    const double exact = steps * dt;
+
+    double naive_time = 0.0, compensated_time = 0.0;
+    State naive = sum_small_steps(State{1.0, 1.0}, false, steps, dt, naive_time);
+    State compensated = sum_small_steps(State{1.0, 1.0}, true, steps, dt, compensated_time);
+
+    ASSERT_GT(std::fabs(naive[0] - (1.0 + exact)), 1e-12);
+    ASSERT_LT(std::fabs(compensated[0] - (1.0 + exact)), 1e-15);
+    ASSERT_LT(std::fabs(compensated[1] - (1.0 - exact)), 1e-15);
+
+    ASSERT_GT(std::fabs(naive_time - exact), 1e-14);
+    ASSERT_LT(std::fabs(compensated_time - exact), 1e-16);
+}
+
+TEST(CompensatedSummation, FixedFloatState)
+{
+    using State = FixedState<2, float>;
+    const size_t steps = 100000;
+    const double dt = 1e-5;
+    double time = 0.0;
+    State compensated = sum_small_steps(State{{1.0f, 1.0f}}, true, steps, dt, time);
+    ASSERT_NEAR(compensated[0], 2.0f, 1e-6f);
+    ASSERT_NEAR(compensated[1], 0.0f, 1e-6f);
+}
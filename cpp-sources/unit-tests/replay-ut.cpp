@@ -0,0 +1,47 @@
+#include "exponent-time-iterable.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/runge-error-estimator.hpp"
+#include "dsiterpp/step-schedule.hpp"
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+TEST(Replay, BitwiseReproducible)
+{
+    double time_limit = 3.0;
+
+    RungeKuttaIterator rk;
+    RungeErrorEstimator estimator;
+    ExponentProblem recorded_problem(&rk, 1.0);
+    recorded_problem.time_iterator.set_error_estimator(&estimator);
+    recorded_problem.time_iterator.step_adj_pars().autoStepAdjustment = true;
+    recorded_problem.time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-6);
+    recorded_problem.iterate(time_limit);
+
+    StepSchedule recorded = StepSchedule::from_log(recorded_problem.time_iterator.metrics().time_steps_log);
+    ASSERT_EQ(recorded_problem.time_iterator.metrics().time_steps_log.size(), recorded.size());
+    ASSERT_LT(recorded.runs_count(), recorded.size());
+
+    std::stringstream stream;
+    recorded.save(stream);
+    StepSchedule loaded;
+    loaded.load(stream);
+    ASSERT_EQ(recorded.size(), loaded.size());
+
+    ExponentProblem replayed_problem(&rk, 1.0);
+    replayed_problem.time_iterator.set_replay_schedule(&loaded);
+    replayed_problem.iterate(time_limit);
+
+    ASSERT_EQ(recorded_problem.time_iterator.get_time(), replayed_problem.time_iterator.get_time());
+    ASSERT_EQ(recorded_problem.value(), replayed_problem.value());
+    ASSERT_TRUE(loaded.is_finished());
+}
+
+TEST(Replay, InvalidData)
+{
+    std::stringstream stream("not a schedule");
+    StepSchedule schedule;
+    ASSERT_THROW(schedule.load(stream), std::runtime_error);
+}
@@ -0,0 +1,66 @@
+#include "exponent-time-iterable.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/runge-kutta-t.hpp"
+#include "dsiterpp/time-iter-t.hpp"
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+using State = std::vector<double>;
+
+TEST(RungeKuttaT, ExponentDiffEq)
+{
+    double time_limit = 3.0;
+    auto time_iterator = make_time_iterator_t<RK4T<State>>(
+        State{1.0},
+        [](double t, const State& x, State& dxdt) { DSITERPP_UNUSED(t); dxdt[0] = x[0]; }
+    );
+    time_iterator.set_step(0.0001);
+    time_iterator.set_stop_time(time_limit);
+    time_iterator.run();
+
+    ASSERT_NEAR(exp(time_limit), time_iterator.state()[0], 0.01);
+}
+
+TEST(RungeKuttaT, SameResultAsInterfaceBased)
+{
+    double time_limit = 3.0;
+
+    RungeKuttaIterator rk;
+    ExponentProblem exp_problem(&rk, 1.0);
+    exp_problem.iterate(time_limit);
+
+    auto time_iterator = make_time_iterator_t<RK4T<State>>(
+        State{1.0},
+        [](double t, const State& x, State& dxdt) { DSITERPP_UNUSED(t); dxdt[0] = x[0]; }
+    );
+    time_iterator.set_step(0.0001);
+    time_iterator.set_stop_time(time_limit);
+    time_iterator.run();
+
+    ASSERT_NEAR(exp_problem.value(), time_iterator.state()[0], 1e-9 * exp_problem.value());
+}
+
+TEST(RungeKuttaT, HarmonicOscillator)
+{
+    // x'' = -x, x(0) = 1, x'(0) = 0
+    double time_limit = 2.0;
+    auto time_iterator = make_time_iterator_t<RK4T<State>>(
+        State{1.0, 0.0},
+        [](double t, const State& x, State& dxdt)
+        {
+            DSITERPP_UNUSED(t);
+            dxdt[0] = x[1];
+            dxdt[1] = -x[0];
+        }
+    );
+    time_iterator.set_step(0.001);
+    time_iterator.set_stop_time(time_limit);
+    time_iterator.run();
+
+    ASSERT_NEAR(cos(time_iterator.get_time()), time_iterator.state()[0], 1e-9);
+    ASSERT_NEAR(-sin(time_iterator.get_time()), time_iterator.state()[1], 1e-9);
+}
@@ -0,0 +1,175 @@
+#include "dsiterpp/sde.hpp"
+#include "dsiterpp/time-iter.hpp"
+#include "dsiterpp/thread-pool.hpp"
+#include <functional>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+class ScalarSDE : public IStochasticRHS
+{
+public:
+    using Function = std::function<double(double time, double x)>;
+
+    ScalarSDE(VariableScalar& x, Function drift, Function diffusion) :
+        m_x(x), m_drift(drift), m_diffusion(diffusion)
+    { }
+
+    void calculate_rhs(double time) override { m_x.set_rhs(m_drift(time, m_x.current_value())); }
+    void calculate_diffusion(double time) override { m_x.set_rhs(m_diffusion(time, m_x.current_value())); }
+
+private:
+    VariableScalar& m_x;
+    Function m_drift;
+    Function m_diffusion;
+};
+
+double integrate_path(StochasticIntegratorBase& integrator, ScalarSDE::Function drift, ScalarSDE::Function diffusion, double dt, double stop_time)
+{
+    VariableScalar x(1.0);
+    ScalarSDE rhs(x, drift, diffusion);
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&x);
+    time_iterator.set_rhs(&rhs);
+    time_iterator.set_continious_iterator(&integrator);
+    time_iterator.set_step(dt);
+    time_iterator.set_stop_time(stop_time - dt / 2);
+    time_iterator.run();
+    return x;
+}
+
+/// Ornstein-Uhlenbeck process dx = -x dt + 0.5 dW, x(0) = 1
+template<typename Integrator>
+void check_ornstein_uhlenbeck_statistics(double dt)
+{
+    const size_t paths = 4000;
+    std::vector<double> results(paths);
+    ThreadPool pool(4);
+    pool.parallel_for(paths, [&results, dt](size_t path) {
+        Integrator integrator;
+        integrator.set_seed(2024, uint32_t(path));
+        results[path] = integrate_path(
+            integrator,
+            [](double, double x) { return -x; },
+            [](double, double) { return 0.5; },
+            dt, 1.0
+        );
+    });
+
+    double mean = 0.0, variance = 0.0;
+    for (double x : results)
+        mean += x;
+    mean /= paths;
+    for (double x : results)
+        variance += (x - mean) * (x - mean);
+    variance /= paths - 1;
+
+    EXPECT_NEAR(exp(-1.0), mean, 0.02);
+    EXPECT_NEAR(0.125 * (1.0 - exp(-2.0)), variance, 0.01);
+}
+
+}
+
+TEST(CounterRNG, PhiloxKnownAnswers)
+{
+    Philox4x32::Counter zero = Philox4x32::generate(Philox4x32::Counter{{0, 0, 0, 0}}, Philox4x32::Key{{0, 0}});
+    EXPECT_EQ(0x6627e8d5u, zero[0]);
+    EXPECT_EQ(0xe169c58du, zero[1]);
+    EXPECT_EQ(0xbc57ac4cu, zero[2]);
+    EXPECT_EQ(0x9b00dbd8u, zero[3]);
+
+    Philox4x32::Counter ones = Philox4x32::generate(
+        Philox4x32::Counter{{0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}},
+        Philox4x32::Key{{0xffffffffu, 0xffffffffu}}
+    );
+    EXPECT_EQ(0x408f276du, ones[0]);
+    EXPECT_EQ(0x41c83b0eu, ones[1]);
+    EXPECT_EQ(0xa20bc7c6u, ones[2]);
+    EXPECT_EQ(0x6d5451fdu, ones[3]);
+}
+
+TEST(CounterRNG, NormalMoments)
+{
+    NormalGenerator generator(1, 2);
+    std::vector<double> numbers(100003);
+    generator.fill(7, numbers.data(), numbers.size());
+
+    double mean = 0.0, square = 0.0;
+    for (double x : numbers)
+    {
+        mean += x;
+        square += x * x;
+    }
+    mean /= numbers.size();
+    square /= numbers.size();
+    EXPECT_NEAR(0.0, mean, 0.015);
+    EXPECT_NEAR(1.0, square, 0.02);
+
+    // Blocks are independent of how much numbers were taken
+    double first;
+    generator.fill(7, &first, 1);
+    EXPECT_EQ(numbers[0], first);
+}
+
+TEST(SDE, EulerMaruyamaOrnsteinUhlenbeck)
+{
+    check_ornstein_uhlenbeck_statistics<EulerMaruyamaIterator>(0.01);
+}
+
+TEST(SDE, SRA1OrnsteinUhlenbeck)
+{
+    check_ornstein_uhlenbeck_statistics<SRA1Iterator>(0.05);
+}
+
+TEST(SDE, Reproducible)
+{
+    auto drift = [](double, double x) { return -x; };
+    auto diffusion = [](double, double x) { return 0.3 * x; };
+    StochasticRK1Iterator first, second, other_stream;
+    first.set_seed(5, 1);
+    second.set_seed(5, 1);
+    other_stream.set_seed(5, 2);
+    double x1 = integrate_path(first, drift, diffusion, 0.01, 1.0);
+    double x2 = integrate_path(second, drift, diffusion, 0.01, 1.0);
+    double x3 = integrate_path(other_stream, drift, diffusion, 0.01, 1.0);
+    EXPECT_EQ(x1, x2);
+    EXPECT_NE(x1, x3);
+}
+
+TEST(SDE, StrongConvergenceOfStochasticRK)
+{
+    // Geometric Brownian motion dx = mu x dt + sigma x dW has exact solution along Wiener path
+    const double mu = 0.5, sigma = 0.8, dt = 0.01, stop_time = 1.0;
+    const size_t steps = 100, paths = 200;
+    auto drift = [mu](double, double x) { return mu * x; };
+    auto diffusion = [sigma](double, double x) { return sigma * x; };
+
+    double euler_error = 0.0, rk_error = 0.0;
+    for (size_t path = 0; path < paths; path++)
+    {
+        EulerMaruyamaIterator euler;
+        StochasticRK1Iterator rk;
+        euler.set_seed(11, uint32_t(path));
+        rk.set_seed(11, uint32_t(path));
+        double x_euler = integrate_path(euler, drift, diffusion, dt, stop_time);
+        double x_rk = integrate_path(rk, drift, diffusion, dt, stop_time);
+
+        NormalGenerator generator(11, uint32_t(path));
+        double w = 0.0;
+        for (size_t step = 0; step < steps; step++)
+        {
+            double xi;
+            generator.fill(step, &xi, 1);
+            w += sqrt(dt) * xi;
+        }
+        double exact = exp((mu - 0.5 * sigma * sigma) * stop_time + sigma * w);
+        euler_error += fabs(x_euler - exact) / paths;
+        rk_error += fabs(x_rk - exact) / paths;
+    }
+    EXPECT_LT(rk_error, 0.3 * euler_error);
+    EXPECT_LT(rk_error, 0.02);
+}
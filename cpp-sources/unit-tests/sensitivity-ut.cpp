@@ -0,0 +1,161 @@
+#include "dsiterpp/sensitivity.hpp"
+#include "dsiterpp/autodiff.hpp"
+#include "dsiterpp/runge-kutta-t.hpp"
+#include "dsiterpp/time-iter-t.hpp"
+#include "dsiterpp/integration.hpp"
+#include <stdexcept>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+using State = std::vector<double>;
+
+/// x' = -a * x + c, x(0) = 1. Templated for automatic differentiation
+struct RelaxationRHS
+{
+    template<typename T>
+    void operator()(double t, const std::vector<T>& x, const std::vector<T>& p, std::vector<T>& dxdt)
+    {
+        DSITERPP_UNUSED(t);
+        dxdt.resize(1);
+        dxdt[0] = - p[0] * x[0] + p[1];
+    }
+};
+
+/// The same system with RHS that writes components without resizing as TimeIteratorT RHS does
+struct NonResizingRelaxationRHS
+{
+    void operator()(double t, const State& x, const State& p, State& dxdt)
+    {
+        DSITERPP_UNUSED(t);
+        dxdt[0] = - p[0] * x[0] + p[1];
+    }
+};
+
+/// Analytic J_x * s + df/dp_j
+struct RelaxationSensitivity
+{
+    void operator()(RelaxationRHS&, double t, const State& x, const State& p, const State& f, const State& s, size_t j, State& out)
+    {
+        DSITERPP_UNUSED(t); DSITERPP_UNUSED(f);
+        out.resize(1);
+        double df_dp = (j == 0) ? -x[0] : 1.0;
+        out[0] = - p[0] * s[0] + df_dp;
+    }
+};
+
+double solution(double a, double c, double t)
+{
+    return c / a + (1.0 - c / a) * exp(-a * t);
+}
+
+double solution_da(double a, double c, double t)
+{
+    return - c / (a * a) + c / (a * a) * exp(-a * t) - t * (1.0 - c / a) * exp(-a * t);
+}
+
+double solution_dc(double a, double t)
+{
+    return (1.0 - exp(-a * t)) / a;
+}
+
+template<typename SensitivityRHSType>
+void check_sensitivities(SensitivityRHSType sensitivity_rhs, bool control_sensitivities_error)
+{
+    const double a = 2.0, c = 0.5;
+    State z0 = sensitivity_rhs.make_initial_state(State{1.0});
+    auto time_iterator = make_time_iterator_t<RK4T<State>>(z0, sensitivity_rhs);
+    time_iterator.set_step(0.001);
+    time_iterator.set_stop_time(1.0);
+    if (control_sensitivities_error)
+    {
+        time_iterator.step_adj_pars().autoStepAdjustment = true;
+        time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-8);
+    }
+    time_iterator.run();
+
+    double t = time_iterator.get_time();
+    const State& z = time_iterator.state();
+    EXPECT_NEAR(solution(a, c, t), z[0], 1e-8);
+    EXPECT_NEAR(solution_da(a, c, t), sensitivity_rhs.sensitivity(z, 0, 0), 1e-6);
+    EXPECT_NEAR(solution_dc(a, t), sensitivity_rhs.sensitivity(z, 1, 0), 1e-6);
+}
+
+}
+
+TEST(Sensitivity, FiniteDifferences)
+{
+    check_sensitivities(make_sensitivity_rhs(RelaxationRHS(), 1, State{2.0, 0.5}), false);
+}
+
+TEST(Sensitivity, AnalyticDerivative)
+{
+    check_sensitivities(make_sensitivity_rhs(RelaxationRHS(), 1, State{2.0, 0.5}, RelaxationSensitivity()), false);
+}
+
+TEST(Sensitivity, ErrorControlOnlyByState)
+{
+    auto sensitivity_rhs = make_sensitivity_rhs(RelaxationRHS(), 1, State{2.0, 0.5});
+    auto time_iterator = make_time_iterator_t<RK4T<State>>(sensitivity_rhs.make_initial_state(State{1.0}), sensitivity_rhs);
+    time_iterator.error_estimator().set_controlled_size(sensitivity_rhs.state_size());
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-8);
+    time_iterator.set_step(0.001);
+    time_iterator.set_stop_time(1.0);
+    time_iterator.run();
+
+    double t = time_iterator.get_time();
+    EXPECT_NEAR(solution(2.0, 0.5, t), time_iterator.state()[0], 1e-8);
+    EXPECT_NEAR(solution_dc(2.0, t), sensitivity_rhs.sensitivity(time_iterator.state(), 1, 0), 1e-5);
+}
+
+TEST(Sensitivity, ErrorControlWithSensitivities)
+{
+    check_sensitivities(make_sensitivity_rhs(RelaxationRHS(), 1, State{2.0, 0.5}), true);
+}
+
+TEST(Sensitivity, DualNumbers)
+{
+    check_sensitivities(make_sensitivity_rhs(RelaxationRHS(), 1, State{2.0, 0.5}, DualSensitivity<RelaxationRHS>()), false);
+}
+
+TEST(Sensitivity, RHSDoesNotResize)
+{
+    check_sensitivities(make_sensitivity_rhs(NonResizingRelaxationRHS(), 1, State{2.0, 0.5}), false);
+}
+
+TEST(Sensitivity, InterfaceModel)
+{
+    double a = 2.0, c = 0.5;
+    VariableScalar x(1.0);
+    RHSScalar rhs(x, [&a, &c](double, double value) { return - a * value + c; });
+
+    auto sensitivity_rhs = make_sensitivity_rhs(&x, &rhs, {&a, &c});
+    ASSERT_EQ(1u, sensitivity_rhs.state_size());
+    ASSERT_EQ((State{2.0, 0.5}), sensitivity_rhs.parameters());
+    check_sensitivities(sensitivity_rhs, false);
+
+    // Perturbed parameters are restored after evaluations
+    ASSERT_EQ(2.0, a);
+    ASSERT_EQ(0.5, c);
+}
+
+TEST(Sensitivity, InterfaceModelRestoresParametersOnThrow)
+{
+    double a = 2.0;
+    VariableScalar x(1.0);
+    RHSScalar rhs(x, [&a](double, double value) {
+        if (a != 2.0)
+            throw std::domain_error("parameter out of range");
+        return - a * value;
+    });
+
+    InterfaceParametricRHS parametric_rhs(&x, &rhs, {&a});
+    State dxdt;
+    ASSERT_THROW(parametric_rhs(0.0, State{1.0}, State{3.0}, dxdt), std::domain_error);
+    ASSERT_EQ(2.0, a);
+}
@@ -0,0 +1,127 @@
+#include "exponent-time-iterable.hpp"
+#include "dsiterpp/shm-metrics.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/runge-error-estimator.hpp"
+#include <thread>
+#include <atomic>
+#include <string>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+std::string segment_name(const char* test)
+{
+    return std::string("/dsiterpp-ut-") + test + "-" + std::to_string(getpid());
+}
+
+}
+
+TEST(SharedMetrics, PublishedByTimeIterator)
+{
+    RungeKuttaIterator rk4;
+    ExponentProblem problem(&rk4);
+    RHSEvaluationCounter counter(&problem.exp_rhs);
+    SharedMetricsExporter exporter(segment_name("iterator"));
+    exporter.set_rhs_counter(&counter);
+
+    problem.time_iterator.set_rhs(&counter);
+    problem.time_iterator.set_metrics_exporter(&exporter);
+    problem.time_iterator.set_step(0.01);
+    problem.time_iterator.set_stop_time(0.995);
+    problem.time_iterator.run();
+
+    SharedMetricsReader reader(exporter.name());
+    SharedMetricsSnapshot snapshot;
+    ASSERT_TRUE(reader.read(snapshot));
+    ASSERT_EQ(100u, snapshot.steps);
+    ASSERT_EQ(400u, snapshot.rhs_evaluations);
+    ASSERT_DOUBLE_EQ(problem.time_iterator.get_time(), snapshot.time);
+    ASSERT_DOUBLE_EQ(0.01, snapshot.dt);
+    ASSERT_EQ(0u, snapshot.rejected_steps);
+
+    // Fast path publishes too
+    problem.time_iterator.advance_n(10);
+    ASSERT_TRUE(reader.read(snapshot));
+    ASSERT_EQ(110u, snapshot.steps);
+}
+
+TEST(SharedMetrics, PublishedStepIsLastAccepted)
+{
+    RungeKuttaIterator rk4;
+    RungeErrorEstimator estimator;
+    ExponentProblem problem(&rk4);
+    SharedMetricsExporter exporter(segment_name("adaptive"));
+    problem.time_iterator.set_metrics_exporter(&exporter);
+    problem.time_iterator.set_error_estimator(&estimator);
+    problem.time_iterator.step_adj_pars().autoStepAdjustment = true;
+    problem.time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-6);
+    problem.time_iterator.step_adj_pars().max_step_limit = 0.1;
+    problem.time_iterator.set_step(1e-4);
+
+    SharedMetricsReader reader(exporter.name());
+    SharedMetricsSnapshot snapshot;
+    for (size_t i = 0; i < 5; i++)
+    {
+        problem.time_iterator.iterate();
+        ASSERT_TRUE(reader.read(snapshot));
+        ASSERT_EQ(problem.time_iterator.metrics().time_steps_log.back(), snapshot.dt);
+    }
+    // Step was growing, so the next step differs from the published one
+    ASSERT_NE(problem.time_iterator.get_step(), snapshot.dt);
+
+    // Fast path publishes the same quantity
+    problem.time_iterator.step_adj_pars().autoStepAdjustment = false;
+    problem.time_iterator.advance_n(5);
+    ASSERT_TRUE(reader.read(snapshot));
+    ASSERT_EQ(problem.time_iterator.metrics().time_steps_log.back(), snapshot.dt);
+}
+
+TEST(SharedMetrics, ReaderSeesConsistentSnapshots)
+{
+    SharedMetricsExporter exporter(segment_name("seqlock"));
+    SharedMetricsReader reader(exporter.name());
+
+    std::atomic<bool> done(false);
+    size_t inconsistent = 0, reads = 0;
+    std::thread reader_thread([&] {
+        SharedMetricsSnapshot snapshot;
+        while (!done)
+        {
+            if (!reader.read(snapshot))
+                continue;
+            reads++;
+            // Every published snapshot has dt = 2 * time and steps = time
+            if (snapshot.dt != 2.0 * snapshot.time || snapshot.steps != static_cast<uint64_t>(snapshot.time))
+                inconsistent++;
+        }
+    });
+
+    IteratingMetrics metrics;
+    for (size_t i = 1; i <= 1000000; i++)
+        exporter.publish(static_cast<double>(i), 2.0 * i, metrics);
+    done = true;
+    reader_thread.join();
+
+    ASSERT_GT(reads, 0u);
+    ASSERT_EQ(0u, inconsistent);
+}
+
+TEST(SharedMetrics, ExistingSegment)
+{
+    SharedMetricsExporter exporter(segment_name("existing"));
+    ASSERT_THROW(SharedMetricsExporter other(segment_name("existing")), std::runtime_error);
+
+    // Segment of the first exporter is still readable
+    SharedMetricsReader reader(segment_name("existing"));
+    SharedMetricsSnapshot snapshot;
+    ASSERT_TRUE(reader.read(snapshot));
+}
+
+TEST(SharedMetrics, MissingSegment)
+{
+    ASSERT_THROW(SharedMetricsReader reader(segment_name("missing")), std::runtime_error);
+}
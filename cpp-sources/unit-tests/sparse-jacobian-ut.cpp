@@ -0,0 +1,157 @@
+#include "dsiterpp/sparse-jacobian.hpp"
+#include "dsiterpp/time-iter.hpp"
+#include <memory>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/// u' = u_xx - u^3 on (0, 1) with zero boundary values
+class ReactionDiffusion : public IRHS
+{
+public:
+    ReactionDiffusion(size_t size) :
+        h(1.0 / (size + 1))
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            nodes.emplace_back(new VariableScalar(2.0 * sin(M_PI * h * (i + 1))));
+            variable.add_variable(*nodes.back());
+        }
+    }
+
+    void calculate_rhs(double time) override
+    {
+        DSITERPP_UNUSED(time);
+        const size_t n = nodes.size();
+        for (size_t i = 0; i < n; i++)
+        {
+            double u = nodes[i]->current_value();
+            double left = i == 0 ? 0.0 : nodes[i - 1]->current_value();
+            double right = i + 1 == n ? 0.0 : nodes[i + 1]->current_value();
+            nodes[i]->set_rhs((left - 2.0 * u + right) / (h * h) - u * u * u);
+        }
+    }
+
+    std::vector<double> values()
+    {
+        std::vector<double> result;
+        variable.collect_values(result);
+        return result;
+    }
+
+    double h;
+    std::vector<std::unique_ptr<VariableScalar>> nodes;
+    VariablesGroup variable;
+};
+
+std::vector<double> integrate(ReactionDiffusion& problem, BDFIterator& bdf)
+{
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&problem.variable);
+    time_iterator.set_rhs(&problem);
+    time_iterator.set_continious_iterator(&bdf);
+    time_iterator.set_error_estimator(&bdf);
+    time_iterator.step_adj_pars().autoStepAdjustment = true;
+    time_iterator.step_adj_pars().min_step_limit = 1e-9;
+    time_iterator.step_adj_pars().max_step_limit = 0.05;
+    time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-4);
+    time_iterator.set_step(1e-5);
+    time_iterator.set_stop_time(0.3);
+    time_iterator.run();
+    return problem.values();
+}
+
+}
+
+TEST(SparseJacobian, DetectedPatternAndColoring)
+{
+    const size_t n = 50;
+    ReactionDiffusion problem(n);
+    SparseJacobian jacobian;
+    jacobian.set_target(&problem.variable, &problem);
+
+    std::vector<double> x = problem.values();
+    jacobian.detect_pattern(0.0, x);
+    ASSERT_EQ(3 * n - 2, jacobian.pattern().nonzeros_count());
+    ASSERT_EQ(3u, jacobian.colors_count());
+
+    size_t evaluations_before = jacobian.evaluations_count();
+    jacobian.update(0.0, x);
+    ASSERT_EQ(1 + jacobian.colors_count(), jacobian.evaluations_count() - evaluations_before);
+
+    const SparseMatrix& matrix = jacobian.matrix();
+    const double d = 1.0 / (problem.h * problem.h);
+    for (size_t i = 0; i < n; i++)
+    {
+        EXPECT_NEAR(-2.0 * d - 3.0 * x[i] * x[i], matrix.get(i, i), 1e-4 * d);
+        if (i + 1 < n)
+        {
+            EXPECT_NEAR(d, matrix.get(i, i + 1), 1e-4 * d);
+            EXPECT_NEAR(d, matrix.get(i + 1, i), 1e-4 * d);
+        }
+        if (i + 2 < n)
+        {
+            EXPECT_EQ(0.0, matrix.get(i, i + 2));
+        }
+    }
+    // Variable values are restored
+    ASSERT_EQ(x, problem.values());
+}
+
+TEST(SparseJacobian, ILU0IsExactForTridiagonal)
+{
+    const size_t n = 20;
+    std::vector<std::pair<size_t, size_t>> entries;
+    for (size_t i = 0; i < n; i++)
+    {
+        entries.push_back(std::make_pair(i, i));
+        if (i > 0)
+            entries.push_back(std::make_pair(i, i - 1));
+        if (i + 1 < n)
+            entries.push_back(std::make_pair(i, i + 1));
+    }
+    SparseMatrix matrix;
+    matrix.set_pattern(SparsityPattern::from_entries(n, entries));
+    const SparsityPattern& pattern = matrix.pattern();
+    for (size_t row = 0; row < n; row++)
+        for (size_t k = pattern.row_offsets[row]; k < pattern.row_offsets[row + 1]; k++)
+            matrix.values()[k] = pattern.columns[k] == row ? 4.0 + row : -1.0 - 0.1 * pattern.columns[k];
+
+    std::vector<double> x_exact(n), b, x;
+    for (size_t i = 0; i < n; i++)
+        x_exact[i] = sin(i + 1.0);
+    matrix.multiply(x_exact, b);
+
+    ILU0Decomposition ilu;
+    ilu.decompose(matrix);
+    ilu.solve(b, x);
+    for (size_t i = 0; i < n; i++)
+        EXPECT_NEAR(x_exact[i], x[i], 1e-12);
+}
+
+TEST(SparseJacobian, BDFPreconditioner)
+{
+    ReactionDiffusion problem(100), reference_problem(100);
+    BDFIterator bdf, reference_bdf;
+    ILU0Preconditioner preconditioner(&problem.variable, &problem);
+    bdf.set_preconditioner(&preconditioner);
+
+    std::vector<double> result = integrate(problem, bdf);
+    std::vector<double> reference = integrate(reference_problem, reference_bdf);
+
+    double max_value = 0.0, max_difference = 0.0;
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        max_value = std::max(max_value, fabs(reference[i]));
+        max_difference = std::max(max_difference, fabs(result[i] - reference[i]));
+    }
+    EXPECT_LT(max_difference, 1e-3 * max_value);
+
+    EXPECT_LT(bdf.statistics().krylov_iterations, reference_bdf.statistics().krylov_iterations / 3);
+    EXPECT_GT(preconditioner.jacobian_updates_count(), 0u);
+    EXPECT_LT(preconditioner.jacobian_updates_count(), bdf.statistics().steps / 3);
+}
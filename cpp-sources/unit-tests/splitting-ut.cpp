@@ -0,0 +1,81 @@
+#include "dsiterpp/splitting.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/euler-explicit.hpp"
+#include "dsiterpp/phi-functions.hpp"
+#include "test-utils.hpp"
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/// Rotation x' = y, y' = -x plus damping y' = -2 y that does not touch x
+class DampedRotation
+{
+public:
+    DampedRotation() :
+        x(1.0), y(0.0),
+        rotation([this](double) { x.set_rhs(y.current_value()); y.set_rhs(-x.current_value()); }),
+        damping([this](double) { y.set_rhs(-2.0 * y.current_value()); }),
+        whole([this](double) { x.set_rhs(y.current_value()); y.set_rhs(-x.current_value() - 2.0 * y.current_value()); })
+    {
+        variable.add_variable(x);
+        variable.add_variable(y);
+    }
+
+    double error(double t)
+    {
+        DenseMatrix a(2), flow;
+        a(0, 0) = 0.0; a(0, 1) = t;
+        a(1, 0) = -t; a(1, 1) = -2.0 * t;
+        matrix_exponential(a, flow);
+        return std::max(fabs(x - flow(0, 0)), fabs(y - flow(1, 0)));
+    }
+
+    VariableScalar x, y;
+    FunctionRHS rotation, damping, whole;
+    VariablesGroup variable;
+};
+
+double integrate(DampedRotation& problem, IIntegrator& integrator, double dt)
+{
+    return problem.error(run_fixed_step(&problem.variable, &problem.whole, &integrator, dt, 1.0));
+}
+
+double splitting_error(SplittingScheme scheme, double dt, size_t damping_substeps = 1, bool euler_damping = false)
+{
+    DampedRotation problem;
+    RungeKuttaIterator rk4;
+    EulerExplicitIterator euler;
+    SplittingIterator splitting;
+    splitting.set_scheme(scheme);
+    splitting.add_operator(&problem.rotation, &rk4);
+    splitting.add_operator(&problem.damping, euler_damping ? static_cast<IIntegrator*>(&euler) : &rk4, damping_substeps);
+    return integrate(problem, splitting, dt);
+}
+
+}
+
+TEST(Splitting, LieIsFirstOrder)
+{
+    double coarse = splitting_error(SplittingScheme::lie, 0.02);
+    double fine = splitting_error(SplittingScheme::lie, 0.01);
+    ASSERT_NEAR(2.0, coarse / fine, 0.2);
+}
+
+TEST(Splitting, StrangIsSecondOrder)
+{
+    double coarse = splitting_error(SplittingScheme::strang, 0.02);
+    double fine = splitting_error(SplittingScheme::strang, 0.01);
+    ASSERT_NEAR(4.0, coarse / fine, 0.4);
+    ASSERT_LT(coarse, splitting_error(SplittingScheme::lie, 0.02));
+}
+
+TEST(Splitting, SubstepsOfCheapIntegrator)
+{
+    double one_substep = splitting_error(SplittingScheme::strang, 0.02, 1, true);
+    double many_substeps = splitting_error(SplittingScheme::strang, 0.02, 20, true);
+    ASSERT_LT(many_substeps, 0.1 * one_substep);
+}
@@ -0,0 +1,154 @@
+#include "dsiterpp/time-iter.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include "dsiterpp/runge-error-estimator.hpp"
+#include "dsiterpp/sdirk.hpp"
+#include "dsiterpp/stiffness-switching.hpp"
+#include "test-utils.hpp"
+#include <stdexcept>
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+/// Variable that implements only methods needed by explicit integrators
+class OutOfTreeVariable : public IVariable
+{
+public:
+    void clear_subiteration() override { current = previous; delta = 0.0; }
+    void add_rhs_to_delta(double m) override { delta += rhs * m; }
+    void make_sub_iteration(double dt) override { current = previous + rhs * dt; }
+    void step() override { current = previous = previous + delta; delta = 0.0; }
+    void collect_values(std::vector<double>& values) const override { values.push_back(current); }
+    void collect_deltas(std::vector<double>& deltas) const override { deltas.push_back(delta); }
+    void set_values(std::vector<double>::const_iterator& values) override { current = previous = *values++; delta = 0.0; }
+
+    double previous = 1.0, current = 1.0, delta = 0.0, rhs = 0.0;
+};
+
+/// x' = -lambda(t) * (x - cos(t)), stiff when lambda is big
+double relaxation_rate(double t)
+{
+    return (t > 1.0 && t < 2.0) ? 5000.0 : 1.0;
+}
+
+double relaxation_rhs(double t, double x)
+{
+    return - relaxation_rate(t) * (x - cos(t));
+}
+
+/// Solution for t > 2 when fast relaxation during 1 < t < 2 is finished
+double relaxation_solution_after_stiff_phase(double t)
+{
+    double lambda = relaxation_rate(1.5);
+    double x2 = (lambda * lambda * cos(2.0) + lambda * sin(2.0)) / (lambda * lambda + 1);
+    double c = x2 - (cos(2.0) + sin(2.0)) / 2;
+    return (cos(t) + sin(t)) / 2 + c * exp(-(t - 2.0));
+}
+
+/// x' = 0 until t = 1, so J*v is zero there, then the same stiff relaxation
+double constant_then_stiff_rhs(double t, double x)
+{
+    return t < 1.0 ? 0.0 : relaxation_rhs(t, x);
+}
+
+double solve(
+    IIntegrator* integrator, IErrorEstimator* estimator, double dt, double time_limit,
+    IteratingMetrics* metrics = nullptr, double* end_time = nullptr,
+    RHSScalar::RHSFunction rhs_function = relaxation_rhs
+)
+{
+    VariableScalar variable(1.0);
+    RHSScalar rhs(variable, rhs_function);
+    TimeIterator time_iterator;
+    time_iterator.set_variable(&variable);
+    time_iterator.set_rhs(&rhs);
+    time_iterator.set_continious_iterator(integrator);
+    if (estimator)
+    {
+        time_iterator.set_error_estimator(estimator);
+        time_iterator.step_adj_pars().autoStepAdjustment = true;
+        time_iterator.step_adj_pars().max_step_limit = 0.05;
+        time_iterator.step_adj_pars().min_step_limit = 1e-7;
+        time_iterator.step_adj_pars().setup_relative_deconvergence_speed(1e-4);
+    }
+    time_iterator.set_time(0.0);
+    time_iterator.set_step(dt);
+    time_iterator.set_stop_time(time_limit);
+    time_iterator.run();
+    if (metrics)
+        *metrics = time_iterator.metrics();
+    if (end_time)
+        *end_time = time_iterator.get_time();
+    return variable.current_value();
+}
+
+}
+
+TEST(SDIRK2, StiffRelaxation)
+{
+    // Explicit methods are unstable with such step when lambda = 5000
+    SDIRK2Iterator sdirk;
+    double x = solve(&sdirk, nullptr, 0.01, 1.5);
+
+    double lambda = relaxation_rate(1.5);
+    double ground_thruth = (lambda * lambda * cos(1.5) + lambda * sin(1.5)) / (lambda * lambda + 1);
+    ASSERT_NEAR(ground_thruth, x, 1e-4);
+}
+
+TEST(SDIRK2, SetDeltasIsOptionalForVariables)
+{
+    OutOfTreeVariable variable;
+    FunctionRHS rhs([&variable](double) { variable.rhs = -variable.current; });
+
+    RungeKuttaIterator rk4;
+    double t = run_fixed_step(&variable, &rhs, &rk4, 0.01, 0.1);
+    ASSERT_NEAR(exp(-t), variable.current, 1e-9);
+
+    // Default IVariable::set_deltas() reports that implicit integrator needs it
+    SDIRK2Iterator sdirk;
+    ASSERT_THROW(run_fixed_step(&variable, &rhs, &sdirk, 0.01, 0.1), std::logic_error);
+}
+
+TEST(StiffnessSwitching, SwitchesToStiffAndBack)
+{
+    double time_limit = 3.0;
+    RungeKuttaIterator rk;
+    SDIRK2Iterator sdirk;
+    StiffnessSwitchingIterator switching(&rk, &sdirk);
+    switching.parameters().stability_limit = 2.78;
+    RungeErrorEstimator estimator;
+    IteratingMetrics metrics;
+    double end_time = 0.0;
+    double x = solve(&switching, &estimator, 1e-3, time_limit, &metrics, &end_time);
+
+    ASSERT_NEAR(relaxation_solution_after_stiff_phase(end_time), x, 1e-3);
+    ASSERT_GE(metrics.integrator_switches.size(), 2u);
+
+    const IntegratorSwitch& to_stiff = metrics.integrator_switches.front();
+    const IntegratorSwitch& to_non_stiff = metrics.integrator_switches.back();
+    EXPECT_TRUE(to_stiff.to_stiff);
+    EXPECT_GT(to_stiff.time, 1.0);
+    EXPECT_LT(to_stiff.time, 2.0);
+    EXPECT_FALSE(to_non_stiff.to_stiff);
+    EXPECT_GT(to_non_stiff.time, 2.0);
+    EXPECT_FALSE(switching.is_stiff_mode());
+}
+
+TEST(StiffnessSwitching, DetectsStiffnessAfterConstantPhase)
+{
+    RungeKuttaIterator rk;
+    SDIRK2Iterator sdirk;
+    StiffnessSwitchingIterator switching(&rk, &sdirk);
+    switching.parameters().stability_limit = 2.78;
+    RungeErrorEstimator estimator;
+    IteratingMetrics metrics;
+    solve(&switching, &estimator, 1e-3, 1.5, &metrics, nullptr, constant_then_stiff_rhs);
+
+    ASSERT_FALSE(metrics.integrator_switches.empty());
+    EXPECT_TRUE(metrics.integrator_switches.front().to_stiff);
+    EXPECT_GT(metrics.integrator_switches.front().time, 1.0);
+    EXPECT_GT(switching.dominant_eigenvalue(), 1000.0);
+}
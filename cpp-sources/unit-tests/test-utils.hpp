@@ -0,0 +1,45 @@
+#ifndef TEST_UTILS_HPP_INCLUDED
+#define TEST_UTILS_HPP_INCLUDED
+
+#include "dsiterpp/time-iter.hpp"
+#include "dsiterpp/integration.hpp"
+
+#include <functional>
+#include <cstddef>
+
+namespace dsiterpp {
+
+/**
+ * IRHS calling function, counts evaluations
+ */
+class FunctionRHS : public IRHS
+{
+public:
+    FunctionRHS(std::function<void(double)> function) : m_function(function) {}
+    void calculate_rhs(double time) override { m_function(time); evaluations++; }
+
+    size_t evaluations = 0;
+
+private:
+    std::function<void(double)> m_function;
+};
+
+/**
+ * Integrate with fixed step until stop_time
+ * @return Time reached
+ */
+inline double run_fixed_step(IVariable* variable, IRHS* rhs, IIntegrator* integrator, double dt, double stop_time)
+{
+    TimeIterator time_iterator;
+    time_iterator.set_variable(variable);
+    time_iterator.set_rhs(rhs);
+    time_iterator.set_continious_iterator(integrator);
+    time_iterator.set_step(dt);
+    time_iterator.set_stop_time(stop_time);
+    time_iterator.run();
+    return time_iterator.get_time();
+}
+
+}
+
+#endif // TEST_UTILS_HPP_INCLUDED
@@ -0,0 +1,138 @@
+#include "exponent-time-iterable.hpp"
+#include "dsiterpp/trajectory-store.hpp"
+#include "dsiterpp/runge-kutta.hpp"
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+using namespace dsiterpp;
+
+namespace {
+
+std::vector<double> smooth_state(double t)
+{
+    return std::vector<double>{sin(t), cos(3.0 * t), exp(-0.5 * t), 1.0 + t * t};
+}
+
+uint64_t bits_of(double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+}
+
+TEST(TrajectoryStore, LosslessRoundTrip)
+{
+    TrajectoryStore store(4, 100);
+    uint64_t seed = 12345;
+    std::vector<std::vector<double>> written;
+    std::vector<double> times;
+    for (size_t i = 0; i < 1050; i++)
+    {
+        // Smooth components mixed with one noisy and some special values
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        double t = 0.001 * i;
+        std::vector<double> state = smooth_state(t);
+        state[3] = static_cast<double>(seed >> 11) * 1e-10;
+        if (i % 97 == 0)
+            state[1] = 0.0;
+        times.push_back(t);
+        written.push_back(state);
+        store.append(t, state);
+    }
+    store.flush();
+
+    ASSERT_EQ(1050u, store.snapshots_count());
+    ASSERT_EQ(11u, store.chunks_count());
+    ASSERT_LT(store.compressed_bytes(), store.raw_bytes());
+
+    TrajectoryStore::Cursor cursor = store.read_from();
+    double time = 0.0;
+    std::vector<double> state;
+    size_t count = 0;
+    while (cursor.next(time, state))
+    {
+        ASSERT_EQ(bits_of(times[count]), bits_of(time));
+        for (size_t i = 0; i < 4; i++)
+            ASSERT_EQ(bits_of(written[count][i]), bits_of(state[i]));
+        count++;
+    }
+    ASSERT_EQ(1050u, count);
+}
+
+TEST(TrajectoryStore, RandomAccessByTime)
+{
+    TrajectoryStore store(4, 64);
+    for (size_t i = 0; i < 1000; i++)
+        store.append(0.01 * i, smooth_state(0.01 * i));
+    store.flush();
+
+    double time = 0.0;
+    std::vector<double> state;
+    TrajectoryStore::Cursor cursor = store.read_from(6.405);
+    ASSERT_TRUE(cursor.next(time, state));
+    ASSERT_NEAR(6.41, time, 1e-12);
+    ASSERT_EQ(smooth_state(time), state);
+
+    // Reading continues over chunk boundaries until the end
+    size_t count = 1;
+    while (cursor.next(time, state))
+        count++;
+    ASSERT_EQ(1000u - 641u, count);
+
+    ASSERT_FALSE(store.read_from(100.0).next(time, state));
+}
+
+TEST(TrajectoryStore, SmoothTrajectoryShrinksWithReducedMantissa)
+{
+    TrajectoryStore lossless(4);
+    TrajectoryStore reduced(4, 1024, 24);
+    for (size_t i = 0; i < 20000; i++)
+    {
+        double t = 0.001 * i;
+        lossless.append(t, smooth_state(t));
+        reduced.append(t, smooth_state(t));
+    }
+    lossless.flush();
+    reduced.flush();
+
+    double lossless_ratio = double(lossless.raw_bytes()) / lossless.compressed_bytes();
+    double reduced_ratio = double(reduced.raw_bytes()) / reduced.compressed_bytes();
+    ASSERT_GT(lossless_ratio, 1.2);
+    ASSERT_GT(reduced_ratio, 5.0);
+
+    TrajectoryStore::Cursor cursor = reduced.read_from();
+    double time = 0.0;
+    std::vector<double> state;
+    while (cursor.next(time, state))
+    {
+        std::vector<double> exact = smooth_state(time);
+        for (size_t i = 0; i < 4; i++)
+            ASSERT_LE(fabs(state[i] - exact[i]), fabs(exact[i]) * pow(2.0, -24));
+    }
+}
+
+TEST(TrajectoryStore, RecorderHook)
+{
+    RungeKuttaIterator rk;
+    ExponentProblem problem(&rk);
+    TrajectoryStore store(1, 16);
+    TrajectoryRecorderHook recorder(&problem.variable, &store);
+    recorder.set_period(0.01);
+    problem.time_iterator.add_hook(&recorder);
+    problem.iterate(1.0);
+    store.flush();
+
+    ASSERT_GE(store.snapshots_count(), 99u);
+    TrajectoryStore::Cursor cursor = store.read_from(0.5);
+    double time = 0.0;
+    std::vector<double> state;
+    ASSERT_TRUE(cursor.next(time, state));
+    ASSERT_GE(time, 0.5);
+    ASSERT_NEAR(exp(time), state[0], 1e-6);
+}